@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "host/HostSim.h"
+#include "core/Constants.h"
+#include "geo/Geodesy.h"
+#include "simobjects/EmitterFollow.h"
+
+// -----------------------------------------------------------------------------
+// Emitter follow benchmark
+// The cube is spawned next to the aircraft, which then flies scripted cases
+// (parked, taxi, cruise, a 3 deg/s turn, 250 m/s), sending a fresh sample
+// every frame like the sim. Per case it prints the emitter counters (cube
+// updates and frames per second, the frames being what a per-frame follow
+// would send) and the largest distance between the cube and where it should
+// be at the end of a frame. Fails when that distance exceeds the tolerance.
+// Usage: wfp_emitter_bench [seconds] (default 10 per case)
+// -----------------------------------------------------------------------------
+
+struct Case
+{
+    const char* name;
+    double speedMps;
+    double turnDegPerSec;
+};
+
+// Layout of DEFINITION_EMITTER_POSITION
+struct EmitterPosition
+{
+    double latitude;
+    double longitude;
+    double altitude;
+};
+
+static const double kRightMeters = 1.0; // SpawnCubeNearAircraft's offset
+
+static void Fly(AircraftState* aircraft, const Case& c)
+{
+    double dt = HOSTSIM_FRAME_MS / 1000.0;
+    GeoPoint next = Geo_Direct(aircraft->latDeg, aircraft->lonDeg, aircraft->trackTrueDeg, c.speedMps * dt);
+    aircraft->latDeg = next.latDeg;
+    aircraft->lonDeg = next.lonDeg;
+    aircraft->trackTrueDeg = Geo_WrapBearing(aircraft->trackTrueDeg + c.turnDegPerSec * dt);
+    aircraft->headingTrueDeg = aircraft->trackTrueDeg;
+    aircraft->groundSpeedMps = c.speedMps;
+    HostSim_SetAircraft(*aircraft);
+    HostSim_Frame();
+}
+
+// Meters between the cube (last emitter move) and its place next to the aircraft
+static double CubeError(const AircraftState& aircraft)
+{
+    DWORD defineId;
+    DWORD objectId;
+    EmitterPosition cube;
+    if (!HostSim_LastSetData(&defineId, &objectId, &cube, sizeof(cube)) || defineId != DEFINITION_EMITTER_POSITION)
+        return 0.0;
+
+    double heading = aircraft.headingTrueDeg * GEO_DEG_TO_RAD;
+    GeoEnu right = { std::cos(heading) * kRightMeters, -std::sin(heading) * kRightMeters, 0.0 };
+    GeoPosition origin = { aircraft.latDeg, aircraft.lonDeg, aircraft.altMeters };
+    GeoPosition target = Geo_EnuToGeodetic(origin, right);
+    GeoPosition placed = { cube.latitude, cube.longitude, cube.altitude };
+    GeoEnu d = Geo_GeodeticToEnu(target, placed);
+    return std::sqrt(d.east * d.east + d.north * d.north + d.up * d.up);
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+    unsigned frames = (unsigned)(seconds * 1000.0 / HOSTSIM_FRAME_MS);
+    double tolerance = EMITTER_FOLLOW_TOLERANCE_METERS;
+
+    const Case kCases[] = {
+        { "parked", 0.0, 0.0 },
+        { "taxi 10 m/s", 10.0, 0.0 },
+        { "cruise 60 m/s", 60.0, 0.0 },
+        { "turn 3 deg/s", 60.0, 3.0 },
+        { "fast 250 m/s", 250.0, 0.0 },
+    };
+
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    AircraftState aircraft = {};
+    aircraft.latDeg = 47.0;
+    aircraft.lonDeg = 8.0;
+    aircraft.altMeters = 1000.0;
+    aircraft.altAboveGroundMeters = 600.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+    HostSim_SetLVar("L:WFP_SPAWN_CUBE", 1.0);
+    HostSim_Frames(2);
+    HostSim_SetLVar("L:WFP_SPAWN_CUBE", 0.0);
+
+    std::printf("emitter bench: %.0f s per case, tolerance %.1f m\n", seconds, tolerance);
+    std::printf("%-14s %10s %10s %10s %12s\n", "case", "updates/s", "frames/s", "per frame", "max error m");
+    bool ok = true;
+    for (const Case& c : kCases)
+    {
+        for (unsigned i = 0; i < 60; ++i) // settle into the case first
+            Fly(&aircraft, c);
+
+        EmitterFollow_ResetStats();
+        double maxError = 0.0;
+        for (unsigned i = 0; i < frames; ++i)
+        {
+            Fly(&aircraft, c);
+            maxError = std::max(maxError, CubeError(aircraft));
+        }
+
+        EmitterFollowStats stats;
+        EmitterFollow_GetStats(&stats);
+        double window = stats.windowMs / 1000.0;
+        std::printf("%-14s %10.1f %10.1f %10.2f %12.2f\n", c.name, stats.updates / window, stats.frames / window,
+            stats.frames ? (double)stats.updates / stats.frames : 0.0, maxError);
+        if (stats.frames == 0 || maxError > tolerance)
+            ok = false;
+    }
+
+    HostSimCounters counters = HostSim_GetCounters();
+    if (counters.unknownObjects != 0)
+        ok = false;
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    if (!ok)
+        std::printf("emitter bench: the cube did not follow within the tolerance\n");
+    return ok ? 0 : 1;
+}
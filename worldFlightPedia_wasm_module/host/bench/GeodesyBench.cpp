@@ -0,0 +1,289 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "geo/Geodesy.h"
+
+// -----------------------------------------------------------------------------
+// Geodesy benchmark
+// Accuracy and cost of geo/Geodesy.h in both modes. Random lines at 10 m to
+// 19000 km are solved with a reference WGS-84 direct problem (Vincenty's
+// auxiliary sphere with the distance and longitude integrals evaluated
+// numerically in long double, so no series is truncated); per distance it
+// prints the worst Geo_Inverse distance error and Geo_Direct position error.
+// Then Vincenty's Flinders Peak -> Buninyong line, a nearly antipodal pair,
+// ENU round trips, Geo_Interpolate midpoints and the ns per call of every
+// operation. Fails when GEO_EXACT is off by more than 0.1 mm on a random line
+// or 1 mm on the known one, or when a round trip or midpoint is off by more
+// than 1 mm.
+// Usage: wfp_geo_bench [lines] [calls] (default 300, 1000000)
+// -----------------------------------------------------------------------------
+
+typedef long double Real;
+
+static uint32_t s_random = 2024;
+
+static double Random01()
+{
+    s_random = s_random * 1664525u + 1013904223u;
+    return (s_random >> 8) * (1.0 / 16777216.0);
+}
+
+static const int kSimpsonSteps = 4000;
+static const double kExactLimitMeters = 1e-4;
+static const double kKnownLineLimitMeters = 1e-3;
+static const double kRoundTripLimitMeters = 1e-3;
+
+// Simpson's rule over the auxiliary sphere's arc: distance (b * I1) and the
+// longitude correction (I3)
+static Real DistanceIntegral(Real k2, Real from, Real to)
+{
+    Real h = (to - from) / kSimpsonSteps;
+    Real sum = 0;
+    for (int i = 0; i <= kSimpsonSteps; ++i)
+    {
+        Real s = sinl(from + i * h);
+        Real weight = (i == 0 || i == kSimpsonSteps) ? 1 : (i % 2 ? 4 : 2);
+        sum += weight * sqrtl(1 + k2 * s * s);
+    }
+    return sum * h / 3;
+}
+
+static Real LongitudeIntegral(Real k2, Real f, Real from, Real to)
+{
+    Real h = (to - from) / kSimpsonSteps;
+    Real sum = 0;
+    for (int i = 0; i <= kSimpsonSteps; ++i)
+    {
+        Real s = sinl(from + i * h);
+        Real weight = (i == 0 || i == kSimpsonSteps) ? 1 : (i % 2 ? 4 : 2);
+        sum += weight * (2 - f) / (1 + (1 - f) * sqrtl(1 + k2 * s * s));
+    }
+    return sum * h / 3;
+}
+
+static GeoPoint ReferenceDirect(double lat, double lon, double bearingDeg, double meters)
+{
+    const Real f = 1.0L / 298.257223563L;
+    const Real a = 6378137.0L;
+    const Real b = a * (1 - f);
+    const Real e2 = f * (2 - f);
+    const Real ep2 = e2 / (1 - e2);
+    const Real toRad = 3.14159265358979323846264338327950288L / 180;
+
+    Real alpha1 = bearingDeg * toRad;
+    Real tanU1 = (1 - f) * tanl(lat * toRad);
+    Real cosU1 = 1 / sqrtl(1 + tanU1 * tanU1);
+    Real sinU1 = tanU1 * cosU1;
+    Real sinAlpha = cosU1 * sinl(alpha1);
+    Real k2 = ep2 * (1 - sinAlpha * sinAlpha);
+    Real sigma1 = atan2l(tanU1, cosl(alpha1));
+
+    // Newton on b * I1(sigma1, sigma1 + sigma) = meters
+    Real sigma = meters / b;
+    for (int i = 0; i < 60; ++i)
+    {
+        Real s = sinl(sigma1 + sigma);
+        Real step = (b * DistanceIntegral(k2, sigma1, sigma1 + sigma) - meters) / (b * sqrtl(1 + k2 * s * s));
+        sigma -= step;
+        if (fabsl(step) < 1e-16L)
+            break;
+    }
+
+    Real sinSigma = sinl(sigma);
+    Real cosSigma = cosl(sigma);
+    Real x = sinU1 * sinSigma - cosU1 * cosSigma * cosl(alpha1);
+    Real omega = atan2l(sinSigma * sinl(alpha1), cosU1 * cosSigma - sinU1 * sinSigma * cosl(alpha1));
+    Real L = omega - f * sinAlpha * LongitudeIntegral(k2, f, sigma1, sigma1 + sigma);
+
+    GeoPoint out;
+    out.latDeg = (double)(atan2l(sinU1 * cosSigma + cosU1 * sinSigma * cosl(alpha1), (1 - f) * sqrtl(sinAlpha * sinAlpha + x * x)) / toRad);
+    out.lonDeg = Geo_WrapLon((double)(lon + L / toRad));
+    return out;
+}
+
+static void PrintMeters(double meters)
+{
+    if (meters < 1.0)
+        std::printf(" %11.3f mm", meters * 1000.0);
+    else if (meters < 1000.0)
+        std::printf(" %11.1f m ", meters);
+    else
+        std::printf(" %11.2f km", meters / 1000.0);
+}
+
+static double EnuError(const GeoEnu& a, const GeoEnu& b)
+{
+    double de = a.east - b.east, dn = a.north - b.north, du = a.up - b.up;
+    return std::sqrt(de * de + dn * dn + du * du);
+}
+
+static double Accuracy(int lines)
+{
+    const double kDistances[] = { 10.0, 1000.0, 100e3, 1000e3, 10000e3, 19000e3 };
+    double worstExact = 0.0;
+
+    std::printf("%-10s %14s %14s %14s %14s\n", "distance", "fast inverse", "exact inverse", "fast direct", "exact direct");
+    for (double meters : kDistances)
+    {
+        double worst[4] = { 0.0, 0.0, 0.0, 0.0 }; // inverse fast, exact, direct fast, exact
+        int notConverged = 0;
+        for (int i = 0; i < lines; ++i)
+        {
+            double lat = -80.0 + 160.0 * Random01();
+            double lon = -180.0 + 360.0 * Random01();
+            double bearing = 360.0 * Random01();
+            GeoPoint end = ReferenceDirect(lat, lon, bearing, meters);
+            for (int m = 0; m < 2; ++m)
+            {
+                eGeoMode mode = m ? GEO_EXACT : GEO_FAST;
+                GeoInverseResult r = Geo_Inverse(lat, lon, end.latDeg, end.lonDeg, mode);
+                if (m && !r.converged)
+                {
+                    ++notConverged; // sphere fallback, reported instead of counted as exact
+                    continue;
+                }
+                worst[m] = std::max(worst[m], std::fabs(r.meters - meters));
+                GeoPoint p = Geo_Direct(lat, lon, bearing, meters, mode);
+                worst[2 + m] = std::max(worst[2 + m], Geo_Inverse(end.latDeg, end.lonDeg, p.latDeg, p.lonDeg, GEO_EXACT).meters);
+            }
+        }
+        if (meters < 1000.0)
+            std::printf("%7.0f m ", meters);
+        else
+            std::printf("%7.0f km", meters / 1000.0);
+        for (double w : worst)
+            PrintMeters(w);
+        std::printf(notConverged ? " (%d not converged)\n" : "\n", notConverged);
+        worstExact = std::max(worstExact, std::max(worst[1], worst[3]));
+    }
+    return worstExact;
+}
+
+// Vincenty's own test line (GRS80; WGS-84 differs by less than 0.1 mm here).
+// The paper gives the reverse azimuth, i.e. the final bearing + 180.
+static bool KnownLine()
+{
+    GeoInverseResult r = Geo_Inverse(-37.95103342, 144.42486789, -37.65282114, 143.92649554, GEO_EXACT);
+    double reverse = Geo_WrapBearing(r.finalBearingDeg + 180.0);
+    std::printf("Flinders Peak -> Buninyong: %.4f m (54972.271), bearing %.6f (306.868158), reverse %.6f (127.173631)\n",
+        r.meters, r.bearingDeg, reverse);
+    return std::fabs(r.meters - 54972.271) < kKnownLineLimitMeters && std::fabs(r.bearingDeg - 306.868158) < 1e-5
+        && std::fabs(reverse - 127.173631) < 1e-5;
+}
+
+static bool RoundTrips(int samples)
+{
+    double worst[2] = { 0.0, 0.0 };
+    double worstMidpoint[2] = { 0.0, 0.0 };
+    for (int i = 0; i < samples; ++i)
+    {
+        GeoPosition origin = { -89.0 + 178.0 * Random01(), -180.0 + 360.0 * Random01(), 10000.0 * Random01() };
+        GeoEnu offset = { 20000.0 * (Random01() - 0.5), 20000.0 * (Random01() - 0.5), 2000.0 * (Random01() - 0.5) };
+        double lat1 = -80.0 + 160.0 * Random01(), lon1 = -180.0 + 360.0 * Random01();
+        double lat2 = -80.0 + 160.0 * Random01(), lon2 = -180.0 + 360.0 * Random01();
+        for (int m = 0; m < 2; ++m)
+        {
+            eGeoMode mode = m ? GEO_EXACT : GEO_FAST;
+            GeoPosition p = Geo_EnuToGeodetic(origin, offset, mode);
+            worst[m] = std::max(worst[m], EnuError(offset, Geo_GeodeticToEnu(origin, p, mode)));
+
+            // The midpoint splits the line in two equal halves in the mode's own
+            // model (skipping pairs where Vincenty falls back to the sphere)
+            if (m && !Geo_Inverse(lat1, lon1, lat2, lon2, GEO_EXACT).converged)
+                continue;
+            GeoPoint mid = Geo_Interpolate(lat1, lon1, lat2, lon2, 0.5, mode);
+            double first = Geo_Inverse(lat1, lon1, mid.latDeg, mid.lonDeg, mode).meters;
+            double second = Geo_Inverse(mid.latDeg, mid.lonDeg, lat2, lon2, mode).meters;
+            double total = Geo_Inverse(lat1, lon1, lat2, lon2, mode).meters;
+            worstMidpoint[m] = std::max(worstMidpoint[m], std::fabs(first + second - total) + std::fabs(first - second));
+        }
+    }
+    std::printf("ENU round trip: fast %.2e m, exact %.2e m\n", worst[0], worst[1]);
+    std::printf("Interpolate midpoint: fast %.2e m, exact %.2e m\n", worstMidpoint[0], worstMidpoint[1]);
+    return std::max(std::max(worst[0], worst[1]), std::max(worstMidpoint[0], worstMidpoint[1])) < kRoundTripLimitMeters;
+}
+
+static void Speed(int calls)
+{
+    std::vector<double> lat(calls), lon(calls), lat2(calls), lon2(calls), bearing(calls), meters(calls);
+    for (int i = 0; i < calls; ++i)
+    {
+        lat[i] = -80.0 + 160.0 * Random01();
+        lon[i] = -180.0 + 360.0 * Random01();
+        bearing[i] = 360.0 * Random01();
+        meters[i] = 200000.0 * Random01();
+        GeoPoint p = Geo_Direct(lat[i], lon[i], bearing[i], meters[i]);
+        lat2[i] = p.latDeg;
+        lon2[i] = p.lonDeg;
+    }
+
+    const char* kNames[] = { "Geo_Inverse", "Geo_Direct", "Geo_EnuToGeodetic", "Geo_GeodeticToEnu", "Geo_Interpolate" };
+    volatile double sink = 0.0;
+    std::printf("%-18s %10s %10s\n", "operation", "fast ns", "exact ns");
+    for (int op = 0; op < 5; ++op)
+    {
+        double ns[2];
+        for (int m = 0; m < 2; ++m)
+        {
+            eGeoMode mode = m ? GEO_EXACT : GEO_FAST;
+            double sum = 0.0;
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < calls; ++i)
+            {
+                GeoPosition origin = { lat[i], lon[i], 100.0 };
+                switch (op)
+                {
+                case 0: sum += Geo_Inverse(lat[i], lon[i], lat2[i], lon2[i], mode).meters; break;
+                case 1: sum += Geo_Direct(lat[i], lon[i], bearing[i], meters[i], mode).latDeg; break;
+                case 2:
+                {
+                    GeoEnu offset = { meters[i] * 0.01, bearing[i], 5.0 };
+                    sum += Geo_EnuToGeodetic(origin, offset, mode).latDeg;
+                    break;
+                }
+                case 3:
+                {
+                    GeoPosition point = { lat[i] + 0.01, lon[i] + 0.01, 150.0 };
+                    sum += Geo_GeodeticToEnu(origin, point, mode).east;
+                    break;
+                }
+                default: sum += Geo_Interpolate(lat[i], lon[i], lat2[i], lon2[i], 0.3, mode).latDeg; break;
+                }
+            }
+            ns[m] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+            sink = sink + sum;
+        }
+        std::printf("%-18s %10.0f %10.0f\n", kNames[op], ns[0], ns[1]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int lines = argc > 1 ? std::atoi(argv[1]) : 300;
+    int calls = argc > 2 ? std::atoi(argv[2]) : 1000000;
+
+    std::printf("geo bench: %d lines per distance, %d calls per operation\n", lines, calls);
+    double worstExact = Accuracy(lines);
+    bool ok = worstExact < kExactLimitMeters;
+    ok = KnownLine() && ok;
+
+    GeoInverseResult antipodal = Geo_Inverse(0.5, 0.0, -0.5, 179.7, GEO_EXACT);
+    std::printf("nearly antipodal: converged %d, %.1f m\n", antipodal.converged ? 1 : 0, antipodal.meters);
+
+    // ...where the exact midpoint is the spherical one
+    GeoPoint exactMid = Geo_Interpolate(0.5, 0.0, -0.5, 179.7, 0.5, GEO_EXACT);
+    GeoPoint fastMid = Geo_Interpolate(0.5, 0.0, -0.5, 179.7, 0.5, GEO_FAST);
+    bool sameMid = exactMid.latDeg == fastMid.latDeg && exactMid.lonDeg == fastMid.lonDeg;
+    std::printf("nearly antipodal midpoint: %s\n", sameMid ? "spherical" : "off the line");
+    ok = sameMid && ok;
+
+    ok = RoundTrips(std::max(lines * 10, 100)) && ok;
+    Speed(calls);
+
+    if (!ok)
+        std::printf("geo bench: GEO_EXACT is off by more than the limits\n");
+    return ok ? 0 : 1;
+}
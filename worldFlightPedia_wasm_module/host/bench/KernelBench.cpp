@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "core/PoiColumns.h"
+#include "geo/PoiKernels.h"
+#include "geo/Geodesy.h"
+
+// -----------------------------------------------------------------------------
+// Geo kernel benchmark
+// Distance and bearing from one point to 100k POIs: a scalar loop of
+// haversine / atan2 over lat, lon (what the code did before the columns)
+// against PoiKernels_Distances, PoiKernels_Bearings and PoiKernels_ChordSq.
+// Prints milliseconds per pass (best of the repetitions) and the largest
+// difference from the scalar result; fails when a kernel is off by more
+// than 1 mm or 1e-6 degrees.
+// Usage: wfp_kernel_bench [repetitions] [pois] (default 50, 100000)
+// -----------------------------------------------------------------------------
+
+static uint32_t s_random = 777;
+
+static double Random01()
+{
+    s_random = s_random * 1664525u + 1013904223u;
+    return (s_random >> 8) * (1.0 / 16777216.0);
+}
+
+static void ScalarDistances(const PoiColumns& pois, double lat, double lon, double* out)
+{
+    double p1 = lat * GEO_DEG_TO_RAD;
+    double cosP1 = std::cos(p1);
+    for (size_t i = 0; i < pois.size(); ++i)
+    {
+        double p2 = pois.lat[i] * GEO_DEG_TO_RAD;
+        double sinHalfDLat = std::sin((p2 - p1) * 0.5);
+        double sinHalfDLon = std::sin((pois.lon[i] - lon) * GEO_DEG_TO_RAD * 0.5);
+        double h = sinHalfDLat * sinHalfDLat + cosP1 * std::cos(p2) * sinHalfDLon * sinHalfDLon;
+        out[i] = 2.0 * GEO_MEAN_RADIUS_METERS * std::asin(std::sqrt(std::min(h, 1.0)));
+    }
+}
+
+static void ScalarBearings(const PoiColumns& pois, double lat, double lon, double* out)
+{
+    double p1 = lat * GEO_DEG_TO_RAD;
+    double sinP1 = std::sin(p1), cosP1 = std::cos(p1);
+    for (size_t i = 0; i < pois.size(); ++i)
+    {
+        double p2 = pois.lat[i] * GEO_DEG_TO_RAD;
+        double dLon = (pois.lon[i] - lon) * GEO_DEG_TO_RAD;
+        double sinP2 = std::sin(p2), cosP2 = std::cos(p2);
+        double deg = std::atan2(std::sin(dLon) * cosP2, cosP1 * sinP2 - sinP1 * cosP2 * std::cos(dLon)) * GEO_RAD_TO_DEG;
+        out[i] = deg < 0.0 ? deg + 360.0 : deg;
+    }
+}
+
+// Best time of 'repetitions' passes, in ms
+template <typename Fn>
+static double BestMs(int repetitions, Fn fn)
+{
+    double best = 1e30;
+    for (int r = 0; r < repetitions; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static double MaxDiff(const std::vector<double>& a, const std::vector<double>& b, bool angles)
+{
+    double worst = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        double d = std::fabs(a[i] - b[i]);
+        if (angles)
+            d = std::min(d, 360.0 - d);
+        worst = std::max(worst, d);
+    }
+    return worst;
+}
+
+int main(int argc, char** argv)
+{
+    int repetitions = argc > 1 ? std::atoi(argv[1]) : 50;
+    int poiCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+
+    PoiColumns pois;
+    for (int i = 0; i < poiCount; ++i)
+        PoiColumns_Append(pois, -80.0 + 160.0 * Random01(), -180.0 + 360.0 * Random01());
+    const double lat = 47.3;
+    const double lon = 8.5;
+
+    std::vector<double> scalar(pois.size());
+    std::vector<double> kernel(pois.size());
+    std::vector<double> chord(pois.size());
+    std::printf("kernel bench: %d POIs, isa %s, best of %d\n", poiCount, PoiKernels_Isa(), repetitions);
+
+    double scalarDistMs = BestMs(repetitions, [&] { ScalarDistances(pois, lat, lon, scalar.data()); });
+    double kernelDistMs = BestMs(repetitions, [&] { PoiKernels_Distances(pois, 0, pois.size(), lat, lon, kernel.data()); });
+    double distDiff = MaxDiff(scalar, kernel, false);
+    double chordMs = BestMs(repetitions, [&] { PoiKernels_ChordSq(pois, 0, pois.size(), lat, lon, chord.data()); });
+
+    // The chord ranks POIs like the distance does
+    bool chordRanks = true;
+    for (size_t i = 1; i < pois.size(); ++i)
+        if ((chord[i] < chord[i - 1]) != (kernel[i] < kernel[i - 1]) && std::fabs(kernel[i] - kernel[i - 1]) > 1e-3)
+            chordRanks = false;
+
+    double scalarBearMs = BestMs(repetitions, [&] { ScalarBearings(pois, lat, lon, scalar.data()); });
+    double kernelBearMs = BestMs(repetitions, [&] { PoiKernels_Bearings(pois, 0, pois.size(), lat, lon, kernel.data()); });
+    double bearDiff = MaxDiff(scalar, kernel, true);
+
+    std::printf("%-10s %10s %10s %9s %14s\n", "pass", "scalar ms", "kernel ms", "speedup", "max diff");
+    std::printf("%-10s %10.2f %10.2f %8.1fx %11.2e m\n", "distance", scalarDistMs, kernelDistMs,
+        scalarDistMs / kernelDistMs, distDiff);
+    std::printf("%-10s %10.2f %10.2f %8.1fx %14s\n", "chord", scalarDistMs, chordMs, scalarDistMs / chordMs,
+        chordRanks ? "same ranking" : "RANKING DIFFERS");
+    std::printf("%-10s %10.2f %10.2f %8.1fx %9.2e deg\n", "bearing", scalarBearMs, kernelBearMs,
+        scalarBearMs / kernelBearMs, bearDiff);
+
+    bool ok = distDiff < 1e-3 && bearDiff < 1e-6 && chordRanks;
+    if (!ok)
+        std::printf("kernel bench: kernels disagree with the scalar loop\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "host/HostSim.h"
+#include "core/Constants.h"
+#include "core/ModuleContext.h"
+#include "simobjects/SimObjectManager.h"
+
+// -----------------------------------------------------------------------------
+// Marker advance benchmark (NextPoi)
+// A 1000-POI tour is advanced with L:WFP_NextPoi in three ways:
+// - remove + create: the stand-in rejects SetDataOnSimObject, so every
+//   advance falls back to removing the old object and creating a new one
+//   (what NextPoi did before markers were reused)
+// - pool reuse: lookahead off, the released object is moved to the new POI
+// - lookahead: the default, the new POI's parked marker is raised in place
+// Creates are answered createDelay frames later, like the sim's AI create
+// latency. Per advance it prints the SimConnect object calls and the frames
+// (and scripted ms) until the active POI's marker is live.
+// Usage: wfp_marker_bench [advances] [createDelayFrames] (default 100, 25)
+// -----------------------------------------------------------------------------
+
+static const unsigned kSettleFrames = 5;    // after the marker is live, for the lookahead creates
+static const unsigned kMaxWaitFrames = 500;
+
+static void Send(const char* message)
+{
+    HostSim_SendToModule(message);
+    HostSim_Frame();
+}
+
+static bool ActiveMarkerLive()
+{
+    if (!g_flightActive || g_activePoiIndex < 0 || (size_t)g_activePoiIndex >= g_poi_ids.size())
+        return false;
+    return SimObjectManager_GetMarkerState(g_poi_ids[g_activePoiIndex]) == MARKER_LIVE;
+}
+
+// Frames until the active marker is live, then a few more so queued creates settle
+static unsigned WaitForMarker()
+{
+    unsigned frames = 0;
+    while (!ActiveMarkerLive() && frames < kMaxWaitFrames)
+    {
+        HostSim_Frame();
+        ++frames;
+    }
+    return frames;
+}
+
+static void Settle(unsigned createDelay)
+{
+    HostSim_Frames(createDelay + kSettleFrames);
+}
+
+// Returns false when a marker never became live
+static bool Run(const char* name, unsigned advances, unsigned createDelay)
+{
+    HostSimCounters before = HostSim_GetCounters();
+    unsigned totalFrames = 0;
+    unsigned maxFrames = 0;
+    for (unsigned i = 0; i < advances; ++i)
+    {
+        HostSim_SetLVar("L:WFP_NextPoi", 1.0);
+        HostSim_Frame();
+        HostSim_SetLVar("L:WFP_NextPoi", 0.0);
+        unsigned frames = WaitForMarker();
+        if (frames >= kMaxWaitFrames)
+        {
+            std::printf("%s: marker of POI index %d never became live\n", name, g_activePoiIndex);
+            return false;
+        }
+        totalFrames += frames;
+        if (frames > maxFrames)
+            maxFrames = frames;
+        Settle(createDelay);
+    }
+    HostSimCounters after = HostSim_GetCounters();
+
+    std::printf("%-16s %9.2f %9.2f %9.2f %11.2f %10u %9.1f\n", name,
+        (double)(after.creates - before.creates) / advances,
+        (double)(after.removes - before.removes) / advances,
+        (double)(after.moves - before.moves) / advances,
+        (double)totalFrames / advances, maxFrames,
+        (double)totalFrames * HOSTSIM_FRAME_MS / advances);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned advances = argc > 1 ? (unsigned)std::atoi(argv[1]) : 100;
+    unsigned createDelay = argc > 2 ? (unsigned)std::atoi(argv[2]) : 25;
+
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    // Far from the tour, so no arrival advances it
+    AircraftState aircraft = {};
+    aircraft.latDeg = 10.0;
+    aircraft.lonDeg = 8.0;
+    aircraft.altMeters = 600.0;
+    aircraft.altAboveGroundMeters = 300.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+
+    std::string pois = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < 1000; ++i)
+    {
+        char poi[64];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.4f,\"lon\":8.0}", i ? "," : "", i, 47.0 + i * 0.01);
+        pois += poi;
+    }
+    pois += "]}";
+    HostSim_SendToModule(pois.data(), pois.size());
+    Send("{\"type\":\"GEOFENCE\",\"enabled\":false}");
+    Send("{\"type\":\"TOUR_OPTIMIZER\",\"enabled\":false}");
+
+    HostSim_SetCreateDelay(createDelay);
+    HostSim_SetLVar("L:WFP_StartFlight", 1.0);
+    HostSim_Frame();
+    WaitForMarker();
+    Settle(createDelay);
+
+    std::printf("marker bench: %u advances per mode, creates answered after %u frames (%u ms)\n",
+        advances, createDelay, createDelay * (unsigned)HOSTSIM_FRAME_MS);
+    std::printf("%-16s %9s %9s %9s %11s %10s %9s\n", "mode", "creates", "removes", "moves",
+        "frames", "max frames", "ms");
+
+    bool ok = true;
+    HostSim_SetMovesFail(true);
+    Send("{\"type\":\"MARKER_LOOKAHEAD\",\"depth\":0}");
+    Settle(createDelay);
+    ok = Run("remove + create", advances, createDelay) && ok;
+
+    HostSim_SetMovesFail(false);
+    Settle(createDelay);
+    ok = Run("pool reuse", advances, createDelay) && ok;
+
+    Send("{\"type\":\"MARKER_LOOKAHEAD\",\"depth\":3,\"budget\":8}");
+    Settle(createDelay);
+    ok = Run("lookahead", advances, createDelay) && ok;
+
+    HostSimCounters counters = HostSim_GetCounters();
+    if (counters.unknownObjects != 0)
+    {
+        std::printf("marker bench: %llu calls on objects that are not live\n", (unsigned long long)counters.unknownObjects);
+        ok = false;
+    }
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "comm/MessageParser.h"
+
+// -----------------------------------------------------------------------------
+// Parser throughput benchmark
+// Parses a POI_COORDINATES list with the full schema (id, name, lat, lon,
+// elevation, category) at 50, 5k and 100k POIs, repeating each size for at
+// least minMs, and prints MB/s, POIs/s and ns per POI.
+// Usage: wfp_parser_bench [minMs] (default 500)
+// -----------------------------------------------------------------------------
+
+static std::string PoiList(int count)
+{
+    std::string message = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < count; ++i)
+    {
+        char poi[192];
+        std::snprintf(poi, sizeof(poi),
+            "%s{\"id\":%d,\"name\":\"Point of interest %d\",\"lat\":%.6f,\"lon\":%.6f,\"elevation\":%.1f,\"category\":\"landmark\"}",
+            i ? "," : "", i, i, -60.0 + (i % 1200) * 0.1, -170.0 + (i / 1200) * 0.25, (i % 300) * 1.5);
+        message += poi;
+    }
+    char tail[32];
+    std::snprintf(tail, sizeof(tail), "],\"count\":%d}", count);
+    message += tail;
+    return message;
+}
+
+static void CountRecord(const PoiRecord& poi, void* ctx)
+{
+    *static_cast<double*>(ctx) += poi.lat;
+}
+
+int main(int argc, char** argv)
+{
+    double minMs = argc > 1 ? std::atof(argv[1]) : 500.0;
+    const int sizes[] = { 50, 5000, 100000 };
+
+    std::printf("%8s %10s %8s %10s %12s %9s\n", "POIs", "bytes", "runs", "MB/s", "POIs/s", "ns/POI");
+    for (int size : sizes)
+    {
+        std::string message = PoiList(size);
+        double sink = 0.0;
+        unsigned runs = 0;
+        double elapsedMs = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        do
+        {
+            PoiParseResult result = ParsePoiMessage(message.data(), message.size(), CountRecord, &sink);
+            if (result.error != POI_PARSE_OK || result.count != (uint32_t)size)
+            {
+                std::printf("parse failed: %s at %zu\n", PoiParse_ErrorName(result.error), result.offset);
+                return 1;
+            }
+            ++runs;
+            elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        } while (elapsedMs < minMs);
+
+        double seconds = elapsedMs / 1000.0;
+        double pois = (double)size * runs;
+        std::printf("%8d %10zu %8u %10.1f %12.0f %9.1f\n", size, message.size(), runs,
+            message.size() * (double)runs / seconds / 1e6, pois / seconds, elapsedMs * 1e6 / pois);
+        if (sink == 0.0)
+            std::printf(" ");
+    }
+    return 0;
+}
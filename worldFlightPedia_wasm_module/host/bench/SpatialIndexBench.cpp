@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "core/ModuleContext.h"
+#include "core/PoiStore.h"
+#include "geo/PoiSpatialIndex.h"
+#include "geo/Geodesy.h"
+
+// -----------------------------------------------------------------------------
+// Spatial index benchmark
+// 100k POIs spread over a 25 x 40 degree box (roughly Europe), loaded through
+// PoiStore_Replace. Times nearest (k = 1, 10), radius (5 km, 50 km) and
+// any-within (500 m) queries from random points in the box against a linear
+// haversine scan over all POIs, checks that both return the same distances,
+// and times one duplicate pass over the whole store.
+// Usage: wfp_index_bench [queries] [pois] (default 10000, 100000)
+// -----------------------------------------------------------------------------
+
+static uint32_t s_random = 12345;
+
+static double Random01()
+{
+    s_random = s_random * 1664525u + 1013904223u;
+    return (s_random >> 8) * (1.0 / 16777216.0);
+}
+
+static double RandomLat() { return 35.0 + 25.0 * Random01(); }
+static double RandomLon() { return -10.0 + 40.0 * Random01(); }
+
+// Distance only, as a plain scan would compute it
+static double Haversine(double lat1, double lon1, double lat2, double lon2)
+{
+    double sinHalfDLat = std::sin((lat2 - lat1) * GEO_DEG_TO_RAD * 0.5);
+    double sinHalfDLon = std::sin((lon2 - lon1) * GEO_DEG_TO_RAD * 0.5);
+    double h = sinHalfDLat * sinHalfDLat
+        + std::cos(lat1 * GEO_DEG_TO_RAD) * std::cos(lat2 * GEO_DEG_TO_RAD) * sinHalfDLon * sinHalfDLon;
+    return 2.0 * GEO_MEAN_RADIUS_METERS * std::asin(std::sqrt(std::min(h, 1.0)));
+}
+
+// The k smallest haversine distances from (lat, lon), closest first
+static void LinearNearest(double lat, double lon, size_t k, std::vector<double>& out)
+{
+    out.clear();
+    for (size_t i = 0; i < g_poi_coords.size(); ++i)
+        out.push_back(Haversine(lat, lon, g_poi_coords.lat[i], g_poi_coords.lon[i]));
+    k = std::min(k, out.size());
+    std::partial_sort(out.begin(), out.begin() + k, out.end());
+    out.resize(k);
+}
+
+static size_t LinearRadius(double lat, double lon, double meters)
+{
+    size_t hits = 0;
+    for (size_t i = 0; i < g_poi_coords.size(); ++i)
+        if (Haversine(lat, lon, g_poi_coords.lat[i], g_poi_coords.lon[i]) <= meters)
+            ++hits;
+    return hits;
+}
+
+static double ElapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct Query
+{
+    const char* name;
+    size_t k;      // nearest: k, otherwise 0
+    double meters; // radius / any-within: meters
+    bool any;
+};
+
+int main(int argc, char** argv)
+{
+    int queries = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int poiCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+    int linearQueries = std::max(1, std::min(queries, 50)); // the scan is slow at 100k
+
+    PoiColumns coords;
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> changed;
+    for (int i = 0; i < poiCount; ++i)
+    {
+        PoiColumns_Append(coords, RandomLat(), RandomLon());
+        ids.push_back((uint32_t)i);
+    }
+    auto loadStart = std::chrono::steady_clock::now();
+    PoiStore_Replace(coords, ids, changed);
+    std::printf("index bench: %d POIs loaded and indexed in %.1f ms\n", poiCount, ElapsedUs(loadStart) / 1000.0);
+
+    std::vector<double> points;
+    for (int i = 0; i < queries; ++i)
+    {
+        points.push_back(RandomLat());
+        points.push_back(RandomLon());
+    }
+
+    const Query kQueries[] = {
+        { "nearest k=1", 1, 0.0, false },
+        { "nearest k=10", 10, 0.0, false },
+        { "radius 5 km", 0, 5000.0, false },
+        { "radius 50 km", 0, 50000.0, false },
+        { "any within 500 m", 0, 500.0, true },
+    };
+
+    std::printf("%-18s %10s %12s %10s %9s\n", "query", "index us", "linear us", "speedup", "avg hits");
+    int mismatches = 0;
+    std::vector<PoiHit> hits;
+    std::vector<double> expected;
+    for (const Query& q : kQueries)
+    {
+        size_t hitCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < queries; ++i)
+        {
+            double lat = points[2 * i];
+            double lon = points[2 * i + 1];
+            if (q.any)
+            {
+                hitCount += PoiIndex_AnyWithin(lat, lon, q.meters, 0xFFFFFFFFu) ? 1 : 0;
+                continue;
+            }
+            if (q.k)
+                PoiIndex_Nearest(lat, lon, q.k, hits);
+            else
+                PoiIndex_Radius(lat, lon, q.meters, hits);
+            hitCount += hits.size();
+        }
+        double indexUs = ElapsedUs(start) / queries;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < linearQueries; ++i)
+        {
+            double lat = points[2 * i];
+            double lon = points[2 * i + 1];
+            if (q.k)
+                LinearNearest(lat, lon, q.k, expected);
+            else
+                LinearRadius(lat, lon, q.meters);
+        }
+        double linearUs = ElapsedUs(start) / linearQueries;
+
+        // Same answers as the scan (distances; ids may differ on exact ties)
+        for (int i = 0; i < linearQueries; ++i)
+        {
+            double lat = points[2 * i];
+            double lon = points[2 * i + 1];
+            if (q.k)
+            {
+                PoiIndex_Nearest(lat, lon, q.k, hits);
+                LinearNearest(lat, lon, q.k, expected);
+                bool same = hits.size() == expected.size();
+                for (size_t h = 0; same && h < hits.size(); ++h)
+                    same = std::fabs(hits[h].meters - expected[h]) < 0.01;
+                mismatches += same ? 0 : 1;
+            }
+            else if (q.any)
+                mismatches += PoiIndex_AnyWithin(lat, lon, q.meters, 0xFFFFFFFFu) != (LinearRadius(lat, lon, q.meters) > 0);
+            else
+            {
+                PoiIndex_Radius(lat, lon, q.meters, hits);
+                mismatches += hits.size() != LinearRadius(lat, lon, q.meters);
+            }
+        }
+
+        std::printf("%-18s %10.2f %12.1f %9.0fx %9.1f\n", q.name, indexUs, linearUs, linearUs / indexUs,
+            (double)hitCount / queries);
+    }
+
+    std::vector<uint32_t> duplicates;
+    auto dedupStart = std::chrono::steady_clock::now();
+    PoiIndex_FindDuplicates(100.0, duplicates);
+    std::printf("%-18s %10.1f ms for the whole store, %zu duplicates\n", "dedup 100 m",
+        ElapsedUs(dedupStart) / 1000.0, duplicates.size());
+
+    if (mismatches)
+        std::printf("index bench: %d queries differ from the linear scan\n", mismatches);
+    return mismatches ? 1 : 0;
+}
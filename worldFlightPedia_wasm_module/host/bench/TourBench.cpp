@@ -0,0 +1,97 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "core/Constants.h"
+#include "core/PoiColumns.h"
+#include "flight/TourOptimizer.h"
+#include "geo/Geodesy.h"
+
+// -----------------------------------------------------------------------------
+// Tour optimizer benchmark
+// Random POIs in a 2 x 3 degree box (a regional tour) at 50 to 10k POIs,
+// solved from the aircraft at the box's corner with the default budget and
+// with an unlimited one. Prints the input, nearest-neighbour and optimized
+// path lengths, the gain over the seed, the 2-opt / Or-opt moves and the time,
+// and fails when an order is not a permutation or its length is misreported.
+// Usage: wfp_tour_bench [maxPois] (default 10000)
+// -----------------------------------------------------------------------------
+
+static uint32_t s_random = 4242;
+
+static double Random01()
+{
+    s_random = s_random * 1664525u + 1013904223u;
+    return (s_random >> 8) * (1.0 / 16777216.0);
+}
+
+static const double kStartLat = 46.0;
+static const double kStartLon = 7.0;
+
+static double PathMeters(const PoiColumns& pois, const std::vector<uint32_t>& order)
+{
+    double meters = 0.0;
+    double lat = kStartLat;
+    double lon = kStartLon;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        meters += GeoSphere_Inverse(lat, lon, pois.lat[order[i]], pois.lon[order[i]]).meters;
+        lat = pois.lat[order[i]];
+        lon = pois.lon[order[i]];
+    }
+    return meters;
+}
+
+static bool IsPermutation(const std::vector<uint32_t>& order, size_t count)
+{
+    std::vector<bool> seen(count, false);
+    if (order.size() != count)
+        return false;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (order[i] >= count || seen[order[i]])
+            return false;
+        seen[order[i]] = true;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int maxPois = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int sizes[] = { 50, 200, 1000, 5000, 10000 };
+    const uint32_t budgets[] = { TOUR_OPTIMIZE_BUDGET_MS, 60000 };
+
+    std::printf("%6s %7s %10s %10s %10s %7s %8s %8s %9s %s\n", "POIs", "budget", "input km", "seed km",
+        "final km", "gain", "2-opt", "or-opt", "ms", "");
+    int failures = 0;
+    for (int size : sizes)
+    {
+        if (size > maxPois)
+            break;
+
+        PoiColumns pois;
+        for (int i = 0; i < size; ++i)
+            PoiColumns_Append(pois, kStartLat + 2.0 * Random01(), kStartLon + 3.0 * Random01());
+
+        for (uint32_t budgetMs : budgets)
+        {
+            std::vector<uint32_t> order;
+            TourStats stats;
+            TourOptimizer_Solve(pois, 0, true, kStartLat, kStartLon, budgetMs, order, stats);
+
+            double meters = PathMeters(pois, order);
+            if (!IsPermutation(order, pois.size()) || std::abs(meters - stats.meters) > 1.0)
+            {
+                std::printf("%d POIs: invalid order (%.0f m reported, %.0f m walked)\n", size, stats.meters, meters);
+                ++failures;
+            }
+
+            std::printf("%6d %7u %10.1f %10.1f %10.1f %6.1f%% %8u %8u %9.1f %s\n", size, (unsigned)budgetMs,
+                stats.inputMeters / 1000.0, stats.seedMeters / 1000.0, stats.meters / 1000.0,
+                100.0 * (1.0 - stats.meters / stats.seedMeters), (unsigned)stats.twoOptMoves,
+                (unsigned)stats.orOptMoves, stats.elapsedMs, stats.budgetExhausted ? "(budget)" : "");
+        }
+    }
+    return failures ? 1 : 0;
+}
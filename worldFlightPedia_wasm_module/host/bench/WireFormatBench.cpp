@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "host/HostSim.h"
+#include "core/Constants.h"
+#include "core/PoiColumns.h"
+#include "comm/MessageParser.h"
+#include "comm/PoiWireFormat.h"
+
+// -----------------------------------------------------------------------------
+// Binary vs text POI upload benchmark
+// The same POI list (id, lat, lon) as a POI_COORDINATES JSON message and as a
+// WFP1 binary message, at 50, 5k and 100k POIs:
+// - decode: parse into PoiColumns, as the CommBus staging does
+// - module: OnMessageFromJS end to end (decode, store diff, ack), re-sending
+//   the same list so the store is unchanged after the first run
+// Each case repeats for at least minMs and prints the bytes sent and the
+// microseconds per message.
+// Usage: wfp_wire_bench [minMs] (default 500)
+// -----------------------------------------------------------------------------
+
+static double PoiLat(int i) { return -60.0 + (i % 1200) * 0.1; }
+static double PoiLon(int i) { return -170.0 + (i / 1200) * 0.25; }
+
+static std::string TextList(int count)
+{
+    std::string message = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < count; ++i)
+    {
+        char poi[96];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.6f,\"lon\":%.6f}", i ? "," : "", i, PoiLat(i), PoiLon(i));
+        message += poi;
+    }
+    message += "]}";
+    return message;
+}
+
+static std::string BinaryList(int count)
+{
+    PoiWireHeader header = {};
+    header.magic = POI_WIRE_MAGIC;
+    header.version = POI_WIRE_VERSION;
+    header.type = POI_WIRE_TYPE_COORDINATES;
+    header.count = (uint32_t)count;
+    header.flags = POI_WIRE_FLAG_HAS_IDS;
+    header.headerSize = sizeof(PoiWireHeader);
+
+    std::string message((const char*)&header, sizeof(header));
+    for (int i = 0; i < count; ++i)
+    {
+        double lat = PoiLat(i);
+        message.append((const char*)&lat, sizeof(lat));
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        double lon = PoiLon(i);
+        message.append((const char*)&lon, sizeof(lon));
+    }
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t id = (uint32_t)i;
+        message.append((const char*)&id, sizeof(id));
+    }
+    return message;
+}
+
+static PoiColumns s_columns;
+static std::vector<uint32_t> s_ids;
+
+static void StageRecord(const PoiRecord& poi, void*)
+{
+    PoiColumns_Append(s_columns, poi.lat, poi.lon);
+    s_ids.push_back(poi.id);
+}
+
+static bool DecodeText(const std::string& message)
+{
+    PoiColumns_Clear(s_columns);
+    s_ids.clear();
+    PoiParseResult result = ParsePoiMessage(message.data(), message.size(), StageRecord, nullptr);
+    return result.error == POI_PARSE_OK;
+}
+
+static bool DecodeBinary(const std::string& message)
+{
+    PoiWireView view;
+    if (PoiWire_Parse(message.data(), message.size(), &view) != POI_WIRE_OK)
+        return false;
+
+    PoiColumns_Clear(s_columns);
+    s_ids.clear();
+    for (uint32_t i = 0; i < view.count; ++i)
+    {
+        PoiColumns_Append(s_columns, PoiWire_Lat(view, i), PoiWire_Lon(view, i));
+        s_ids.push_back(PoiWire_Id(view, i));
+    }
+    return true;
+}
+
+static bool SendToModule(const std::string& message)
+{
+    HostSim_ClearOutput();
+    HostSim_SendToModule(message.data(), message.size());
+    return HostSim_Output().find("nack") == std::string::npos;
+}
+
+// Microseconds per call of fn(message), repeated for at least minMs
+template <typename Fn>
+static double TimeUs(Fn fn, const std::string& message, double minMs, bool* ok)
+{
+    unsigned runs = 0;
+    double elapsedMs = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    do
+    {
+        *ok = fn(message) && *ok;
+        ++runs;
+        elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsedMs < minMs);
+    return elapsedMs * 1000.0 / runs;
+}
+
+int main(int argc, char** argv)
+{
+    double minMs = argc > 1 ? std::atof(argv[1]) : 500.0;
+    const int sizes[] = { 50, 5000, 100000 };
+
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    std::printf("%8s %6s %10s %12s %12s\n", "POIs", "format", "bytes", "decode us", "module us");
+    bool ok = true;
+    for (int size : sizes)
+    {
+        std::string text = TextList(size);
+        std::string binary = BinaryList(size);
+        double textDecode = TimeUs(DecodeText, text, minMs, &ok);
+        double textModule = TimeUs(SendToModule, text, minMs, &ok);
+        double binaryDecode = TimeUs(DecodeBinary, binary, minMs, &ok);
+        double binaryModule = TimeUs(SendToModule, binary, minMs, &ok);
+
+        std::printf("%8d %6s %10zu %12.1f %12.1f\n", size, "text", text.size(), textDecode, textModule);
+        std::printf("%8d %6s %10zu %12.1f %12.1f\n", size, "binary", binary.size(), binaryDecode, binaryModule);
+        std::printf("%8d %6s %9.1fx %11.1fx %11.1fx\n", size, "ratio", (double)text.size() / binary.size(),
+            textDecode / binaryDecode, textModule / binaryModule);
+    }
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    if (!ok)
+        std::printf("a message was rejected\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * HostCheck
+ * ---------
+ * Minimal assertions for the host tests: a failed check is reported with its
+ * location and the test keeps running, so one run lists every failure.
+ */
+
+#define HOST_CHECK(cond) HostCheck_Record((cond), #cond, __FILE__, __LINE__)
+
+// Returns ok, printing the expression when it is false
+bool HostCheck_Record(bool ok, const char* expression, const char* file, int line);
+
+// Prints the summary; returns the process exit code (0 when every check passed)
+int HostCheck_Finish(const char* testName);
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <SimConnect.h>
+#include "simconnect/Telemetry.h"
+
+/**
+ * HostSim
+ * -------
+ * Desktop stand-in for the SimConnect, CommBus and gauges calls the module
+ * makes, so its unchanged sources can be driven by scripted scenarios.
+ * - SimConnect messages are queued and delivered to the installed dispatch
+ *   proc in order by HostSim_Pump (HostSim_Frame pumps once per frame)
+ * - AICreateSimulatedObject assigns the next object id and queues its
+ *   ASSIGNED_OBJECT_ID (not while a dispatch trace is replayed: the trace
+ *   carries those), by default for the same pump, optionally some frames
+ *   later like the sim; removes and moves are checked against live objects
+ * - Watched L:Vars (the DEFINITION_LVAR_WATCH data definition) keep a value
+ *   that scripts and "<value> (>L:NAME)" calculator code set; like the sim, a
+ *   frame only reports them after a change
+ * - The user aircraft state is reported for REQUEST_USER_STATE, also only
+ *   after a change
+ * - The scheduler runs on a scripted clock that HostSim_Frame advances by
+ *   HOSTSIM_FRAME_MS
+ * - WASM -> JS payloads are appended to an output buffer; JS -> WASM messages
+ *   call the registered OnMessageFromJs callback directly
+ * - Global operator new is counted, so a scenario can assert the allocations
+ *   of a phase
+ * The stand-in's own buffers grow only while warming up, so they do not show
+ * in the allocation count of a steady phase.
+ */
+
+const uint64_t HOSTSIM_FRAME_MS = 16;
+
+struct HostSimCounters
+{
+    uint64_t dispatched;      // messages delivered to the dispatch proc
+    uint64_t creates;         // AICreateSimulatedObject
+    uint64_t removes;         // AIRemoveObject
+    uint64_t moves;           // SetDataOnSimObject
+    uint64_t liveObjects;     // created and not removed yet
+    uint64_t unknownObjects;  // removes / moves of an id that is not live
+    uint64_t calculatorCalls; // execute_calculator_code
+    uint64_t toJsCalls;       // fsCommBusCall
+    uint64_t toJsBytes;
+};
+
+// Puts the scheduler on the scripted clock, runs module_init and delivers
+// what it queued
+void HostSim_Init();
+
+// Runs module_deinit and resets the stand-in for the next HostSim_Init. The
+// module's own state is not reset (a reload in the sim is a fresh instance),
+// so a scenario that needs a fresh module runs in its own process.
+void HostSim_Deinit();
+
+// Advances the clock by HOSTSIM_FRAME_MS, queues the changed L:Vars, the
+// changed aircraft state and EVENT_FRAME, and pumps
+void HostSim_Frame();
+void HostSim_Frames(unsigned count);
+
+// Delivers queued messages (including those queued while delivering)
+void HostSim_Pump();
+
+// Queues a raw message, e.g. one read from a dispatch trace
+void HostSim_Queue(const SIMCONNECT_RECV* message, size_t size);
+
+// Queues a client event (EVENT_TRIGGER_M, ...)
+void HostSim_Event(DWORD eventId, DWORD data = 0);
+
+// The aircraft state reported from the next frame on (sampleMs is ignored)
+void HostSim_SetAircraft(const AircraftState& state);
+
+// Creates are answered this many frames after the call (0, the default: in
+// the pump that is running or the next one)
+void HostSim_SetCreateDelay(unsigned frames);
+
+// While set, SetDataOnSimObject fails with E_FAIL (an object the sim no
+// longer accepts data for); the call is still counted as a move
+void HostSim_SetMovesFail(bool fail);
+
+// Copies up to 'size' bytes of the data of the last SetDataOnSimObject call
+// and its definition / object id. Returns false before the first call.
+bool HostSim_LastSetData(DWORD* defineId, DWORD* objectId, void* data, size_t size);
+
+// Sets a watched L:Var, e.g. "L:WFP_NextPoi". Returns false for a name the
+// module does not watch.
+bool HostSim_SetLVar(const char* name, double value);
+double HostSim_GetLVar(const char* name);
+
+// JS -> WASM: calls the module's OnMessageFromJs callback
+void HostSim_SendToModule(const char* message);
+void HostSim_SendToModule(const char* message, size_t size);
+
+// WASM -> JS payloads since the last HostSim_ClearOutput, in order
+const std::string& HostSim_Output();
+void HostSim_ClearOutput();
+
+uint64_t HostSim_NowMs();
+HostSimCounters HostSim_GetCounters();
+
+// Global operator new calls since the process started
+uint64_t HostSim_Allocations();
+
+// Process CPU time in milliseconds
+double HostSim_CpuMs();
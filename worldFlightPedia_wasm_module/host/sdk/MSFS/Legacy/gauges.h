@@ -0,0 +1,15 @@
+#pragma once
+#include <MSFS/MSFS_WindowsTypes.h>
+
+/**
+ * gauges (host stand-in)
+ * ----------------------
+ * The one legacy gauge call the module makes. The host version understands
+ * "<value> (>L:NAME)" writes to watched L:Vars (see host/include/host/HostSim.h).
+ */
+
+typedef double FLOAT64;
+typedef int32_t SINT32;
+typedef const char* PCSTRINGZ;
+
+bool execute_calculator_code(PCSTRINGZ code, FLOAT64* fvalue, SINT32* ivalue, PCSTRINGZ* svalue);
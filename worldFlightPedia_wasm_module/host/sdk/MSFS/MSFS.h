@@ -0,0 +1,10 @@
+#pragma once
+#include <MSFS/MSFS_WindowsTypes.h>
+
+/**
+ * MSFS (host stand-in)
+ * --------------------
+ * Only the calling-convention macro of the SDK header.
+ */
+
+#define MSFS_CALLBACK
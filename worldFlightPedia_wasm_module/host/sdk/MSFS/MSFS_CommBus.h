@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * MSFS_CommBus (host stand-in)
+ * ----------------------------
+ * Declarations of the CommBus calls the module makes; host/src/HostSim.cpp
+ * implements them.
+ */
+
+enum FsCommBusBroadcastFlags
+{
+    FsCommBusBroadcast_Default = 0,
+    FsCommBusBroadcast_JS = 1,
+    FsCommBusBroadcast_Wasm = 2,
+    FsCommBusBroadcast_WasmSelfCall = 4,
+    FsCommBusBroadcast_AllWasm = FsCommBusBroadcast_Wasm | FsCommBusBroadcast_WasmSelfCall,
+    FsCommBusBroadcast_All = FsCommBusBroadcast_JS | FsCommBusBroadcast_AllWasm
+};
+
+typedef void (*FsCommBusCallback)(const char* args, unsigned int size, void* ctx);
+
+bool fsCommBusCall(const char* name, const char* buf, unsigned int bufSize, FsCommBusBroadcastFlags flags);
+bool fsCommBusRegister(const char* name, FsCommBusCallback callback, void* ctx);
+int fsCommBusUnregister(const char* name, FsCommBusCallback callback);
+int fsCommBusUnregisterAll();
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * MSFS_WindowsTypes (host stand-in)
+ * ---------------------------------
+ * The Win32 names the module uses, sized as in the MSFS WASM toolchain
+ * (DWORD is 32 bits), so SIMCONNECT_RECV layouts and dispatch traces match
+ * the sim's.
+ */
+
+typedef void* HANDLE;
+typedef uint32_t DWORD;
+typedef int32_t HRESULT;
+typedef int BOOL;
+
+#define S_OK ((HRESULT)0)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define FALSE 0
+#define TRUE 1
+#define CALLBACK
+
+#ifndef MAX_PATH
+#define MAX_PATH 260
+#endif
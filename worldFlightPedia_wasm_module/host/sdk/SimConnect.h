@@ -0,0 +1,162 @@
+#pragma once
+#include <MSFS/MSFS_WindowsTypes.h>
+
+/**
+ * SimConnect (host stand-in)
+ * --------------------------
+ * The subset of the SDK header the module compiles against: the receive
+ * structures it reads, the enums and flags it passes, and the calls it makes
+ * (implemented by host/src/HostSim.cpp). Values and packed layouts follow the
+ * SDK, so a trace captured in the sim replays unchanged.
+ */
+
+typedef DWORD SIMCONNECT_OBJECT_ID;
+typedef DWORD SIMCONNECT_CLIENT_EVENT_ID;
+typedef DWORD SIMCONNECT_NOTIFICATION_GROUP_ID;
+typedef DWORD SIMCONNECT_INPUT_GROUP_ID;
+typedef DWORD SIMCONNECT_DATA_DEFINITION_ID;
+typedef DWORD SIMCONNECT_DATA_REQUEST_ID;
+typedef DWORD SIMCONNECT_DATA_REQUEST_FLAG;
+typedef DWORD SIMCONNECT_DATA_SET_FLAG;
+
+#define SIMCONNECT_OBJECT_ID_USER 0
+#define SIMCONNECT_UNUSED ((DWORD)-1)
+#define SIMCONNECT_GROUP_PRIORITY_HIGHEST 1
+#define SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT 0x00000000
+#define SIMCONNECT_DATA_REQUEST_FLAG_CHANGED 0x00000001
+#define SIMCONNECT_DATA_REQUEST_FLAG_TAGGED 0x00000002
+#define SIMCONNECT_DATA_SET_FLAG_DEFAULT 0x00000000
+
+enum SIMCONNECT_RECV_ID
+{
+    SIMCONNECT_RECV_ID_NULL,
+    SIMCONNECT_RECV_ID_EXCEPTION,
+    SIMCONNECT_RECV_ID_OPEN,
+    SIMCONNECT_RECV_ID_QUIT,
+    SIMCONNECT_RECV_ID_EVENT,
+    SIMCONNECT_RECV_ID_EVENT_OBJECT_ADDREMOVE,
+    SIMCONNECT_RECV_ID_EVENT_FILENAME,
+    SIMCONNECT_RECV_ID_EVENT_FRAME,
+    SIMCONNECT_RECV_ID_SIMOBJECT_DATA,
+    SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE,
+    SIMCONNECT_RECV_ID_WEATHER_OBSERVATION,
+    SIMCONNECT_RECV_ID_CLOUD_STATE,
+    SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID
+};
+
+enum SIMCONNECT_DATATYPE
+{
+    SIMCONNECT_DATATYPE_INVALID,
+    SIMCONNECT_DATATYPE_INT32,
+    SIMCONNECT_DATATYPE_INT64,
+    SIMCONNECT_DATATYPE_FLOAT32,
+    SIMCONNECT_DATATYPE_FLOAT64
+};
+
+enum SIMCONNECT_PERIOD
+{
+    SIMCONNECT_PERIOD_NEVER,
+    SIMCONNECT_PERIOD_ONCE,
+    SIMCONNECT_PERIOD_VISUAL_FRAME,
+    SIMCONNECT_PERIOD_SIM_FRAME,
+    SIMCONNECT_PERIOD_SECOND
+};
+
+enum SIMCONNECT_STATE
+{
+    SIMCONNECT_STATE_OFF,
+    SIMCONNECT_STATE_ON
+};
+
+#pragma pack(push, 1)
+
+struct SIMCONNECT_RECV
+{
+    DWORD dwSize;
+    DWORD dwVersion;
+    DWORD dwID; // SIMCONNECT_RECV_ID
+};
+
+struct SIMCONNECT_RECV_EXCEPTION : SIMCONNECT_RECV
+{
+    DWORD dwException;
+    DWORD dwSendID;
+    DWORD dwIndex;
+};
+
+struct SIMCONNECT_RECV_EVENT : SIMCONNECT_RECV
+{
+    DWORD uGroupID;
+    DWORD uEventID;
+    DWORD dwData;
+};
+
+struct SIMCONNECT_RECV_EVENT_FILENAME : SIMCONNECT_RECV_EVENT
+{
+    char szFileName[MAX_PATH];
+    DWORD dwFlags;
+};
+
+struct SIMCONNECT_RECV_EVENT_FRAME : SIMCONNECT_RECV_EVENT
+{
+    float fFrameRate;
+    float fSimSpeed;
+};
+
+struct SIMCONNECT_RECV_SIMOBJECT_DATA : SIMCONNECT_RECV
+{
+    DWORD dwRequestID;
+    DWORD dwObjectID;
+    DWORD dwDefineID;
+    DWORD dwFlags;
+    DWORD dwentrynumber;
+    DWORD dwoutof;
+    DWORD dwDefineCount;
+    DWORD dwData; // first of dwDefineCount values
+};
+
+struct SIMCONNECT_RECV_ASSIGNED_OBJECT_ID : SIMCONNECT_RECV
+{
+    DWORD dwRequestID;
+    DWORD dwObjectID;
+};
+
+struct SIMCONNECT_DATA_INITPOSITION
+{
+    double Latitude;
+    double Longitude;
+    double Altitude;
+    double Pitch;
+    double Bank;
+    double Heading;
+    DWORD OnGround;
+    DWORD Airspeed;
+};
+
+#pragma pack(pop)
+
+typedef void (CALLBACK* DispatchProc)(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
+
+HRESULT SimConnect_Open(HANDLE* phSimConnect, const char* szName, void* hWnd, DWORD UserEventWin32, HANDLE hEventHandle, DWORD ConfigIndex);
+HRESULT SimConnect_Close(HANDLE hSimConnect);
+HRESULT SimConnect_CallDispatch(HANDLE hSimConnect, DispatchProc pfcnDispatch, void* pContext);
+HRESULT SimConnect_GetLastSentPacketID(HANDLE hSimConnect, DWORD* pdwError);
+
+HRESULT SimConnect_SubscribeToSystemEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* SystemEventName);
+HRESULT SimConnect_MapClientEventToSimEvent(HANDLE hSimConnect, SIMCONNECT_CLIENT_EVENT_ID EventID, const char* EventName = "");
+HRESULT SimConnect_MapInputEventToClientEvent(HANDLE hSimConnect, SIMCONNECT_INPUT_GROUP_ID GroupID, const char* szInputDefinition,
+    SIMCONNECT_CLIENT_EVENT_ID DownEventID, DWORD DownValue = 0, SIMCONNECT_CLIENT_EVENT_ID UpEventID = (SIMCONNECT_CLIENT_EVENT_ID)SIMCONNECT_UNUSED,
+    DWORD UpValue = 0, BOOL bMaskable = FALSE);
+HRESULT SimConnect_AddClientEventToNotificationGroup(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, SIMCONNECT_CLIENT_EVENT_ID EventID, BOOL bMaskable = FALSE);
+HRESULT SimConnect_SetNotificationGroupPriority(HANDLE hSimConnect, SIMCONNECT_NOTIFICATION_GROUP_ID GroupID, DWORD uPriority);
+HRESULT SimConnect_SetInputGroupState(HANDLE hSimConnect, SIMCONNECT_INPUT_GROUP_ID GroupID, DWORD dwState);
+
+HRESULT SimConnect_AddToDataDefinition(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, const char* DatumName, const char* UnitsName,
+    SIMCONNECT_DATATYPE DatumType = SIMCONNECT_DATATYPE_FLOAT64, float fEpsilon = 0, DWORD DatumID = SIMCONNECT_UNUSED);
+HRESULT SimConnect_RequestDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_REQUEST_ID RequestID, SIMCONNECT_DATA_DEFINITION_ID DefineID,
+    SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_PERIOD Period, SIMCONNECT_DATA_REQUEST_FLAG Flags = 0, DWORD origin = 0, DWORD interval = 0, DWORD limit = 0);
+HRESULT SimConnect_SetDataOnSimObject(HANDLE hSimConnect, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID,
+    SIMCONNECT_DATA_SET_FLAG Flags, DWORD ArrayCount, DWORD cbUnitSize, void* pDataSet);
+
+HRESULT SimConnect_AICreateSimulatedObject(HANDLE hSimConnect, const char* szContainerTitle, SIMCONNECT_DATA_INITPOSITION InitPos, SIMCONNECT_DATA_REQUEST_ID RequestID);
+HRESULT SimConnect_AIRemoveObject(HANDLE hSimConnect, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_REQUEST_ID RequestID);
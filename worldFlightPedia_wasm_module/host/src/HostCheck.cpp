@@ -0,0 +1,26 @@
+#include "host/HostCheck.h"
+#include <cstdio>
+
+// -----------------------------------------------------------------------------
+// Host test checks (see host/include/host/HostCheck.h)
+// -----------------------------------------------------------------------------
+
+static unsigned s_checks = 0;
+static unsigned s_failures = 0;
+
+bool HostCheck_Record(bool ok, const char* expression, const char* file, int line)
+{
+    s_checks++;
+    if (!ok)
+    {
+        s_failures++;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+    return ok;
+}
+
+int HostCheck_Finish(const char* testName)
+{
+    std::printf("%s: %u checks, %u failed\n", testName, s_checks, s_failures);
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,568 @@
+#include "host/HostSim.h"
+#include <MSFS/MSFS.h>
+#include <MSFS/MSFS_CommBus.h>
+#include <MSFS/Legacy/gauges.h>
+#include <SimConnect.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <vector>
+#include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "dispatch/DispatchTrace.h"
+
+// -----------------------------------------------------------------------------
+// Host stand-in for the MSFS SDK (see host/include/host/HostSim.h)
+// - One process hosts one module instance; everything is single threaded
+// - Queued messages live back to back in one byte buffer: an 8-byte header
+//   with the size, then the message padded to 8 bytes. A message is copied
+//   out before delivery, since delivering it may queue more
+// - Buffers are reserved up front or grow geometrically, so a warmed-up
+//   scenario does not allocate inside the stand-in
+// -----------------------------------------------------------------------------
+
+extern "C" void module_init(void);
+extern "C" void module_deinit(void);
+
+// Global operator new, counted
+static uint64_t s_allocations = 0;
+
+void* operator new(size_t size)
+{
+    s_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+        std::abort();
+    return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+static const DWORD FIRST_OBJECT_ID = 1000;
+static const size_t QUEUE_RESERVE_BYTES = 1 << 20;
+static const size_t OBJECTS_RESERVE = 1 << 20;
+static const size_t DELAYED_RESERVE = 1 << 12;
+static const size_t OUTPUT_RESERVE_BYTES = 8 << 20;
+static const size_t DATA_HEADER_BYTES = sizeof(SIMCONNECT_RECV_SIMOBJECT_DATA) - sizeof(DWORD); // up to dwData (packed)
+
+static int s_handle = 0; // its address is the connection handle
+static DispatchProc s_dispatch = nullptr;
+static DWORD s_lastPacketId = 0;
+
+static std::vector<unsigned char> s_queue;
+static size_t s_queueRead = 0;
+static size_t s_queueWrite = 0;
+static std::vector<unsigned char> s_delivering; // the message being delivered
+static std::vector<unsigned char> s_building;   // a frame message being assembled
+
+static DWORD s_nextObjectId = FIRST_OBJECT_ID;
+static std::vector<unsigned char> s_live; // per object id since FIRST_OBJECT_ID: 1 while live
+
+// ASSIGNED_OBJECT_ID held back by the create delay, in creation order
+struct DelayedAssignment
+{
+    uint64_t dueFrame;
+    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID assigned;
+};
+
+static std::vector<DelayedAssignment> s_delayed;
+static unsigned s_createDelayFrames = 0;
+static bool s_movesFail = false;
+static uint64_t s_frame = 0;
+
+// Data of the last SetDataOnSimObject
+static const size_t LAST_SET_MAX_BYTES = 64;
+static unsigned char s_lastSet[LAST_SET_MAX_BYTES];
+static size_t s_lastSetSize = 0;
+static DWORD s_lastSetDefine = 0;
+static DWORD s_lastSetObject = 0;
+static bool s_hasLastSet = false;
+
+static std::vector<std::string> s_lvarNames; // DEFINITION_LVAR_WATCH, in definition order
+static std::vector<double> s_lvarValues;
+static bool s_lvarsChanged = false;
+
+static AircraftState s_aircraft;
+static bool s_hasAircraft = false;
+static bool s_aircraftChanged = false;
+
+static FsCommBusCallback s_fromJs = nullptr;
+static std::string s_output;
+
+static uint64_t s_nowMs = 0;
+static HostSimCounters s_counters;
+
+static uint64_t HostClock()
+{
+    return s_nowMs;
+}
+
+static size_t Padded(size_t size)
+{
+    return (size + 7) & ~(size_t)7;
+}
+
+static bool IsLive(DWORD objectId)
+{
+    if (objectId < FIRST_OBJECT_ID)
+        return false;
+    size_t index = objectId - FIRST_OBJECT_ID;
+    return index < s_live.size() && s_live[index];
+}
+
+static int FindLVar(const char* name)
+{
+    for (size_t i = 0; i < s_lvarNames.size(); ++i)
+    {
+        if (s_lvarNames[i] == name)
+            return (int)i;
+    }
+    return -1;
+}
+
+// SIMOBJECT_DATA for a request, with 'size' bytes of data
+static void QueueData(DWORD requestId, DWORD defineId, const void* data, size_t size)
+{
+    size_t total = DATA_HEADER_BYTES + size;
+    if (s_building.size() < total)
+        s_building.resize(total);
+
+    SIMCONNECT_RECV_SIMOBJECT_DATA header;
+    std::memset(&header, 0, sizeof(header));
+    header.dwSize = (DWORD)total;
+    header.dwID = SIMCONNECT_RECV_ID_SIMOBJECT_DATA;
+    header.dwRequestID = requestId;
+    header.dwObjectID = SIMCONNECT_OBJECT_ID_USER;
+    header.dwDefineID = defineId;
+    header.dwFlags = SIMCONNECT_DATA_REQUEST_FLAG_CHANGED;
+    header.dwentrynumber = 1;
+    header.dwoutof = 1;
+    header.dwDefineCount = (DWORD)(size / sizeof(double));
+    std::memcpy(s_building.data(), &header, DATA_HEADER_BYTES);
+    std::memcpy(s_building.data() + DATA_HEADER_BYTES, data, size);
+    HostSim_Queue((const SIMCONNECT_RECV*)s_building.data(), total);
+}
+
+// -----------------------------------------------------------------------------
+// Scenario API
+// -----------------------------------------------------------------------------
+
+void HostSim_Init()
+{
+    s_queue.reserve(QUEUE_RESERVE_BYTES);
+    s_live.reserve(OBJECTS_RESERVE);
+    s_delayed.reserve(DELAYED_RESERVE);
+    s_output.reserve(OUTPUT_RESERVE_BYTES);
+    Scheduler_SetClock(HostClock);
+
+    module_init();
+    HostSim_Pump();
+}
+
+void HostSim_Deinit()
+{
+    module_deinit();
+
+    s_dispatch = nullptr;
+    s_fromJs = nullptr;
+    s_queueRead = s_queueWrite = 0;
+    s_nextObjectId = FIRST_OBJECT_ID;
+    s_live.clear();
+    s_delayed.clear();
+    s_createDelayFrames = 0;
+    s_movesFail = false;
+    s_hasLastSet = false;
+    s_lvarNames.clear();
+    s_lvarValues.clear();
+    s_lvarsChanged = false;
+    s_hasAircraft = false;
+    s_aircraftChanged = false;
+    s_output.clear();
+    std::memset(&s_counters, 0, sizeof(s_counters));
+}
+
+void HostSim_Frame()
+{
+    s_nowMs += HOSTSIM_FRAME_MS;
+    s_frame++;
+
+    size_t due = 0;
+    while (due < s_delayed.size() && s_delayed[due].dueFrame <= s_frame)
+        ++due;
+    for (size_t i = 0; i < due; ++i)
+        HostSim_Queue(&s_delayed[i].assigned, sizeof(s_delayed[i].assigned));
+    s_delayed.erase(s_delayed.begin(), s_delayed.begin() + due);
+
+    if (s_lvarsChanged && !s_lvarValues.empty())
+    {
+        QueueData(REQUEST_LVAR_WATCH, DEFINITION_LVAR_WATCH, s_lvarValues.data(), s_lvarValues.size() * sizeof(double));
+        s_lvarsChanged = false;
+    }
+    if (s_aircraftChanged)
+    {
+        QueueData(REQUEST_USER_STATE, DEFINITION_USER_STATE, &s_aircraft, offsetof(AircraftState, sampleMs));
+        s_aircraftChanged = false;
+    }
+
+    SIMCONNECT_RECV_EVENT_FRAME frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.dwSize = sizeof(frame);
+    frame.dwID = SIMCONNECT_RECV_ID_EVENT_FRAME;
+    frame.uEventID = EVENT_FRAME;
+    frame.fFrameRate = 1000.0f / HOSTSIM_FRAME_MS;
+    frame.fSimSpeed = 1.0f;
+    HostSim_Queue(&frame, sizeof(frame));
+
+    HostSim_Pump();
+}
+
+void HostSim_Frames(unsigned count)
+{
+    for (unsigned i = 0; i < count; ++i)
+        HostSim_Frame();
+}
+
+void HostSim_Pump()
+{
+    while (s_queueRead < s_queueWrite)
+    {
+        uint32_t size;
+        std::memcpy(&size, s_queue.data() + s_queueRead, sizeof(size));
+        if (s_delivering.size() < size)
+            s_delivering.resize(size);
+        std::memcpy(s_delivering.data(), s_queue.data() + s_queueRead + 8, size);
+        s_queueRead += 8 + Padded(size);
+
+        if (s_dispatch)
+        {
+            s_counters.dispatched++;
+            s_dispatch((SIMCONNECT_RECV*)s_delivering.data(), (DWORD)size, nullptr);
+        }
+    }
+    s_queueRead = s_queueWrite = 0;
+}
+
+void HostSim_Queue(const SIMCONNECT_RECV* message, size_t size)
+{
+    size_t end = s_queueWrite + 8 + Padded(size);
+    if (end > s_queue.size())
+        s_queue.resize(std::max(end, s_queue.size() * 2));
+
+    uint32_t size32 = (uint32_t)size;
+    std::memcpy(s_queue.data() + s_queueWrite, &size32, sizeof(size32));
+    std::memcpy(s_queue.data() + s_queueWrite + 8, message, size);
+    s_queueWrite = end;
+}
+
+void HostSim_Event(DWORD eventId, DWORD data)
+{
+    SIMCONNECT_RECV_EVENT event;
+    std::memset(&event, 0, sizeof(event));
+    event.dwSize = sizeof(event);
+    event.dwID = SIMCONNECT_RECV_ID_EVENT;
+    event.uGroupID = GROUP_INPUT;
+    event.uEventID = eventId;
+    event.dwData = data;
+    HostSim_Queue(&event, sizeof(event));
+}
+
+void HostSim_SetCreateDelay(unsigned frames)
+{
+    s_createDelayFrames = frames;
+}
+
+void HostSim_SetMovesFail(bool fail)
+{
+    s_movesFail = fail;
+}
+
+bool HostSim_LastSetData(DWORD* defineId, DWORD* objectId, void* data, size_t size)
+{
+    if (!s_hasLastSet)
+        return false;
+    *defineId = s_lastSetDefine;
+    *objectId = s_lastSetObject;
+    std::memcpy(data, s_lastSet, std::min(size, s_lastSetSize));
+    return true;
+}
+
+void HostSim_SetAircraft(const AircraftState& state)
+{
+    if (s_hasAircraft && std::memcmp(&s_aircraft, &state, offsetof(AircraftState, sampleMs)) == 0)
+        return;
+    s_aircraft = state;
+    s_hasAircraft = true;
+    s_aircraftChanged = true;
+}
+
+bool HostSim_SetLVar(const char* name, double value)
+{
+    int index = FindLVar(name);
+    if (index < 0)
+        return false;
+    if (s_lvarValues[index] != value)
+    {
+        s_lvarValues[index] = value;
+        s_lvarsChanged = true;
+    }
+    return true;
+}
+
+double HostSim_GetLVar(const char* name)
+{
+    int index = FindLVar(name);
+    return index < 0 ? 0.0 : s_lvarValues[index];
+}
+
+void HostSim_SendToModule(const char* message)
+{
+    HostSim_SendToModule(message, std::strlen(message));
+}
+
+void HostSim_SendToModule(const char* message, size_t size)
+{
+    if (s_fromJs)
+        s_fromJs(message, (unsigned int)size, nullptr);
+}
+
+const std::string& HostSim_Output()
+{
+    return s_output;
+}
+
+void HostSim_ClearOutput()
+{
+    s_output.clear();
+}
+
+uint64_t HostSim_NowMs()
+{
+    return s_nowMs;
+}
+
+HostSimCounters HostSim_GetCounters()
+{
+    return s_counters;
+}
+
+uint64_t HostSim_Allocations()
+{
+    return s_allocations;
+}
+
+double HostSim_CpuMs()
+{
+    return std::clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+// -----------------------------------------------------------------------------
+// SimConnect
+// -----------------------------------------------------------------------------
+
+HRESULT SimConnect_Open(HANDLE* phSimConnect, const char*, void*, DWORD, HANDLE, DWORD)
+{
+    *phSimConnect = &s_handle;
+    return S_OK;
+}
+
+HRESULT SimConnect_Close(HANDLE)
+{
+    return S_OK;
+}
+
+HRESULT SimConnect_CallDispatch(HANDLE, DispatchProc pfcnDispatch, void*)
+{
+    s_dispatch = pfcnDispatch;
+    return S_OK;
+}
+
+HRESULT SimConnect_GetLastSentPacketID(HANDLE, DWORD* pdwError)
+{
+    *pdwError = s_lastPacketId;
+    return S_OK;
+}
+
+HRESULT SimConnect_SubscribeToSystemEvent(HANDLE, SIMCONNECT_CLIENT_EVENT_ID, const char*)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_MapClientEventToSimEvent(HANDLE, SIMCONNECT_CLIENT_EVENT_ID, const char*)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_MapInputEventToClientEvent(HANDLE, SIMCONNECT_INPUT_GROUP_ID, const char*,
+    SIMCONNECT_CLIENT_EVENT_ID, DWORD, SIMCONNECT_CLIENT_EVENT_ID, DWORD, BOOL)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_AddClientEventToNotificationGroup(HANDLE, SIMCONNECT_NOTIFICATION_GROUP_ID, SIMCONNECT_CLIENT_EVENT_ID, BOOL)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_SetNotificationGroupPriority(HANDLE, SIMCONNECT_NOTIFICATION_GROUP_ID, DWORD)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_SetInputGroupState(HANDLE, SIMCONNECT_INPUT_GROUP_ID, DWORD)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_AddToDataDefinition(HANDLE, SIMCONNECT_DATA_DEFINITION_ID DefineID, const char* DatumName,
+    const char*, SIMCONNECT_DATATYPE, float, DWORD)
+{
+    s_lastPacketId++;
+    if (DefineID == DEFINITION_LVAR_WATCH)
+    {
+        s_lvarNames.push_back(DatumName);
+        s_lvarValues.push_back(0.0);
+    }
+    return S_OK;
+}
+
+HRESULT SimConnect_RequestDataOnSimObject(HANDLE, SIMCONNECT_DATA_REQUEST_ID, SIMCONNECT_DATA_DEFINITION_ID,
+    SIMCONNECT_OBJECT_ID, SIMCONNECT_PERIOD, SIMCONNECT_DATA_REQUEST_FLAG, DWORD, DWORD, DWORD)
+{
+    s_lastPacketId++;
+    return S_OK;
+}
+
+HRESULT SimConnect_SetDataOnSimObject(HANDLE, SIMCONNECT_DATA_DEFINITION_ID DefineID, SIMCONNECT_OBJECT_ID ObjectID,
+    SIMCONNECT_DATA_SET_FLAG, DWORD, DWORD cbUnitSize, void* pDataSet)
+{
+    s_lastPacketId++;
+    s_counters.moves++;
+    if (!IsLive(ObjectID))
+        s_counters.unknownObjects++;
+    if (s_movesFail)
+        return E_FAIL;
+
+    s_lastSetDefine = DefineID;
+    s_lastSetObject = ObjectID;
+    s_lastSetSize = std::min((size_t)cbUnitSize, LAST_SET_MAX_BYTES);
+    std::memcpy(s_lastSet, pDataSet, s_lastSetSize);
+    s_hasLastSet = true;
+    return S_OK;
+}
+
+HRESULT SimConnect_AICreateSimulatedObject(HANDLE, const char*, SIMCONNECT_DATA_INITPOSITION, SIMCONNECT_DATA_REQUEST_ID RequestID)
+{
+    s_lastPacketId++;
+    s_counters.creates++;
+    s_counters.liveObjects++;
+    s_live.push_back(1);
+
+    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID assigned;
+    std::memset(&assigned, 0, sizeof(assigned));
+    assigned.dwSize = sizeof(assigned);
+    assigned.dwID = SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID;
+    assigned.dwRequestID = RequestID;
+    assigned.dwObjectID = s_nextObjectId++;
+
+    // While a trace is replayed its own ASSIGNED_OBJECT_ID records answer the
+    // creates; a live one would reach the module after the replay ended
+    if (DispatchTrace_IsReplaying())
+        return S_OK;
+    if (s_createDelayFrames == 0)
+    {
+        HostSim_Queue(&assigned, sizeof(assigned));
+        return S_OK;
+    }
+    DelayedAssignment delayed;
+    delayed.dueFrame = s_frame + s_createDelayFrames;
+    delayed.assigned = assigned;
+    s_delayed.push_back(delayed);
+    return S_OK;
+}
+
+HRESULT SimConnect_AIRemoveObject(HANDLE, SIMCONNECT_OBJECT_ID ObjectID, SIMCONNECT_DATA_REQUEST_ID)
+{
+    s_lastPacketId++;
+    s_counters.removes++;
+    if (!IsLive(ObjectID))
+    {
+        s_counters.unknownObjects++;
+        return S_OK;
+    }
+    s_live[ObjectID - FIRST_OBJECT_ID] = 0;
+    s_counters.liveObjects--;
+    return S_OK;
+}
+
+// -----------------------------------------------------------------------------
+// CommBus
+// -----------------------------------------------------------------------------
+
+bool fsCommBusCall(const char*, const char* buf, unsigned int bufSize, FsCommBusBroadcastFlags)
+{
+    s_counters.toJsCalls++;
+    s_counters.toJsBytes += bufSize;
+    s_output.append(buf, bufSize);
+    s_output.push_back('\n');
+    return true;
+}
+
+bool fsCommBusRegister(const char* name, FsCommBusCallback callback, void*)
+{
+    if (std::strcmp(name, "OnMessageFromJs") == 0)
+        s_fromJs = callback;
+    return true;
+}
+
+int fsCommBusUnregister(const char* name, FsCommBusCallback)
+{
+    if (std::strcmp(name, "OnMessageFromJs") == 0)
+        s_fromJs = nullptr;
+    return 0;
+}
+
+int fsCommBusUnregisterAll()
+{
+    s_fromJs = nullptr;
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Gauges: "<value> (>L:NAME)" writes a watched L:Var, anything else is ignored
+// -----------------------------------------------------------------------------
+
+bool execute_calculator_code(PCSTRINGZ code, FLOAT64* fvalue, SINT32* ivalue, PCSTRINGZ* svalue)
+{
+    s_counters.calculatorCalls++;
+    if (fvalue) *fvalue = 0.0;
+    if (ivalue) *ivalue = 0;
+    if (svalue) *svalue = "";
+
+    char* end = nullptr;
+    double value = std::strtod(code, &end);
+    if (end == code || std::strncmp(end, " (>", 3) != 0)
+        return true;
+
+    const char* name = end + 3;
+    const char* close = std::strchr(name, ')');
+    if (!close)
+        return true;
+
+    char lvar[128];
+    size_t length = std::min((size_t)(close - name), sizeof(lvar) - 1);
+    std::memcpy(lvar, name, length);
+    lvar[length] = '\0';
+    HostSim_SetLVar(lvar, value);
+    return true;
+}
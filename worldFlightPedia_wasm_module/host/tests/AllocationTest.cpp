@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Steady-state allocations
+// One round of marker traffic: the POI list re-sent with moved POIs
+// (ApplyStagedPois -> ReconcilePoi), POI_UPDATE / POI_REMOVE / POI_ADD,
+// MARKER_STREAMING and SPAWN_QUEUE changes, and a flight across the grid in
+// show-all mode so POIs stream in and out. After a few warm-up rounds every
+// container has grown to the working set, and a further round must not
+// allocate.
+// Usage: wfp_allocation_test [rounds] (default 3 warm-up rounds)
+// -----------------------------------------------------------------------------
+
+static const int kGridSide = 20; // POIs per row and column, 0.01 deg apart
+static const double kBaseLat = 40.0;
+static const double kBaseLon = -74.0;
+
+// shift moves every seventh POI 0.002 deg north
+static std::string PoiList(double shift)
+{
+    std::string message = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < kGridSide * kGridSide; ++i)
+    {
+        char poi[96];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.6f,\"lon\":%.6f}", i ? "," : "", i + 1,
+            kBaseLat + (i % kGridSide) * 0.01 + (i % 7 == 0 ? shift : 0.0), kBaseLon + (i / kGridSide) * 0.01);
+        message += poi;
+    }
+    message += "]}";
+    return message;
+}
+
+// Literals go through the const char* overload: a std::string temporary would
+// count against the round
+static void Send(const char* message)
+{
+    HostSim_SendToModule(message);
+    HostSim_Frame();
+}
+
+static void Send(const std::string& message)
+{
+    HostSim_SendToModule(message.data(), message.size());
+    HostSim_Frame();
+}
+
+static void Round(const std::string* lists, AircraftState* aircraft)
+{
+    HostSim_ClearOutput();
+    Send(lists[0]);
+    Send(lists[1]);
+    Send("{\"type\":\"POI_UPDATE\",\"data\":[{\"id\":3,\"lat\":40.025,\"lon\":-74.0}]}");
+    Send("{\"type\":\"POI_UPDATE\",\"data\":[{\"id\":3,\"lat\":40.02,\"lon\":-74.0}]}");
+    Send("{\"type\":\"POI_REMOVE\",\"data\":[{\"id\":9}]}");
+    Send("{\"type\":\"POI_ADD\",\"data\":[{\"id\":9,\"lat\":40.08,\"lon\":-74.0}]}");
+    Send("{\"type\":\"SPAWN_QUEUE\",\"perFrame\":2,\"maxInFlight\":4}");
+    Send("{\"type\":\"MARKER_STREAMING\",\"radius\":2500,\"budget\":24}");
+
+    // Diagonally across the grid and back, slow enough for the streaming interval
+    for (int step = 0; step <= 2 * kGridSide; ++step)
+    {
+        int along = step <= kGridSide ? step : 2 * kGridSide - step;
+        aircraft->latDeg = kBaseLat + along * 0.01;
+        aircraft->lonDeg = kBaseLon + along * 0.01;
+        HostSim_SetAircraft(*aircraft);
+        HostSim_Frames(MARKER_STREAM_INTERVAL_MS / HOSTSIM_FRAME_MS + 1);
+    }
+
+    Send("{\"type\":\"MARKER_STREAMING\",\"radius\":1500,\"budget\":16}");
+    Send("{\"type\":\"SPAWN_QUEUE\",\"perFrame\":4,\"maxInFlight\":16}");
+    HostSim_Frames(30); // drain the spawn queue
+}
+
+int main(int argc, char** argv)
+{
+    int warmup = argc > 1 ? std::atoi(argv[1]) : 3;
+
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    AircraftState aircraft = {};
+    aircraft.latDeg = kBaseLat;
+    aircraft.lonDeg = kBaseLon;
+    aircraft.altMeters = 500.0;
+    aircraft.altAboveGroundMeters = 300.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+
+    const std::string lists[2] = { PoiList(0.002), PoiList(0.0) };
+    Send(lists[1]);
+    HostSim_Event(EVENT_TRIGGER_M); // show all, streamed
+    HostSim_Frames(30);
+    HOST_CHECK(HostSim_GetCounters().liveObjects > 0);
+
+    for (int i = 0; i < warmup; ++i)
+        Round(lists, &aircraft);
+
+    HostSimCounters before = HostSim_GetCounters();
+    uint64_t allocations = HostSim_Allocations();
+    Round(lists, &aircraft);
+    allocations = HostSim_Allocations() - allocations;
+    HostSimCounters after = HostSim_GetCounters();
+
+    std::printf("allocation test: %llu allocations, %llu creates, %llu removes, %llu moves in the steady round\n",
+        (unsigned long long)allocations,
+        (unsigned long long)(after.creates - before.creates),
+        (unsigned long long)(after.removes - before.removes),
+        (unsigned long long)(after.moves - before.moves));
+    HOST_CHECK(allocations == 0);
+    HOST_CHECK(after.creates + after.moves > before.creates + before.moves); // markers did stream
+    HOST_CHECK(after.unknownObjects == 0);
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    return HostCheck_Finish("allocation test");
+}
@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Geofence arrival: entering a POI's fence (500 m) only reports ENTER; the
+// flight advances once the aircraft is within the arrival radius (200 m).
+// POIs lie on a meridian 0.01 deg (~1.1 km) apart, north of the aircraft.
+// -----------------------------------------------------------------------------
+
+static const double kFirstLat = 47.0;
+static const double kLon = 8.0;
+static const double kMetersPerDegLat = 111195.0;
+
+static void FlyTo(AircraftState* aircraft, double metersSouthOfFirst)
+{
+    aircraft->latDeg = kFirstLat - metersSouthOfFirst / kMetersPerDegLat;
+    HostSim_SetAircraft(*aircraft);
+    HostSim_Frames(2);
+}
+
+static bool Sent(const char* text)
+{
+    return HostSim_Output().find(text) != std::string::npos;
+}
+
+int main()
+{
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    AircraftState aircraft = {};
+    aircraft.lonDeg = kLon;
+    aircraft.altMeters = 600.0;
+    aircraft.altAboveGroundMeters = 300.0;
+    FlyTo(&aircraft, 2000.0);
+
+    HostSim_ClearOutput();
+    HostSim_SendToModule("{\"type\":\"GEOFENCE\"}");
+    HostSim_Frame();
+    HOST_CHECK(Sent("ack: GEOFENCE enabled=1 radius=500 exitRadius=800 arrivalRadius=200 lookahead=3"));
+
+    HostSim_SendToModule("{\"type\":\"POI_COORDINATES\",\"data\":["
+        "{\"id\":1,\"lat\":47.00,\"lon\":8.0},{\"id\":2,\"lat\":47.01,\"lon\":8.0},{\"id\":3,\"lat\":47.02,\"lon\":8.0}]}");
+    HostSim_SetLVar("L:WFP_StartFlight", 1.0);
+    HostSim_Frames(5);
+
+    // Inside the fence, short of the POI: ENTER only
+    HostSim_ClearOutput();
+    FlyTo(&aircraft, 400.0);
+    HOST_CHECK(Sent("{\"type\":\"GEOFENCE\",\"event\":\"ENTER\",\"id\":1,\"index\":0"));
+    HOST_CHECK(!Sent("POI_ARRIVED"));
+
+    FlyTo(&aircraft, 250.0);
+    HOST_CHECK(!Sent("POI_ARRIVED"));
+
+    // Within the arrival radius: one advance to POI[1]
+    FlyTo(&aircraft, 150.0);
+    HOST_CHECK(Sent("{\"type\":\"POI_ARRIVED\",\"id\":1,\"index\":0,\"active\":1}"));
+
+    HostSim_ClearOutput();
+    FlyTo(&aircraft, 0.0);
+    HOST_CHECK(!Sent("POI_ARRIVED"));
+
+    // The arrival radius is capped at the fence radius
+    HostSim_ClearOutput();
+    HostSim_SendToModule("{\"type\":\"GEOFENCE\",\"radius\":300,\"arrivalRadius\":450}");
+    HostSim_Frame();
+    HOST_CHECK(Sent("radius=300 exitRadius=800 arrivalRadius=300"));
+
+    // A huge lookahead is capped and the window stays inside the tour
+    HostSim_ClearOutput();
+    HostSim_SendToModule("{\"type\":\"GEOFENCE\",\"lookahead\":3000000000}");
+    HostSim_Frame();
+    HOST_CHECK(Sent("lookahead=64"));
+    FlyTo(&aircraft, -1000.0);
+    HOST_CHECK(Sent("{\"type\":\"POI_ARRIVED\",\"id\":2,\"index\":1,\"active\":2}"));
+
+    HostSimCounters counters = HostSim_GetCounters();
+    HOST_CHECK(counters.unknownObjects == 0);
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    return HostCheck_Finish("geofence test");
+}
@@ -0,0 +1,133 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Load test: one scripted session through the host stand-in
+//   upload N POIs, start the flight, advance 1000 times, spawn all (M),
+//   remove all (N), 1000 idle frames
+// Each phase prints its CPU time, allocations, SimConnect object calls and
+// WASM -> JS traffic. Usage: wfp_load_test [poiCount] (default 100000)
+// -----------------------------------------------------------------------------
+
+struct Phase
+{
+    const char* name;
+    double cpuMs;
+    uint64_t allocations;
+    HostSimCounters counters;
+};
+
+static void BeginPhase(Phase* phase, const char* name)
+{
+    phase->name = name;
+    phase->cpuMs = HostSim_CpuMs();
+    phase->allocations = HostSim_Allocations();
+    phase->counters = HostSim_GetCounters();
+}
+
+static void EndPhase(const Phase& phase)
+{
+    HostSimCounters now = HostSim_GetCounters();
+    std::printf("%-18s %9.2f ms cpu %9llu allocs %7llu creates %7llu removes %7llu moves %6llu calls %9llu bytes\n",
+        phase.name, HostSim_CpuMs() - phase.cpuMs,
+        (unsigned long long)(HostSim_Allocations() - phase.allocations),
+        (unsigned long long)(now.creates - phase.counters.creates),
+        (unsigned long long)(now.removes - phase.counters.removes),
+        (unsigned long long)(now.moves - phase.counters.moves),
+        (unsigned long long)(now.toJsCalls - phase.counters.toJsCalls),
+        (unsigned long long)(now.toJsBytes - phase.counters.toJsBytes));
+}
+
+static std::string PoiList(int count)
+{
+    std::string message = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < count; ++i)
+    {
+        char poi[96];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.6f,\"lon\":%.6f}",
+            i ? "," : "", i, 40.0 + (i % 1000) * 0.01, -74.0 + (i / 1000) * 0.01);
+        message += poi;
+    }
+    message += "]}";
+    return message;
+}
+
+int main(int argc, char** argv)
+{
+    int poiCount = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::printf("load test: %d POIs\n", poiCount);
+
+    AircraftState aircraft = {};
+    aircraft.latDeg = 40.0;
+    aircraft.lonDeg = -74.0;
+    aircraft.altMeters = 500.0;
+    aircraft.altAboveGroundMeters = 300.0;
+
+    Phase phase;
+    BeginPhase(&phase, "init");
+    HostSim_Init();
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+    EndPhase(phase);
+    HOST_CHECK(HostSim_Output().find("WASM ready") != std::string::npos);
+
+    std::string pois = PoiList(poiCount);
+    HostSim_ClearOutput();
+    BeginPhase(&phase, "upload");
+    HostSim_SendToModule(pois.data(), pois.size());
+    HostSim_Frame();
+    EndPhase(phase);
+    HOST_CHECK(HostSim_Output().find("ack: POI_COORDINATES") != std::string::npos);
+
+    BeginPhase(&phase, "start flight");
+    HostSim_SetLVar("L:WFP_StartFlight", 1.0);
+    HostSim_Frames(10);
+    EndPhase(phase);
+    HOST_CHECK(HostSim_GetCounters().liveObjects > 0);
+
+    BeginPhase(&phase, "advance x1000");
+    for (int i = 0; i < 1000; ++i)
+    {
+        HostSim_SetLVar("L:WFP_NextPoi", 1.0);
+        HostSim_Frame();
+        HostSim_SetLVar("L:WFP_NextPoi", 0.0);
+        HostSim_Frame();
+    }
+    EndPhase(phase);
+
+    BeginPhase(&phase, "spawn all (M)");
+    HostSim_Event(EVENT_TRIGGER_M);
+    for (int i = 0; i < 200; ++i)
+    {
+        aircraft.latDeg = 40.0 + i * 0.01;
+        HostSim_SetAircraft(aircraft);
+        HostSim_Frame();
+    }
+    EndPhase(phase);
+
+    BeginPhase(&phase, "remove all (N)");
+    HostSim_Event(EVENT_TRIGGER_N);
+    HostSim_Frame();
+    EndPhase(phase);
+
+    BeginPhase(&phase, "1000 idle frames");
+    HostSim_Frames(1000);
+    EndPhase(phase);
+
+    HostSimCounters counters = HostSim_GetCounters();
+    HOST_CHECK(counters.unknownObjects == 0);
+    HOST_CHECK(counters.creates > 0);
+
+    HostSim_ClearOutput();
+    HostSim_SendToModule("{\"type\":\"METRICS\",\"requestId\":1}");
+    HostSim_Frame();
+    HOST_CHECK(HostSim_Output().find("\"type\":\"METRICS\"") != std::string::npos);
+    std::printf("%.600s\n", HostSim_Output().c_str());
+
+    HostSim_Deinit();
+    return HostCheck_Finish("load test");
+}
@@ -0,0 +1,82 @@
+#include <cstdio>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+#include "core/ModuleContext.h"
+#include "simobjects/SimObjectManager.h"
+
+// -----------------------------------------------------------------------------
+// Marker pool: queued markers that cannot take a pooled object
+// Show-all with one create in flight and slow answers keeps markers queued.
+// A POI is removed while moves fail, so its object goes to the pool and the
+// next frame's claim of it fails; the claiming marker must be queued again
+// and every marker must end up live once the queue drains.
+// -----------------------------------------------------------------------------
+
+static const int kPois = 12;
+
+static void Send(const char* message)
+{
+    HostSim_SendToModule(message);
+    HostSim_Frame();
+}
+
+static int CountMarkers(eMarkerState state)
+{
+    int count = 0;
+    for (size_t i = 0; i < g_poi_ids.size(); ++i)
+        if (SimObjectManager_GetMarkerState(g_poi_ids[i]) == state)
+            ++count;
+    return count;
+}
+
+int main()
+{
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    AircraftState aircraft = {};
+    aircraft.latDeg = 47.0;
+    aircraft.lonDeg = 8.0;
+    aircraft.altMeters = 600.0;
+    aircraft.altAboveGroundMeters = 300.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+
+    std::string pois = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < kPois; ++i)
+    {
+        char poi[64];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.3f,\"lon\":8.0}", i ? "," : "", i + 1, 47.0 + i * 0.001);
+        pois += poi;
+    }
+    pois += "]}";
+    HostSim_SendToModule(pois.data(), pois.size());
+    Send("{\"type\":\"SPAWN_QUEUE\",\"perFrame\":1,\"maxInFlight\":1}");
+
+    // Two markers live, the others queued behind slow creates
+    HostSim_SetCreateDelay(10);
+    HostSim_Event(EVENT_TRIGGER_M);
+    for (unsigned i = 0; i < 200 && CountMarkers(MARKER_LIVE) < 2; ++i)
+        HostSim_Frame();
+    HOST_CHECK(CountMarkers(MARKER_LIVE) >= 2);
+    HOST_CHECK(CountMarkers(MARKER_QUEUED) > 0);
+
+    // The removed POI's object is pooled; claiming it fails
+    HostSim_SetMovesFail(true);
+    Send("{\"type\":\"POI_REMOVE\",\"data\":[{\"id\":1}]}");
+    HostSim_Frames(2);
+    HostSim_SetMovesFail(false);
+
+    HostSim_Frames(40 * kPois);
+    HOST_CHECK(CountMarkers(MARKER_QUEUED) == 0);
+    HOST_CHECK(CountMarkers(MARKER_LIVE) == kPois - 1);
+
+    HostSimCounters counters = HostSim_GetCounters();
+    HOST_CHECK(counters.unknownObjects == 0);
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    return HostCheck_Finish("marker pool test");
+}
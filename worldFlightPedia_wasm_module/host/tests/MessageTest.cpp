@@ -0,0 +1,162 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+#include "core/ModuleContext.h"
+#include "comm/MessageParser.h"
+#include "comm/PoiWireFormat.h"
+
+// -----------------------------------------------------------------------------
+// Message corpus through the module
+// Each file is sent to OnMessageFromJS and must be answered as its name says:
+// "OK-*" without a parse or parameter nack, "<ERROR>-*" with
+// "nack: <ERROR> rx=.. offset=..". That covers the parser and the handler of
+// the message type, which reads and checks its own parameters.
+// TRACE / TRACE_REPLAY files are left out: they would replace the trace file
+// of the trace_capture / trace_replay tests. The binary (WFP1) cases are built
+// here and named the same way; a rejected one must leave the POI list as is.
+// Usage: wfp_message_test corpus files...
+// -----------------------------------------------------------------------------
+
+static bool ReadFile(const char* path, std::string* out)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    out->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Expected error: the file name up to the first '-'
+static std::string ExpectedError(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    return name.substr(0, name.find('-'));
+}
+
+// Error of the parse / parameter nack in the output, "OK" without one
+static std::string NackedError()
+{
+    const std::string& output = HostSim_Output();
+    for (size_t at = output.find("nack: "); at != std::string::npos; at = output.find("nack: ", at + 1))
+    {
+        size_t nameEnd = output.find(' ', at + 6);
+        size_t lineEnd = output.find('\n', at);
+        size_t offset = output.find(" offset=", at);
+        if (nameEnd != std::string::npos && offset != std::string::npos && offset < lineEnd)
+            return output.substr(at + 6, nameEnd - at - 6);
+    }
+    return "OK";
+}
+
+struct BinaryCase
+{
+    const char* name;
+    double lat[2];
+    double lon[2];
+};
+
+// POI_WIRE_TYPE_COORDINATES frame with two POIs, no ids
+static std::string BinaryFrame(const BinaryCase& c)
+{
+    PoiWireHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = POI_WIRE_MAGIC;
+    header.version = POI_WIRE_VERSION;
+    header.type = POI_WIRE_TYPE_COORDINATES;
+    header.count = 2;
+    header.headerSize = sizeof(PoiWireHeader);
+
+    std::string frame(reinterpret_cast<const char*>(&header), sizeof(header));
+    frame.append(reinterpret_cast<const char*>(c.lat), sizeof(c.lat));
+    frame.append(reinterpret_cast<const char*>(c.lon), sizeof(c.lon));
+    return frame;
+}
+
+static bool IsTraceMessage(const std::string& body)
+{
+    PoiParseResult result = ParsePoiMessage(body.data(), body.size(), nullptr, nullptr);
+    return result.type == POI_MSG_TRACE || result.type == POI_MSG_TRACE_REPLAY;
+}
+
+int main(int argc, char** argv)
+{
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    AircraftState aircraft = {};
+    aircraft.latDeg = 47.0;
+    aircraft.lonDeg = 8.0;
+    aircraft.altMeters = 600.0;
+    aircraft.altAboveGroundMeters = 300.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+
+    unsigned sent = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string body;
+        if (!HOST_CHECK(ReadFile(argv[i], &body)) || IsTraceMessage(body))
+            continue;
+
+        HostSim_ClearOutput();
+        HostSim_SendToModule(body.data(), body.size());
+        HostSim_Frame();
+        ++sent;
+
+        std::string expected = ExpectedError(argv[i]);
+        std::string got = NackedError();
+        if (expected != got)
+        {
+            std::printf("%s: expected %s, got %s\n%s\n", argv[i], expected.c_str(), got.c_str(),
+                HostSim_Output().c_str());
+            HOST_CHECK(false);
+        }
+    }
+    HOST_CHECK(sent > 0);
+
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const BinaryCase kBinaryCases[] = {
+        { "OK-binary_coordinates", { 47.0, 47.1 }, { 8.0, 8.1 } },
+        { "OUT_OF_RANGE-binary_lat_nan", { 47.0, nan }, { 8.0, 8.1 } },
+        { "OUT_OF_RANGE-binary_lat_1e300", { 1e300, 47.1 }, { 8.0, 8.1 } },
+        { "OUT_OF_RANGE-binary_lat_91", { 47.0, 91.0 }, { 8.0, 8.1 } },
+        { "OUT_OF_RANGE-binary_lon_inf", { 47.0, 47.1 }, { 8.0, -inf } },
+    };
+    for (const BinaryCase& c : kBinaryCases)
+    {
+        std::string frame = BinaryFrame(c);
+        size_t poisBefore = g_poi_coords.size();
+        HostSim_ClearOutput();
+        HostSim_SendToModule(frame.data(), frame.size());
+        HostSim_Frame();
+        ++sent;
+
+        std::string expected = ExpectedError(c.name);
+        std::string got = NackedError();
+        if (expected != got)
+        {
+            std::printf("%s: expected %s, got %s\n%s\n", c.name, expected.c_str(), got.c_str(),
+                HostSim_Output().c_str());
+            HOST_CHECK(false);
+        }
+        if (expected != "OK")
+            HOST_CHECK(g_poi_coords.size() == poisBefore);
+    }
+
+    HostSimCounters counters = HostSim_GetCounters();
+    HOST_CHECK(counters.unknownObjects == 0);
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    std::printf("message test: %u messages\n", sent);
+    return HostCheck_Finish("message test");
+}
@@ -0,0 +1,311 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "host/HostCheck.h"
+#include "comm/MessageParser.h"
+#include "comm/JsonTokenizer.h"
+
+// -----------------------------------------------------------------------------
+// Parser fuzz test
+// Every corpus file is parsed and must give the error its name starts with
+// ("OK-poi_list.json", "OUT_OF_RANGE-negative_id.json"). Then random mutations
+// of the corpus (byte flips, inserted tokens, deleted / duplicated ranges,
+// truncation, splices) are parsed and checked for the parser's invariants:
+// records stay in range and inside the buffer, errors point into the buffer.
+// Accepted mutations also go through the parameter readers (Param_*).
+// Mutated inputs are copied into exactly-sized buffers, so a build with
+// WFP_HOST_SANITIZE=ON reports reads past the end and undefined conversions.
+// Files after --mutate-only only seed mutations: their names give the error of
+// the whole message, including its handler (see MessageTest.cpp).
+// Usage: wfp_parser_fuzz [--iterations N] [--seed S] corpus files...
+//        [--mutate-only files...]
+// -----------------------------------------------------------------------------
+
+struct Seed
+{
+    std::string name;
+    std::string body;
+    bool checked; // the name gives the expected parse error
+};
+
+// Owns the parsed copy: the result's params point into it
+struct FuzzInput
+{
+    std::vector<char> buffer;
+    const char* begin;
+    size_t size;
+    uint32_t records;
+};
+
+static uint64_t s_rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t Random(uint32_t bound)
+{
+    // xorshift64*: fixed seed, so a failing iteration reproduces
+    s_rng ^= s_rng >> 12;
+    s_rng ^= s_rng << 25;
+    s_rng ^= s_rng >> 27;
+    return bound ? (uint32_t)((s_rng * 2685821657736338717ull) >> 32) % bound : 0;
+}
+
+static const char* const kTokens[] = {
+    "{", "}", "[", "]", ":", ",", "\"", "\\", "\\u00", "-", "0", "1e999", "-1", "1.5",
+    "4294967295", "4294967296", "1e300", "-0", "true", "false", "null", "\"id\":", "\"lat\":",
+    "\"lon\":", "\"data\":[", "\"type\":\"POI_ADD\"", "\"requestId\":", "\"upload\":", "\"count\":",
+    "\"enabled\":", "\"radius\":", "\"k\":"
+};
+
+static void Mutate(std::string& s, const std::vector<Seed>& corpus)
+{
+    unsigned steps = 1 + Random(4);
+    for (unsigned i = 0; i < steps; ++i)
+    {
+        size_t at = s.empty() ? 0 : Random((uint32_t)s.size());
+        switch (Random(6))
+        {
+        case 0:
+            if (!s.empty())
+                s[at] = (char)(s[at] ^ (1 << Random(8)));
+            break;
+        case 1:
+            s.insert(at, kTokens[Random(sizeof(kTokens) / sizeof(kTokens[0]))]);
+            break;
+        case 2:
+            s.erase(at, 1 + Random(16));
+            break;
+        case 3:
+            s.insert(at, s.substr(at, 1 + Random(32)));
+            break;
+        case 4:
+            s.resize(at);
+            break;
+        default:
+        {
+            const std::string& other = corpus[Random((uint32_t)corpus.size())].body;
+            size_t from = Random((uint32_t)other.size());
+            s = s.substr(0, at) + other.substr(from);
+            break;
+        }
+        }
+    }
+}
+
+static bool Inside(const FuzzInput& in, const char* text, size_t length)
+{
+    return text >= in.begin && length <= in.size && text <= in.begin + (in.size - length);
+}
+
+static void CheckRecord(const PoiRecord& poi, void* ctx)
+{
+    FuzzInput& in = *static_cast<FuzzInput*>(ctx);
+    ++in.records;
+
+    if (poi.fields & POI_FIELD_LAT)
+        HOST_CHECK(poi.lat >= -90.0 && poi.lat <= 90.0 && (poi.fields & POI_FIELD_LON));
+    if (poi.fields & POI_FIELD_LON)
+        HOST_CHECK(poi.lon >= -180.0 && poi.lon <= 180.0);
+    HOST_CHECK(std::isfinite(poi.elevation));
+    if (poi.fields & POI_FIELD_NAME)
+        HOST_CHECK(Inside(in, poi.name, poi.nameLength));
+    if (poi.fields & POI_FIELD_CATEGORY)
+        HOST_CHECK(Inside(in, poi.category, poi.categoryLength));
+}
+
+static PoiParseResult Parse(const std::string& message, FuzzInput* in)
+{
+    // Exactly sized copy, no terminating NUL (the CommBus buffer has none either)
+    in->buffer.assign(message.begin(), message.end());
+    in->begin = in->buffer.data();
+    in->size = in->buffer.size();
+    in->records = 0;
+    return ParsePoiMessage(in->buffer.data(), in->buffer.size(), CheckRecord, in);
+}
+
+static void CheckResult(const PoiParseResult& result, const FuzzInput& in)
+{
+    HOST_CHECK(result.error >= POI_PARSE_OK && result.error <= POI_PARSE_ERR_TOO_MANY_PARAMS);
+    HOST_CHECK(result.offset <= in.size);
+    HOST_CHECK(result.count == in.records);
+    HOST_CHECK((result.error == POI_PARSE_ERR_JSON) == (result.jsonError != JSON_ERR_NONE));
+    if (result.error == POI_PARSE_OK)
+    {
+        HOST_CHECK(result.type != POI_MSG_UNKNOWN);
+        HOST_CHECK(result.entry == -1);
+        HOST_CHECK(result.params.count <= POI_MAX_MESSAGE_PARAMS && result.params.end <= in.size);
+        for (size_t i = 0; i < result.params.count; ++i)
+        {
+            const PoiMessageParam& param = result.params.items[i];
+            HOST_CHECK(param.key.type == JSON_TOK_STRING && Inside(in, param.key.text, param.key.length));
+            if (param.value.type == JSON_TOK_STRING)
+                HOST_CHECK(Inside(in, param.value.text, param.value.length));
+        }
+    }
+}
+
+// Reads the parameters the handlers read; an error must stay a parameter error
+static void ReadParams(PoiParseResult result, const FuzzInput& in)
+{
+    bool flag;
+    double value;
+    uint32_t number;
+    Param_Bool(result, "enabled", &flag);
+    Param_DoubleIn(result, "lat", -90.0, 90.0, &value);
+    Param_Double(result, "radius", &value);
+    Param_Count(result, "k", 1, &number);
+    Param_Id(result, "requestId", &number);
+    Param_Require(result, Param_Id(result, "upload", &number));
+
+    HOST_CHECK(result.error == POI_PARSE_OK || result.error == POI_PARSE_ERR_FIELD_TYPE
+        || result.error == POI_PARSE_ERR_OUT_OF_RANGE || result.error == POI_PARSE_ERR_MISSING_PARAM);
+    HOST_CHECK(result.offset <= in.size);
+    HOST_CHECK(result.entry == -1);
+}
+
+static bool ReadFile(const char* path, std::string* out)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    out->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Expected error: the file name up to the first '-'
+static std::string ExpectedError(const std::string& path)
+{
+    size_t slash = path.find_last_of("/\\");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    return name.substr(0, name.find('-'));
+}
+
+// Parameter readers: clamping, repeated and null keys, the first error kept
+static void CheckParams()
+{
+    FuzzInput in;
+    uint32_t k = 0;
+    uint32_t requestId = 0;
+    PoiParseResult r = Parse("{\"type\":\"POI_QUERY_NEAREST\",\"lat\":0,\"lon\":0,\"k\":1e12,\"requestId\":4294967295}", &in);
+    HOST_CHECK(r.error == POI_PARSE_OK && Param_Count(r, "k", 1, &k) && k == 4294967295u);
+    HOST_CHECK(Param_Id(r, "requestId", &requestId) && requestId == 4294967295u);
+
+    r = Parse("{\"type\":\"POI_QUERY_NEAREST\",\"lat\":0,\"lon\":0,\"k\":-7}", &in);
+    HOST_CHECK(r.error == POI_PARSE_OK && Param_Count(r, "k", 1, &k) && k == 1);
+
+    uint32_t perFrame = 0;
+    uint32_t maxInFlight = 0;
+    r = Parse("{\"type\":\"SPAWN_QUEUE\",\"perFrame\":2.9,\"maxInFlight\":0}", &in);
+    HOST_CHECK(Param_Count(r, "perFrame", 1, &perFrame) && perFrame == 2);
+    HOST_CHECK(Param_Count(r, "maxInFlight", 1, &maxInFlight) && maxInFlight == 1);
+
+    uint32_t total = 0;
+    uint32_t chunkSize = 7;
+    r = Parse("{\"type\":\"POI_UPLOAD_BEGIN\",\"upload\":1,\"total\":5e9,\"chunkSize\":-1,\"checksum\":0}", &in);
+    HOST_CHECK(Param_Count(r, "total", 0, &total) && total == 4294967295u);
+    HOST_CHECK(Param_Count(r, "chunkSize", 0, &chunkSize) && chunkSize == 0);
+
+    r = Parse("{\"type\":\"POI_ADD\",\"data\":[{\"id\":\"4294967296\",\"lat\":0,\"lon\":0}]}", &in);
+    HOST_CHECK(r.error == POI_PARSE_OK);
+
+    // The last occurrence counts; null and missing keys leave the value alone
+    double radius = 0.0;
+    uint32_t lookahead = 7;
+    bool enabled = true;
+    r = Parse("{\"type\":\"GEOFENCE\",\"radius\":300,\"radius\":400,\"lookahead\":null,\"enabled\":1}", &in);
+    HOST_CHECK(r.error == POI_PARSE_OK && r.params.count == 4);
+    HOST_CHECK(Param_Double(r, "radius", &radius) && radius == 400.0);
+    HOST_CHECK(!Param_Count(r, "lookahead", 0, &lookahead) && lookahead == 7);
+    HOST_CHECK(!Param_Count(r, "exitRadius", 0, &lookahead) && lookahead == 7 && r.error == POI_PARSE_OK);
+
+    // A wrong type is FIELD_TYPE at the value; later errors do not replace it
+    HOST_CHECK(!Param_Bool(r, "enabled", &enabled) && enabled && r.error == POI_PARSE_ERR_FIELD_TYPE && r.entry == -1);
+    size_t offset = r.offset;
+    HOST_CHECK(!Param_Require(r, false) && r.error == POI_PARSE_ERR_FIELD_TYPE && r.offset == offset);
+
+    r = Parse("{\"type\":\"TRACE\"} ", &in);
+    HOST_CHECK(!Param_Require(r, Param_Bool(r, "enabled", &enabled)));
+    HOST_CHECK(r.error == POI_PARSE_ERR_MISSING_PARAM && r.offset == r.params.end && r.offset == in.size);
+
+    uint32_t id = 0;
+    r = Parse("{\"type\":\"METRICS\",\"requestId\":-1}", &in);
+    HOST_CHECK(!Param_Id(r, "requestId", &id) && r.error == POI_PARSE_ERR_OUT_OF_RANGE);
+    r = Parse("{\"type\":\"METRICS\",\"requestId\":1.5}", &in);
+    HOST_CHECK(!Param_Id(r, "requestId", &id) && r.error == POI_PARSE_ERR_FIELD_TYPE);
+
+    double lat = 0.0;
+    r = Parse("{\"type\":\"POI_QUERY_NEAREST\",\"lat\":90.5,\"lon\":0}", &in);
+    HOST_CHECK(!Param_DoubleIn(r, "lat", -90.0, 90.0, &lat) && lat == 0.0 && r.error == POI_PARSE_ERR_OUT_OF_RANGE);
+
+    HOST_CHECK(std::strcmp(PoiMessage_TypeName(POI_MSG_QUERY_NEAREST), "POI_QUERY_NEAREST") == 0);
+    HOST_CHECK(std::strcmp(PoiMessage_TypeName(POI_MSG_EMITTER_FOLLOW), "EMITTER_FOLLOW") == 0);
+    HOST_CHECK(std::strcmp(PoiMessage_TypeName(POI_MSG_COUNT), "UNKNOWN") == 0);
+}
+
+int main(int argc, char** argv)
+{
+    unsigned iterations = 20000;
+    bool checked = true;
+    std::vector<Seed> corpus;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--iterations") && i + 1 < argc)
+            iterations = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            s_rng = std::strtoull(argv[++i], nullptr, 10) | 1;
+        else if (!std::strcmp(argv[i], "--mutate-only"))
+            checked = false;
+        else
+        {
+            Seed seed;
+            seed.name = argv[i];
+            seed.checked = checked;
+            if (!HOST_CHECK(ReadFile(argv[i], &seed.body)))
+                continue;
+            corpus.push_back(seed);
+        }
+    }
+    if (!HOST_CHECK(!corpus.empty()))
+        return HostCheck_Finish("parser fuzz");
+
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        FuzzInput in;
+        PoiParseResult result = Parse(corpus[i].body, &in);
+        CheckResult(result, in);
+        if (!corpus[i].checked)
+            continue;
+        std::string expected = ExpectedError(corpus[i].name);
+        if (expected != PoiParse_ErrorName(result.error))
+        {
+            std::printf("%s: expected %s, got %s at offset %zu\n", corpus[i].name.c_str(), expected.c_str(),
+                PoiParse_ErrorName(result.error), result.offset);
+            HOST_CHECK(false);
+        }
+    }
+
+    CheckParams();
+
+    unsigned accepted = 0;
+    for (unsigned i = 0; i < iterations; ++i)
+    {
+        std::string message = corpus[Random((uint32_t)corpus.size())].body;
+        Mutate(message, corpus);
+
+        FuzzInput in;
+        PoiParseResult result = Parse(message, &in);
+        CheckResult(result, in);
+        if (result.error == POI_PARSE_OK)
+        {
+            ReadParams(result, in);
+            ++accepted;
+        }
+    }
+
+    std::printf("parser fuzz: %zu seeds, %u mutations (%u accepted)\n", corpus.size(), iterations, accepted);
+    return HostCheck_Finish("parser fuzz");
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+#include "flight/TourSnapshot.h"
+
+// -----------------------------------------------------------------------------
+// Tour snapshot: the checksum covers the header, and a change of active POI
+// or flight state rewrites only the header.
+// Bytes appended to the file after a full write survive a header rewrite (a
+// full write would drop them); they are cut again before restoring.
+// -----------------------------------------------------------------------------
+
+static const int kPois = 20;
+static const size_t kHeaderBytes = 28;
+static const unsigned kSaveFrames = (unsigned)(TOUR_SNAPSHOT_SAVE_DELAY_MS / HOSTSIM_FRAME_MS) + 2;
+
+static std::vector<char> ReadSnapshot()
+{
+    std::vector<char> bytes;
+    FILE* file = std::fopen(TOUR_SNAPSHOT_PATH, "rb");
+    if (!file)
+        return bytes;
+    char block[4096];
+    size_t read;
+    while ((read = std::fread(block, 1, sizeof(block), file)) > 0)
+        bytes.insert(bytes.end(), block, block + read);
+    std::fclose(file);
+    return bytes;
+}
+
+static void WriteSnapshot(const std::vector<char>& bytes)
+{
+    FILE* file = std::fopen(TOUR_SNAPSHOT_PATH, "wb");
+    if (HOST_CHECK(file != nullptr))
+    {
+        std::fwrite(bytes.data(), 1, bytes.size(), file);
+        std::fclose(file);
+    }
+}
+
+static int32_t HeaderActive(const std::vector<char>& bytes)
+{
+    int32_t active = 0;
+    std::memcpy(&active, bytes.data() + 16, 4);
+    return active;
+}
+
+int main()
+{
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+
+    std::string pois = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < kPois; ++i)
+    {
+        char poi[64];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.3f,\"lon\":8.0}", i ? "," : "", i + 1, 47.0 + i * 0.01);
+        pois += poi;
+    }
+    pois += "]}";
+    HostSim_SendToModule(pois.data(), pois.size());
+    HostSim_Frames(kSaveFrames);
+
+    std::vector<char> full = ReadSnapshot();
+    HOST_CHECK(full.size() == kHeaderBytes + kPois * 20);
+    if (full.size() < kHeaderBytes)
+        return HostCheck_Finish("tour snapshot test");
+    HOST_CHECK(HeaderActive(full) == -1);
+
+    // A changed flag is caught by the checksum
+    std::vector<char> tampered = full;
+    tampered[20] ^= 1;
+    WriteSnapshot(tampered);
+    HOST_CHECK(!TourSnapshot_Load());
+    WriteSnapshot(full);
+
+    // Starting the flight rewrites the header in place
+    std::vector<char> padded = full;
+    padded.insert(padded.end(), 4, '\0');
+    WriteSnapshot(padded);
+    HostSim_SetLVar("L:WFP_StartFlight", 1.0);
+    HostSim_Frames(kSaveFrames);
+
+    std::vector<char> rewritten = ReadSnapshot();
+    HOST_CHECK(rewritten.size() == padded.size());
+    HOST_CHECK(rewritten.size() >= kHeaderBytes && HeaderActive(rewritten) == 0);
+    HOST_CHECK(std::equal(full.begin() + kHeaderBytes, full.end(), rewritten.begin() + kHeaderBytes));
+
+    rewritten.resize(full.size());
+    WriteSnapshot(rewritten);
+    HostSim_ClearOutput();
+    HOST_CHECK(TourSnapshot_Load());
+    HostSim_Frame();
+    HOST_CHECK(HostSim_Output().find("\"count\":20,\"active\":0,\"flightActive\":true") != std::string::npos);
+
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    return HostCheck_Finish("tour snapshot test");
+}
@@ -0,0 +1,121 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "host/HostSim.h"
+#include "host/HostCheck.h"
+#include "core/Constants.h"
+#include "dispatch/DispatchTrace.h"
+
+// -----------------------------------------------------------------------------
+// Trace round trip: a session captured with TRACE and replayed in a fresh
+// module must make the same SimConnect calls, on the same object ids.
+// Module state outlives module_deinit, so each half runs in its own process:
+//   wfp_trace_replay_test capture   (ctest trace_capture)
+//   wfp_trace_replay_test replay    (ctest trace_replay, after trace_capture)
+// -----------------------------------------------------------------------------
+
+static void Session()
+{
+    AircraftState aircraft = {};
+    aircraft.latDeg = 47.0;
+    aircraft.lonDeg = 8.0;
+    aircraft.altMeters = 600.0;
+    aircraft.altAboveGroundMeters = 200.0;
+    HostSim_SetAircraft(aircraft);
+    HostSim_Frame();
+
+    std::string pois = "{\"type\":\"POI_COORDINATES\",\"data\":[";
+    for (int i = 0; i < 50; ++i)
+    {
+        char poi[96];
+        std::snprintf(poi, sizeof(poi), "%s{\"id\":%d,\"lat\":%.4f,\"lon\":%.4f}", i ? "," : "", i + 1,
+            47.0 + i * 0.01, 8.0 + (i % 7) * 0.01);
+        pois += poi;
+    }
+    pois += "]}";
+    HostSim_SendToModule(pois.data(), pois.size());
+    HostSim_Frames(5);
+
+    HostSim_SetLVar("L:WFP_StartFlight", 1.0);
+    HostSim_Frames(20);
+    for (int i = 0; i < 10; ++i)
+    {
+        HostSim_SetLVar("L:WFP_NextPoi", 1.0);
+        HostSim_Frame();
+        HostSim_SetLVar("L:WFP_NextPoi", 0.0);
+        HostSim_Frames(3);
+    }
+    HostSim_Event(EVENT_TRIGGER_N);
+    HostSim_Frames(5);
+}
+
+static const char* const EXPECTED_PATH = "trace_replay_test.expected";
+
+// Captures the session to TRACE_FILE_PATH and writes what it asked of SimConnect
+static int Capture()
+{
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HostSim_Init();
+    HostSim_SendToModule("{\"type\":\"TRACE\",\"enabled\":true}");
+    Session();
+    HostSim_SendToModule("{\"type\":\"TRACE\",\"enabled\":false}");
+    HostSimCounters captured = HostSim_GetCounters();
+    HostSim_Deinit();
+    std::remove(TOUR_SNAPSHOT_PATH);
+    HOST_CHECK(captured.creates > 0);
+    HOST_CHECK(captured.unknownObjects == 0);
+
+    FILE* file = std::fopen(EXPECTED_PATH, "w");
+    if (HOST_CHECK(file != nullptr))
+    {
+        std::fprintf(file, "%llu %llu %llu\n", (unsigned long long)captured.creates,
+            (unsigned long long)captured.removes, (unsigned long long)captured.moves);
+        std::fclose(file);
+    }
+    return HostCheck_Finish("trace capture");
+}
+
+// Replays the capture in a fresh module (this process) and compares
+static int Replay()
+{
+    unsigned long long creates = 0, removes = 0, moves = 0;
+    FILE* file = std::fopen(EXPECTED_PATH, "r");
+    if (!HOST_CHECK(file != nullptr))
+        return HostCheck_Finish("trace replay");
+    HOST_CHECK(std::fscanf(file, "%llu %llu %llu", &creates, &removes, &moves) == 3);
+    std::fclose(file);
+
+    HOST_CHECK(DispatchTrace_CanReplay());
+    HostSim_Init();
+    HostSim_ClearOutput();
+    HostSim_SendToModule("{\"type\":\"TRACE_REPLAY\",\"maxSpeed\":true}");
+    HostSim_Frames(3);
+    const std::string& output = HostSim_Output();
+    HOST_CHECK(output.find("ack: TRACE_REPLAY maxSpeed=1") != std::string::npos);
+    HOST_CHECK(output.find("\"event\":\"REPLAY_DONE\",\"complete\":true") != std::string::npos);
+    HOST_CHECK(!DispatchTrace_IsReplaying());
+
+    // Replayed ASSIGNED_OBJECT_IDs carry the captured ids, which the stand-in
+    // hands out in the same order
+    HostSimCounters replayed = HostSim_GetCounters();
+    HOST_CHECK(replayed.creates == creates);
+    HOST_CHECK(replayed.removes == removes);
+    HOST_CHECK(replayed.moves == moves);
+    HOST_CHECK(replayed.unknownObjects == 0);
+    HostSim_Deinit();
+
+    std::remove(TOUR_SNAPSHOT_PATH);
+    std::remove(TRACE_FILE_PATH);
+    std::remove(EXPECTED_PATH);
+    return HostCheck_Finish("trace replay");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "capture") == 0)
+        return Capture();
+    if (argc > 1 && std::strcmp(argv[1], "replay") == 0)
+        return Replay();
+    std::fprintf(stderr, "usage: %s capture|replay\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,56 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "host/HostSim.h"
+#include "dispatch/DispatchTrace.h"
+
+// -----------------------------------------------------------------------------
+// Offline trace replay
+//   wfp_trace_replay <trace> [--recorded-speed]
+// Replays a trace captured in the sim (TRACE message, \work\dispatch.wfptrace)
+// against the host stand-in instead of the live SimConnect. Prints the replay
+// summary, what the module asked of SimConnect and the messages it sent to JS.
+// Exit code 0 when the whole trace was replayed.
+// -----------------------------------------------------------------------------
+
+static const unsigned MAX_IDLE_FRAMES = 1000000; // recorded speed: about 4.5 h of trace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s <trace> [--recorded-speed]\n", argv[0]);
+        return 2;
+    }
+    bool maxSpeed = !(argc > 2 && std::strcmp(argv[2], "--recorded-speed") == 0);
+
+    HostSim_Init();
+    if (!DispatchTrace_StartReplay(argv[1], maxSpeed))
+    {
+        std::fprintf(stderr, "%s: not a trace\n", argv[1]);
+        HostSim_Deinit();
+        return 2;
+    }
+
+    double cpuMs = HostSim_CpuMs();
+    uint64_t allocations = HostSim_Allocations();
+    for (unsigned frame = 0; frame < MAX_IDLE_FRAMES && DispatchTrace_IsReplaying(); ++frame)
+        HostSim_Frame();
+    HostSim_Frame(); // flushes the REPLAY_DONE summary
+    cpuMs = HostSim_CpuMs() - cpuMs;
+    allocations = HostSim_Allocations() - allocations;
+
+    const std::string& output = HostSim_Output();
+    std::fwrite(output.data(), 1, output.size(), stdout);
+
+    HostSimCounters counters = HostSim_GetCounters();
+    std::printf("replay: %.2f ms cpu, %llu allocs, %llu creates, %llu removes, %llu moves, "
+        "%llu ids not created in this replay, %llu live objects\n",
+        cpuMs, (unsigned long long)allocations, (unsigned long long)counters.creates,
+        (unsigned long long)counters.removes, (unsigned long long)counters.moves,
+        (unsigned long long)counters.unknownObjects, (unsigned long long)counters.liveObjects);
+
+    bool complete = output.find("\"event\":\"REPLAY_DONE\",\"complete\":true") != std::string::npos;
+    HostSim_Deinit();
+    return complete ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// JsonTokenizer
+// Allocation-free, single-pass JSON tokenizer over a caller-owned buffer.
+// Tokens reference the buffer directly (strings are returned without their
+// quotes and with escapes left in place). The buffer does not need to be NUL
+// terminated; a NUL byte is treated as end of input.
+// -----------------------------------------------------------------------------
+
+enum eJsonTokenType
+{
+    JSON_TOK_END = 0,      // end of input
+    JSON_TOK_ERROR,        // see JsonToken::error
+    JSON_TOK_OBJECT_BEGIN, // {
+    JSON_TOK_OBJECT_END,   // }
+    JSON_TOK_ARRAY_BEGIN,  // [
+    JSON_TOK_ARRAY_END,    // ]
+    JSON_TOK_COLON,        // :
+    JSON_TOK_COMMA,        // ,
+    JSON_TOK_STRING,       // text/length hold the raw string body
+    JSON_TOK_NUMBER,       // number holds the parsed value
+    JSON_TOK_TRUE,
+    JSON_TOK_FALSE,
+    JSON_TOK_NULL
+};
+
+enum eJsonError
+{
+    JSON_ERR_NONE = 0,
+    JSON_ERR_UNEXPECTED_CHAR,   // byte that cannot start a token
+    JSON_ERR_UNTERMINATED_STRING,
+    JSON_ERR_BAD_ESCAPE,        // invalid backslash sequence in a string
+    JSON_ERR_BAD_NUMBER,        // malformed, overlong or out of double range number literal
+    JSON_ERR_BAD_LITERAL        // misspelled true/false/null
+};
+
+struct JsonToken
+{
+    eJsonTokenType type;
+    eJsonError error;   // set when type == JSON_TOK_ERROR
+    size_t offset;      // byte offset of the token (or error) in the buffer
+    const char* text;   // JSON_TOK_STRING: first byte after the opening quote
+    size_t length;      // JSON_TOK_STRING: bytes up to the closing quote
+    bool hasEscapes;    // JSON_TOK_STRING: body contains backslash escapes
+    double number;      // JSON_TOK_NUMBER (always finite)
+};
+
+struct JsonTokenizer
+{
+    const char* begin;
+    const char* cur;
+    const char* end;
+};
+
+void JsonTokenizer_Init(JsonTokenizer* tz, const char* buf, size_t size);
+
+// Reads the next token. Returns false (and a JSON_TOK_ERROR token) on malformed
+// input; returns true for every other token including JSON_TOK_END.
+bool JsonTokenizer_Next(JsonTokenizer* tz, JsonToken* tok);
+
+// Human readable name for an error code (for logging)
+const char* JsonTokenizer_ErrorName(eJsonError error);
+
+// Compares a JSON_TOK_STRING body with a NUL-terminated literal
+bool JsonToken_Equals(const JsonToken& tok, const char* literal);
+
+// Exact conversion of a JSON_TOK_NUMBER for identifiers: false for fractions
+// and for values outside [0, 4294967295]
+bool JsonToken_ToUint32(const JsonToken& tok, uint32_t* out);
+
+// Saturating conversion of a JSON_TOK_NUMBER for counts and limits: the
+// fraction is dropped and the value clamped to [minValue, 4294967295]
+uint32_t JsonToken_ClampUint32(const JsonToken& tok, uint32_t minValue);
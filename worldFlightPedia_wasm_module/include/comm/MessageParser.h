@@ -1,8 +1,149 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <utility>
+#include "comm/JsonTokenizer.h"
 
-// Parse and return a list of coordinates (lat, lon) from a lightweight JSON-like message
-// Input expected shape: { "type": "POI_COORDINATES", "data": [ {"lat": 40.7, "lon": -74.0}, ... ], "count": n }
-std::vector<std::pair<double, double>> ParsePoiCoordinates(const std::string& jsonMessage);
+// Message types understood by the POI parser (value of the top-level "type" key)
+enum ePoiMessageType
+{
+    POI_MSG_UNKNOWN = 0,
+    POI_MSG_COORDINATES,     // "POI_COORDINATES": full POI list
+    POI_MSG_ADD,             // "POI_ADD": insert (or overwrite) POIs by id
+    POI_MSG_REMOVE,          // "POI_REMOVE": remove POIs by id (lat/lon optional)
+    POI_MSG_UPDATE,          // "POI_UPDATE": move existing POIs by id
+    POI_MSG_QUERY_NEAREST,   // "POI_QUERY_NEAREST": k closest POIs to lat/lon
+    POI_MSG_QUERY_RADIUS,    // "POI_QUERY_RADIUS": POIs within radius meters of lat/lon
+    POI_MSG_QUERY_DEDUP,     // "POI_QUERY_DEDUP": POIs within radius meters of an earlier POI
+    POI_MSG_MARKER_STREAMING, // "MARKER_STREAMING": configure visibility-radius marker streaming
+    POI_MSG_SPAWN_QUEUE,     // "SPAWN_QUEUE": configure the marker spawn rate
+    POI_MSG_GEOFENCE,        // "GEOFENCE": configure arrival geofences
+    POI_MSG_TOUR_OPTIMIZE,   // "TOUR_OPTIMIZE": reorder the tour now
+    POI_MSG_TOUR_OPTIMIZER,  // "TOUR_OPTIMIZER": configure tour optimization
+    POI_MSG_METRICS,         // "METRICS": send a metrics snapshot, configure periodic ones
+    POI_MSG_TRACE,           // "TRACE": start / stop capturing a dispatch trace
+    POI_MSG_TRACE_REPLAY,    // "TRACE_REPLAY": replay the captured dispatch trace
+    POI_MSG_UPLOAD_BEGIN,    // "POI_UPLOAD_BEGIN": open a chunked POI list upload
+    POI_MSG_UPLOAD_CHUNK,    // "POI_UPLOAD_CHUNK": one chunk of the upload ("data" keyed by id)
+    POI_MSG_UPLOAD_COMMIT,   // "POI_UPLOAD_COMMIT": replace the POI list with the upload
+    POI_MSG_UPLOAD_ABORT,    // "POI_UPLOAD_ABORT": drop the upload
+    POI_MSG_MARKER_LOOKAHEAD, // "MARKER_LOOKAHEAD": configure parked markers for the next POIs
+    POI_MSG_EMITTER_FOLLOW,  // "EMITTER_FOLLOW": configure the emitter cube follow, report its update rate
+    POI_MSG_COUNT
+};
+
+// Bitmask of the keys present in a PoiRecord
+enum ePoiField
+{
+    POI_FIELD_ID        = 0x01,
+    POI_FIELD_NAME      = 0x02,
+    POI_FIELD_LAT       = 0x04,
+    POI_FIELD_LON       = 0x08,
+    POI_FIELD_ELEVATION = 0x10,
+    POI_FIELD_CATEGORY  = 0x20
+};
+
+// One entry of the "data" array. String fields point into the input buffer
+// (raw JSON body, escapes not decoded) and are only valid during the callback.
+// A numeric "id" is used as-is; a string id is hashed (FNV-1a); a missing id
+// defaults to the entry index.
+struct PoiRecord
+{
+    uint32_t id;
+    double lat;
+    double lon;
+    double elevation;        // meters, 0 when absent
+    const char* name;
+    size_t nameLength;
+    const char* category;
+    size_t categoryLength;
+    unsigned fields;         // ePoiField bits
+};
+
+enum ePoiParseError
+{
+    POI_PARSE_OK = 0,
+    POI_PARSE_ERR_JSON,             // tokenizer error, see PoiParseResult::jsonError
+    POI_PARSE_ERR_UNEXPECTED_TOKEN, // valid JSON token in the wrong place
+    POI_PARSE_ERR_FIELD_TYPE,       // known field with a value of the wrong type (including a fractional id)
+    POI_PARSE_ERR_MISSING_LAT_LON,  // entry without both "lat" and "lon" (not required for POI_REMOVE)
+    POI_PARSE_ERR_MISSING_ID,       // POI_ADD / POI_REMOVE / POI_UPDATE / POI_UPLOAD_CHUNK entry without "id"
+    POI_PARSE_ERR_OUT_OF_RANGE,     // lat outside [-90, 90], lon outside [-180, 180], or an id outside uint32
+    POI_PARSE_ERR_COUNT_MISMATCH,   // "count" disagrees with the number of entries
+    POI_PARSE_ERR_UNKNOWN_TYPE,     // missing or unsupported "type"
+    POI_PARSE_ERR_MISSING_PARAM,    // message without its required top-level parameters
+    POI_PARSE_ERR_TOO_DEEP,         // nesting limit exceeded while skipping a value
+    POI_PARSE_ERR_TOO_MANY_PARAMS   // more than POI_MAX_MESSAGE_PARAMS top-level parameters
+};
+
+const size_t POI_MAX_MESSAGE_PARAMS = 16;
+
+// Top-level parameters of a message: every key besides "type", "data" and
+// "count" whose value is a string, number, true, false or null, in message
+// order. The handler of the message type reads them (Param_* below); the
+// parser does not know which keys a type takes.
+struct PoiMessageParam
+{
+    JsonToken key;
+    JsonToken value;
+};
+
+struct PoiMessageParams
+{
+    PoiMessageParam items[POI_MAX_MESSAGE_PARAMS];
+    size_t count;
+    size_t end;         // byte offset of the end of the message (MISSING_PARAM)
+};
+
+struct PoiParseResult
+{
+    ePoiParseError error;
+    eJsonError jsonError;  // detail when error == POI_PARSE_ERR_JSON
+    size_t offset;         // byte offset where the error was detected
+    int entry;             // index of the offending "data" entry, -1 if outside
+    ePoiMessageType type;
+    uint32_t count;        // entries delivered to the callback
+    PoiMessageParams params;
+};
+
+typedef void (*PoiRecordCallback)(const PoiRecord& poi, void* ctx);
+
+// Single linear scan over buf. Keys may appear in any order; unknown keys of
+// "data" entries, and top-level objects and arrays, are skipped. Each valid
+// entry is passed to onPoi as soon as it is complete; since "type" may follow
+// "data" (and decides which fields are required), callers must check the
+// result before committing anything collected in the callback.
+PoiParseResult ParsePoiMessage(const char* buf, size_t size, PoiRecordCallback onPoi, void* ctx);
+
+// Convenience wrapper: collects (lat, lon) pairs into 'out' (cleared first)
+PoiParseResult ParsePoiCoordinates(const char* buf, size_t size, std::vector<std::pair<double, double>>& out);
+
+// Human readable name for an error code (for logging)
+const char* PoiParse_ErrorName(ePoiParseError error);
+
+// The "type" string of a message type ("POI_COORDINATES", ...), "UNKNOWN" for
+// POI_MSG_UNKNOWN
+const char* PoiMessage_TypeName(ePoiMessageType type);
+
+// Parameter readers for message handlers. A reader returns true and stores the
+// value when the key is present with a valid value (the last one if repeated).
+// A missing or null key returns false and leaves *out untouched, so *out may
+// hold the current setting. An invalid value returns false and records the
+// error in msg (the first one is kept); handlers check msg.error after reading.
+bool Param_Bool(PoiParseResult& msg, const char* key, bool* out);
+bool Param_Double(PoiParseResult& msg, const char* key, double* out);
+
+// OUT_OF_RANGE outside [minValue, maxValue]
+bool Param_DoubleIn(PoiParseResult& msg, const char* key, double minValue, double maxValue, double* out);
+
+// Identifier: a whole number in [0, UINT32_MAX]; FIELD_TYPE for a fraction,
+// OUT_OF_RANGE for anything else outside
+bool Param_Id(PoiParseResult& msg, const char* key, uint32_t* out);
+
+// Count or limit: the fraction is dropped, the value clamped to [minValue, UINT32_MAX]
+bool Param_Count(PoiParseResult& msg, const char* key, uint32_t minValue, uint32_t* out);
+
+// Records MISSING_PARAM when a required key was not read; returns 'present'
+bool Param_Require(PoiParseResult& msg, bool present);
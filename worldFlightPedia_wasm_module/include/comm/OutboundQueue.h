@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * OutboundQueue
+ * -------------
+ * Every WASM -> JS message goes through this queue instead of its own
+ * fsCommBusCall.
+ * - Each message gets a sequence number (1, 2, ... since the module loaded)
+ * - Messages queued during a frame are sent together in one call when the
+ *   frame tick flushes the queue
+ * - Payload of a call: records separated by '\n', each "#<seq> <message>"
+ *     #41 ack: GEOFENCE enabled=1 radius=500 exitRadius=800 lookahead=3
+ *     #42 {"type":"GEOFENCE","event":"ENTER","id":7,"index":2,"meters":480}
+ * - Output above COMMBUS_BATCH_MAX_BYTES in one frame is split over more calls
+ * A message cannot span records: '\n' inside a message is sent as ' '.
+ */
+
+struct OutboundStats
+{
+    uint64_t messages; // messages queued
+    uint64_t calls;    // fsCommBusCall invocations
+    uint64_t bytes;    // payload bytes sent
+    uint32_t pending;  // messages waiting for the next flush
+};
+
+// Queues one message; returns its sequence number
+uint32_t OutboundQueue_Send(const char* msg, size_t length);
+
+// Formats a short message (acks, nacks) and queues it; output beyond
+// OUTBOUND_FORMAT_MAX_BYTES is cut off. Longer replies use ReplyBuilder.
+uint32_t OutboundQueue_Sendf(const char* format, ...);
+
+// Sends everything queued so far (once per frame, and at module init / deinit)
+void OutboundQueue_Flush();
+
+void OutboundQueue_GetStats(OutboundStats* stats);
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "core/PoiColumns.h"
+
+/**
+ * PoiUpload
+ * ---------
+ * Chunked, resumable replacement of the POI list, for lists too large for one
+ * CommBus message.
+ *   POI_UPLOAD_BEGIN   upload id, total POIs, POIs per chunk, checksum
+ *   POI_UPLOAD_CHUNK   chunk n = POIs [n * chunkSize, (n + 1) * chunkSize)
+ *   POI_UPLOAD_COMMIT  swaps the upload in as the new POI list
+ * - Chunks may arrive in any order and may be sent again; each one is written
+ *   into its slot of the upload's own columns as it arrives
+ * - The live POI list is not touched before the commit, and only then when
+ *   every chunk is present and the checksum matches
+ * - A commit with chunks missing leaves the upload open; PoiUpload_Missing
+ *   lists them so JS can send them again
+ * - BEGIN with the id, total, chunk size and checksum of the open upload
+ *   resumes it (a reloaded panel keeps the chunks already received); any
+ *   other BEGIN replaces it
+ * Checksum: FNV-1a over id (uint32), lat and lon (float64) of every POI in
+ * upload order, all little endian.
+ */
+
+enum ePoiUploadStatus
+{
+    POI_UPLOAD_OK = 0,
+    POI_UPLOAD_ERR_BAD_PARAMS,  // BEGIN with a chunk size of 0 or too many POIs
+    POI_UPLOAD_ERR_NO_UPLOAD,   // no open upload with that id
+    POI_UPLOAD_ERR_BAD_CHUNK,   // chunk index past the last chunk
+    POI_UPLOAD_ERR_CHUNK_SIZE,  // chunk with the wrong number of POIs
+    POI_UPLOAD_ERR_INCOMPLETE,  // COMMIT with chunks missing (upload stays open)
+    POI_UPLOAD_ERR_CHECKSUM     // COMMIT with a checksum mismatch (upload dropped)
+};
+
+struct PoiUploadStatus
+{
+    bool open;
+    uint32_t uploadId;
+    uint32_t total;     // POIs
+    uint32_t chunks;
+    uint32_t received;  // chunks
+};
+
+// Opens (or resumes) an upload. 'resumed' tells which one happened.
+ePoiUploadStatus PoiUpload_Begin(uint32_t uploadId, uint32_t total, uint32_t chunkSize, uint32_t checksum, bool* resumed);
+
+// Stores chunk 'chunk' of the open upload from the first coords.size() entries
+// of coords / ids (entries keep their derived columns, nothing is recomputed)
+ePoiUploadStatus PoiUpload_StoreChunk(uint32_t uploadId, uint32_t chunk, const PoiColumns& coords, const std::vector<uint32_t>& ids);
+
+// Completes the upload: on POI_UPLOAD_OK the uploaded list is swapped into
+// coords / ids (for PoiStore_Replace) and the upload is closed
+ePoiUploadStatus PoiUpload_Commit(uint32_t uploadId, PoiColumns& coords, std::vector<uint32_t>& ids);
+
+// Drops the open upload; false when no upload with that id is open
+bool PoiUpload_Abort(uint32_t uploadId);
+
+// Appends up to 'max' missing chunk indexes of the open upload (ascending)
+void PoiUpload_Missing(std::vector<uint32_t>& out, size_t max);
+
+void PoiUpload_GetStatus(PoiUploadStatus* status);
+
+// Human readable name for a status code (for logging and nacks)
+const char* PoiUpload_StatusName(ePoiUploadStatus status);
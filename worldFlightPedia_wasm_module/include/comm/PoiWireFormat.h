@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+// Binary POI wire format (JS -> WASM over CommBus)
+// Sits next to the JSON text format; a message is binary when it starts with
+// POI_WIRE_MAGIC. All fields are little endian.
+//
+// Layout:
+//   PoiWireHeader               (24 bytes, keeps the arrays 8-byte aligned)
+//   double   lat[count]         (degrees; absent for POI_WIRE_TYPE_REMOVE)
+//   double   lon[count]         (degrees; absent for POI_WIRE_TYPE_REMOVE)
+//   uint32_t ids[count]         (only present when POI_WIRE_FLAG_HAS_IDS is set;
+//                                required for ADD / REMOVE / UPDATE / CHUNK)
+// -----------------------------------------------------------------------------
+
+static const uint32_t POI_WIRE_MAGIC = 0x31504657u; // "WFP1"
+static const uint16_t POI_WIRE_VERSION = 1;
+
+enum ePoiWireType
+{
+    POI_WIRE_TYPE_COORDINATES = 1, // Full POI list (same meaning as the "POI_COORDINATES" text message)
+    POI_WIRE_TYPE_ADD = 2,         // Insert (or overwrite) POIs by id
+    POI_WIRE_TYPE_REMOVE = 3,      // Remove POIs by id (ids only)
+    POI_WIRE_TYPE_UPDATE = 4,      // Move existing POIs by id
+    POI_WIRE_TYPE_CHUNK = 5        // One chunk of a chunked upload (see comm/PoiUpload.h)
+};
+
+enum ePoiWireFlags
+{
+    POI_WIRE_FLAG_HAS_IDS = 0x0001 // ids[] array follows lon[]
+};
+
+#pragma pack(push, 1)
+struct PoiWireHeader
+{
+    uint32_t magic;      // POI_WIRE_MAGIC
+    uint16_t version;    // POI_WIRE_VERSION
+    uint16_t type;       // ePoiWireType
+    uint32_t count;      // number of POIs in the arrays
+    uint32_t sequence;   // sender sequence number, echoed back in the ack; chunk index for CHUNK
+    uint16_t flags;      // ePoiWireFlags
+    uint16_t headerSize; // sizeof(PoiWireHeader) for this version; arrays start here
+    uint32_t upload;     // upload id for CHUNK, 0 otherwise
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PoiWireHeader) == 24, "PoiWireHeader must stay 24 bytes");
+
+enum ePoiWireStatus
+{
+    POI_WIRE_OK = 0,
+    POI_WIRE_ERR_TOO_SHORT,   // buffer smaller than the header
+    POI_WIRE_ERR_BAD_MAGIC,   // not a binary POI message
+    POI_WIRE_ERR_BAD_VERSION, // version newer than this module understands
+    POI_WIRE_ERR_BAD_TYPE,    // unknown message type
+    POI_WIRE_ERR_TRUNCATED,   // arrays extend past the end of the buffer
+    POI_WIRE_ERR_MISSING_IDS, // diff message without the ids array
+    POI_WIRE_ERR_OUT_OF_RANGE // lat outside [-90, 90] or lon outside [-180, 180] (or not finite)
+};
+
+// Non-owning view over a validated binary message. Pointers reference the
+// CommBus buffer directly and are only valid for the duration of the callback.
+struct PoiWireView
+{
+    uint16_t type;
+    uint32_t count;
+    uint32_t sequence;
+    uint32_t upload;
+    const unsigned char* lat; // count doubles, or nullptr (REMOVE)
+    const unsigned char* lon; // count doubles, or nullptr (REMOVE)
+    const unsigned char* ids; // count uint32, or nullptr
+    int entry;                // first entry out of range (POI_WIRE_ERR_OUT_OF_RANGE), -1 otherwise
+};
+
+// True when the buffer starts with the binary magic (cheap prefix test)
+bool PoiWire_IsBinary(const char* buf, size_t bufSize);
+
+// Validate the header, array bounds and coordinates, then fill 'out' with
+// pointers into buf. No allocation or copy of the payload is performed.
+// 'out' is also filled for POI_WIRE_ERR_OUT_OF_RANGE, with out->entry set.
+ePoiWireStatus PoiWire_Parse(const char* buf, size_t bufSize, PoiWireView* out);
+
+// Human readable name for a status code (for logging)
+const char* PoiWire_StatusName(ePoiWireStatus status);
+
+// Element accessors; safe on unaligned buffers
+double PoiWire_Lat(const PoiWireView& view, uint32_t index);
+double PoiWire_Lon(const PoiWireView& view, uint32_t index);
+uint32_t PoiWire_Id(const PoiWireView& view, uint32_t index);
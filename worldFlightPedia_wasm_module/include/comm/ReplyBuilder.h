@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * ReplyBuilder
+ * ------------
+ * Builds one WASM -> JS message in arena memory (core/Arena.h) and queues it
+ * (comm/OutboundQueue.h). Use it inside an ArenaScope; the text is gone when
+ * the scope ends, after Reply_Send has copied it into the outbound batch.
+ *     ArenaScope scope;
+ *     ReplyBuilder reply;
+ *     Reply_Begin(reply, 96 + count * 12);
+ *     Reply_Appendf(reply, "{\"type\":\"X\",\"requestId\":%u", requestId);
+ *     ...
+ *     Reply_Send(reply);
+ * A capacity hint close to the final size avoids regrowth (a regrowth copies
+ * the text into a new arena allocation twice as large).
+ */
+
+struct ReplyBuilder
+{
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+void Reply_Begin(ReplyBuilder& reply, size_t capacityHint);
+
+void Reply_Append(ReplyBuilder& reply, const char* text, size_t length);
+
+// Appends a NUL-terminated string
+void Reply_AppendStr(ReplyBuilder& reply, const char* text);
+
+void Reply_Appendf(ReplyBuilder& reply, const char* format, ...)
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// Queues the message; returns its sequence number
+uint32_t Reply_Send(const ReplyBuilder& reply);
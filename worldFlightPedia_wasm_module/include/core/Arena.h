@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * Arena
+ * -----
+ * Bump allocator for scratch memory that lives as long as one message (or one
+ * reply). Memory is handed out from large blocks and given back all at once
+ * by releasing a mark; ArenaScope does that at the end of a scope.
+ * - Blocks are kept after release, so once the arena has grown to the
+ *   largest message seen, handling a message does not touch the heap
+ * - Scopes nest: a scope only gives back what was allocated inside it
+ * - No destructors run; use it for plain data (characters, numbers, PODs)
+ * Single-threaded, like the rest of the module.
+ */
+
+struct ArenaMark
+{
+    size_t block; // index of the block in use
+    size_t used;  // bytes used in that block
+};
+
+// Returns 'bytes' of scratch memory aligned to 'align' (a power of two).
+// Never returns nullptr (the module aborts when memory runs out).
+void* Arena_Alloc(size_t bytes, size_t align = sizeof(double));
+
+ArenaMark Arena_Mark();
+
+// Gives back everything allocated since 'mark' was taken
+void Arena_Release(ArenaMark mark);
+
+// Bytes held in blocks (the arena's high-water mark)
+size_t Arena_ReservedBytes();
+
+struct ArenaScope
+{
+    ArenaMark mark;
+
+    ArenaScope() : mark(Arena_Mark()) {}
+    ~ArenaScope() { Arena_Release(mark); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
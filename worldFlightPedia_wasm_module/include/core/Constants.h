@@ -9,7 +9,8 @@ enum eEvents
     EVENT_SIM_START = 1,     // Triggered when the simulator session starts
     EVENT_FLIGHTPLAN_LOADED = 2, // Triggered when a flight plan is loaded
     EVENT_TRIGGER_M = 3,     // Custom event mapped to key 'M' (spawn object)
-    EVENT_TRIGGER_N = 4      // Custom event mapped to key 'N' (remove object)
+    EVENT_TRIGGER_N = 4,     // Custom event mapped to key 'N' (remove object)
+    EVENT_FRAME = 5          // Triggered every simulation frame
 };
 
 // -----------------------------------------------------------------------------
@@ -32,11 +33,8 @@ enum eInputs {
 enum eRequests {
     REQUEST_ADD_LASERS = 101,        // Request ID for creating laser objects
     REQUEST_REMOVE_LASERS = 201,     // Request ID for removing laser objects
-    REQUEST_LVAR_SPAWN = 1002,       // L:spawnAllLasersRed
-    REQUEST_LVAR_STARTFLIGHT = 1003, // L:WFP_StartFlight
-    REQUEST_LVAR_NEXTPOI = 1004,     // L:WFP_NextPoi
-    REQUEST_LVAR_SPAWN_CUBE = 1005,  // L:WFP_SPAWN_CUBE
-    REQUEST_USER_POS_FOR_CUBE = 301, // User position sample for cube spawn
+    REQUEST_LVAR_WATCH = 1000,       // All watched L:Vars (see simconnect/LVarRegistry.h)
+    REQUEST_USER_STATE = 302,        // User aircraft state every sim frame, on change (see simconnect/Telemetry.h)
     REQUEST_ADD_CUBE = 401           // SimObject creation for cube
 };
 
@@ -45,9 +43,104 @@ enum eRequests {
 // -----------------------------------------------------------------------------
 enum eDataDefs
 {
-    DEFINITION_LVAR_SPAWN = 1001,
-    DEFINITION_LVAR_STARTFLIGHT = 1003,
-    DEFINITION_LVAR_NEXTPOI = 1004,
-    DEFINITION_LVAR_SPAWN_CUBE = 1005, // L:WFP_SPAWN_CUBE
-    DEFINITION_USER_POSITION = 2001    // User position (lat/lon/alt/heading)
-};
\ No newline at end of file
+    DEFINITION_LVAR_WATCH = 1000,      // All watched L:Vars, one FLOAT64 each
+    DEFINITION_USER_STATE = 2001,      // User aircraft state (position, heading, velocity, AGL)
+    DEFINITION_MARKER_POSITION = 2003, // Marker reposition (lat/lon/AGL), see SimObjectManager
+    DEFINITION_EMITTER_POSITION = 2004 // Emitter cube reposition (lat/lon/alt MSL), see EmitterFollow
+};
+
+// -----------------------------------------------------------------------------
+// MARKER STREAMING DEFAULTS (see SimObjectManager_SetStreaming)
+// -----------------------------------------------------------------------------
+const double MARKER_STREAM_RADIUS_METERS = 30000.0; // markers spawn inside this radius
+const double MARKER_STREAM_HYSTERESIS = 1.25;       // ...and despawn beyond radius * hysteresis
+const unsigned MARKER_STREAM_BUDGET = 64;           // hard cap on resident markers
+const unsigned MARKER_STREAM_INTERVAL_MS = 1000;    // resident set recomputed at most this often
+
+// -----------------------------------------------------------------------------
+// MARKER SPAWN QUEUE DEFAULTS (see SimObjectManager_SetSpawnRate)
+// -----------------------------------------------------------------------------
+const unsigned MARKER_SPAWN_PER_FRAME = 4;        // creates submitted per frame
+const unsigned MARKER_SPAWN_MAX_IN_FLIGHT = 16;   // creates awaiting their object id
+const unsigned MARKER_SPAWN_TIMEOUT_MS = 10000;   // unanswered creates count as failed after this
+const unsigned MARKER_SPAWN_RETRY_MS = 2000;      // retry delay, multiplied by the attempts so far
+const unsigned MARKER_SPAWN_MAX_ATTEMPTS = 3;     // creates per marker before giving up
+const unsigned MARKER_POOL_MAX = 8;               // released markers kept for reuse until the next frame
+
+// -----------------------------------------------------------------------------
+// MARKER LOOKAHEAD DEFAULTS (see FlightController_SetLookahead)
+// -----------------------------------------------------------------------------
+const unsigned MARKER_LOOKAHEAD_DEPTH = 3;        // POIs after the active one that get a parked marker
+const unsigned MARKER_LOOKAHEAD_BUDGET = 8;       // hard cap on parked markers (the depth is clamped to it)
+const unsigned MARKER_LOOKAHEAD_PER_FRAME = 1;    // lookahead creates per frame, only on frames without other creates
+const double MARKER_PARK_ALT_AGL_METERS = -500.0; // parked markers wait this far below the terrain
+
+// -----------------------------------------------------------------------------
+// EMITTER FOLLOW DEFAULTS (see EmitterFollow_SetConfig)
+// -----------------------------------------------------------------------------
+const bool EMITTER_FOLLOW_ENABLED = true;
+const double EMITTER_FOLLOW_TOLERANCE_METERS = 2.0; // predicted drift that triggers a position update
+const double EMITTER_FOLLOW_LEAD = 0.9;             // an update places the cube this fraction of the tolerance ahead
+const unsigned EMITTER_EXTRAPOLATE_MAX_MS = 250;    // a sample is not extrapolated further than this (stopped or paused)
+
+// -----------------------------------------------------------------------------
+// FLIGHT TIMING
+// -----------------------------------------------------------------------------
+const unsigned NEXT_POI_SOUND_RESET_MS = 4000; // L:WFP_NEXT_POI_SOUND returns to 0 after this
+
+// -----------------------------------------------------------------------------
+// GEOFENCE DEFAULTS (see Geofence_SetConfig)
+// -----------------------------------------------------------------------------
+const double GEOFENCE_ENTER_METERS = 500.0;   // a POI's fence is entered inside this radius
+const double GEOFENCE_EXIT_METERS = 800.0;    // ...and left again beyond this one
+const double GEOFENCE_ARRIVAL_METERS = 200.0; // a POI counts as reached inside this radius
+const unsigned GEOFENCE_LOOKAHEAD = 3;      // POIs after the active one that are fenced too
+const unsigned GEOFENCE_MAX_LOOKAHEAD = 64; // cap on the lookahead (fences checked per frame)
+
+// -----------------------------------------------------------------------------
+// TOUR OPTIMIZER DEFAULTS (see TourOptimizer_SetConfig)
+// -----------------------------------------------------------------------------
+const unsigned TOUR_OPTIMIZE_BUDGET_MS = 8; // time limit per optimization run, all phases (fits a sim frame)
+
+// -----------------------------------------------------------------------------
+// LOGGING (see core/Log.h)
+// -----------------------------------------------------------------------------
+const unsigned LOG_RING_CAPACITY = 512;       // messages buffered between flushes
+const unsigned LOG_FLUSH_LINES_PER_FRAME = 32; // messages written to stderr per frame
+
+// -----------------------------------------------------------------------------
+// METRICS (see core/Metrics.h)
+// -----------------------------------------------------------------------------
+const unsigned METRICS_PUSH_INTERVAL_MS = 0; // periodic snapshots to JS, 0 = only on request
+
+// -----------------------------------------------------------------------------
+// COMMBUS (see comm/OutboundQueue.h)
+// -----------------------------------------------------------------------------
+const unsigned COMMBUS_BATCH_MAX_BYTES = 64 * 1024; // payload of one WASM -> JS call
+const unsigned OUTBOUND_FORMAT_MAX_BYTES = 256;     // one OutboundQueue_Sendf message
+
+// -----------------------------------------------------------------------------
+// DISPATCH TRACE (see dispatch/DispatchTrace.h)
+// -----------------------------------------------------------------------------
+const char* const TRACE_FILE_PATH = "\\work\\dispatch.wfptrace"; // capture / replay file in the module's work folder
+const bool TRACE_CAPTURE_AT_INIT = false;              // capture from module_init on, before any JS message
+const unsigned TRACE_WRITE_BUFFER_BYTES = 64 * 1024;   // records buffered before a file write
+const unsigned TRACE_MAX_RECORD_BYTES = 64 * 1024 * 1024; // larger records are treated as a corrupt trace
+
+// -----------------------------------------------------------------------------
+// TOUR SNAPSHOT (see flight/TourSnapshot.h)
+// -----------------------------------------------------------------------------
+const char* const TOUR_SNAPSHOT_PATH = "\\work\\tour.wfpsnap";
+const char* const TOUR_SNAPSHOT_TEMP_PATH = "\\work\\tour.wfpsnap.tmp"; // written first, then renamed
+const unsigned TOUR_SNAPSHOT_SAVE_DELAY_MS = 2000; // a change is written at most this long after it happened
+
+// -----------------------------------------------------------------------------
+// SCRATCH MEMORY (see core/Arena.h)
+// -----------------------------------------------------------------------------
+const unsigned ARENA_BLOCK_BYTES = 64 * 1024; // smallest block the message arena allocates
+
+// -----------------------------------------------------------------------------
+// CHUNKED POI UPLOAD (see comm/PoiUpload.h)
+// -----------------------------------------------------------------------------
+const unsigned POI_UPLOAD_MAX_POIS = 500000;     // larger uploads are refused at POI_UPLOAD_BEGIN
+const unsigned POI_UPLOAD_MAX_LISTED_MISSING = 256; // missing chunks listed per POI_UPLOAD_MISSING reply
\ No newline at end of file
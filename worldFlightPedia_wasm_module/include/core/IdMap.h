@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * IdMap
+ * -----
+ * Hash map from uint32_t keys to uint32_t values for the id lookups on the
+ * message path (POI id -> store index, POI id -> grid cell).
+ * - Open addressing with linear probing over one power-of-two slot array;
+ *   inserting never allocates a node
+ * - IdMap_Clear keeps the slots, so refilling a map up to its previous size
+ *   does not allocate; the array only grows (doubling past 3/4 load)
+ * - Erase shifts the following entries back (no tombstones)
+ * Values must be below 0xFFFFFFFF (a slot stores value + 1; 0 = empty).
+ */
+
+struct IdMapSlot
+{
+    uint32_t key;
+    uint32_t valuePlusOne; // 0 = empty slot
+};
+
+struct IdMap
+{
+    std::vector<IdMapSlot> slots; // size is 0 or a power of two
+    size_t count;
+
+    IdMap() : count(0) {}
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+void IdMap_Clear(IdMap& m);
+
+// Makes room for 'count' entries without further growth
+void IdMap_Reserve(IdMap& m, size_t count);
+
+// Looks 'key' up; returns false when absent
+bool IdMap_Find(const IdMap& m, uint32_t key, uint32_t* value);
+
+// Adds key -> value; returns false (and keeps the old value) when key exists
+bool IdMap_Insert(IdMap& m, uint32_t key, uint32_t value);
+
+// Adds key -> value or overwrites the existing value
+void IdMap_Set(IdMap& m, uint32_t key, uint32_t value);
+
+// Returns false when key was absent
+bool IdMap_Erase(IdMap& m, uint32_t key);
+
+void IdMap_Swap(IdMap& a, IdMap& b);
@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+/**
+ * Log
+ * ---
+ * Deferred logging for the module. A LOG_* call only copies the format
+ * pointer and its raw arguments into a fixed-size ring buffer; formatting and
+ * writing to stderr happen later, in Log_Flush, a limited number of lines per
+ * frame.
+ * - Levels below WFP_LOG_LEVEL are removed at compile time (arguments are
+ *   not evaluated). Define WFP_LOG_LEVEL=LOG_LEVEL_DEBUG to get everything.
+ * - The format must be a string literal (only its pointer is stored); format
+ *   and arguments are checked like printf at compile time
+ * - String arguments are copied (truncated to the record's text space), so
+ *   temporaries are safe to log
+ * - When the ring is full new messages are dropped and counted
+ * Output lines are "[MSFS] <message>"; the format has no prefix and no
+ * trailing newline.
+ */
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_OFF   4
+
+#ifndef WFP_LOG_LEVEL
+#define WFP_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+const size_t LOG_MAX_ARGS = 10;
+
+enum eLogArgType
+{
+    LOG_ARG_INT = 0,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER
+};
+
+struct LogArg
+{
+    union
+    {
+        long long i;
+        unsigned long long u;
+        double d;
+        const char* s;
+        const void* p;
+    };
+    uint8_t type; // eLogArgType
+};
+
+struct LogStats
+{
+    uint64_t written;   // messages stored in the ring
+    uint64_t flushed;   // messages written to stderr
+    uint64_t dropped;   // messages lost because the ring was full
+    uint64_t truncated; // string arguments cut to fit the record
+    uint32_t pending;   // messages waiting for a flush
+    uint32_t highWater; // most messages ever pending at once
+    uint32_t capacity;
+};
+
+// Writes up to maxLines pending messages to stderr (plus a notice when
+// messages were dropped since the last flush). Called once per frame.
+void Log_Flush(uint32_t maxLines);
+
+// Writes every pending message (module init / deinit)
+void Log_FlushAll();
+
+void Log_GetStats(LogStats* stats);
+
+// Stores one message; use the LOG_* macros instead
+void Log_Push(int level, const char* fmt, const LogArg* args, size_t argc);
+
+// ---------------------------------------------------------------------------
+// Argument capture
+// ---------------------------------------------------------------------------
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, LogArg>::type
+Log_MakeArg(T v) { LogArg a; a.i = (long long)v; a.type = LOG_ARG_INT; return a; }
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, LogArg>::type
+Log_MakeArg(T v) { LogArg a; a.u = (unsigned long long)v; a.type = LOG_ARG_UINT; return a; }
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value, LogArg>::type
+Log_MakeArg(T v) { LogArg a; a.i = (long long)v; a.type = LOG_ARG_INT; return a; }
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, LogArg>::type
+Log_MakeArg(T v) { LogArg a; a.d = (double)v; a.type = LOG_ARG_DOUBLE; return a; }
+
+inline LogArg Log_MakeArg(const char* v) { LogArg a; a.s = v; a.type = LOG_ARG_STRING; return a; }
+inline LogArg Log_MakeArg(char* v) { return Log_MakeArg((const char*)v); }
+
+template <typename T>
+inline LogArg Log_MakeArg(T* v) { LogArg a; a.p = (const void*)v; a.type = LOG_ARG_POINTER; return a; }
+
+template <typename... Args>
+inline void Log_Write(int level, const char* fmt, const Args&... args)
+{
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "too many log arguments");
+    LogArg packed[sizeof...(Args) + 1] = { Log_MakeArg(args)..., LogArg() };
+    Log_Push(level, fmt, packed, sizeof...(Args));
+}
+
+// The dead printf call only lets the compiler check the format
+#define LOG_WRITE(level, ...) do { if (0) std::printf(__VA_ARGS__); Log_Write(level, __VA_ARGS__); } while (0)
+#define LOG_DISABLED(...) do { if (0) std::printf(__VA_ARGS__); } while (0)
+
+#if WFP_LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_WRITE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WFP_LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_WRITE(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WFP_LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_WRITE(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISABLED(__VA_ARGS__)
+#endif
+
+#if WFP_LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_WRITE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISABLED(__VA_ARGS__)
+#endif
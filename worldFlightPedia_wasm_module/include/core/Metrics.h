@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct PoiParseResult;
+
+/**
+ * Metrics
+ * -------
+ * Always-on instrumentation of the dispatch routes.
+ * - Per route: call count, total and max duration, and a latency histogram
+ *   with power-of-two microsecond buckets (bucket 0 is < 1 us, bucket b is
+ *   [2^(b-1), 2^b) us, the last one is open-ended)
+ * - Event counters (creates issued, object ids assigned, removes, ...)
+ * Recording is two steady_clock reads and a few integer adds; nothing is
+ * allocated or formatted until a snapshot is sent to JS:
+ *   {"type":"METRICS","requestId":1,"uptimeMs":..,"counters":{...},
+ *    "routes":{"dispatch":{"n":..,"totalUs":..,"maxUs":..,"buckets":[...]},...},
+ *    "log":{...}}
+ * "buckets" stops at the last non-empty bucket.
+ */
+
+enum eMetricRoute
+{
+    METRIC_ROUTE_DISPATCH = 0,  // MyDispatchProc as a whole
+    METRIC_ROUTE_FRAME,         // per-frame tick (timers, spawn queue, log flush)
+    METRIC_ROUTE_LVAR,          // L:Var watch list update and its handlers
+    METRIC_ROUTE_ASSIGNED_ID,   // ASSIGNED_OBJECT_ID
+    METRIC_ROUTE_USER_POSITION, // user state changes (telemetry cache, geofences, marker streaming)
+    METRIC_ROUTE_COMMBUS,       // message received from JS
+    METRIC_ROUTE_SPAWN,         // AICreateSimulatedObject submission
+    METRIC_ROUTE_REMOVE,        // AIRemoveObject submission
+    METRIC_ROUTE_COUNT
+};
+
+enum eMetricCounter
+{
+    METRIC_CREATES_ISSUED = 0,  // creates accepted by SimConnect
+    METRIC_IDS_ASSIGNED,        // ASSIGNED_OBJECT_ID received
+    METRIC_REMOVES,             // removes accepted by SimConnect
+    METRIC_FAILURES,            // rejected creates / removes, create exceptions and timeouts
+    METRIC_POIS_PARSED,         // POI entries in accepted messages
+    METRIC_MESSAGES,            // messages received from JS
+    METRIC_MESSAGES_REJECTED,   // ...of which answered with a nack
+    METRIC_EMITTER_FRAMES,      // frames the emitter cube followed the aircraft (one update each when naive)
+    METRIC_EMITTER_UPDATES,     // ...of which moved it (SetDataOnSimObject)
+    METRIC_COUNTER_COUNT
+};
+
+const size_t METRIC_BUCKETS = 24;
+
+struct MetricHistogram
+{
+    uint64_t count;
+    uint64_t totalNs;
+    uint64_t maxNs;
+    uint32_t buckets[METRIC_BUCKETS];
+};
+
+// Nanoseconds on a monotonic clock
+uint64_t Metrics_NowNs();
+
+// Adds one call of 'route' that started at startNs (from Metrics_NowNs)
+void Metrics_Record(eMetricRoute route, uint64_t startNs);
+
+void Metrics_Count(eMetricCounter counter, uint32_t amount = 1);
+
+const MetricHistogram& Metrics_GetHistogram(eMetricRoute route);
+uint64_t Metrics_GetCounter(eMetricCounter counter);
+
+// Clears histograms and counters
+void Metrics_Reset();
+
+// Sends a snapshot to JS (see above)
+void Metrics_SendSnapshot(uint32_t requestId);
+
+// Sends a snapshot every intervalMs (requestId 0); 0 stops it
+void Metrics_SetPushInterval(uint32_t intervalMs);
+uint32_t Metrics_GetPushInterval();
+
+// { "type": "METRICS", "requestId": 1, "reset": false, "intervalMs": 1000 }
+// Always answers with a snapshot. "reset" clears the metrics after it;
+// "intervalMs" also pushes one (requestId 0) on that period, 0 stops it.
+// False (no snapshot) for an invalid parameter.
+bool Metrics_OnMessage(PoiParseResult& msg);
+
+// Records the enclosing block as one call of 'route'
+struct MetricsScope
+{
+    explicit MetricsScope(eMetricRoute r) : route(r), startNs(Metrics_NowNs()) {}
+    ~MetricsScope() { Metrics_Record(route, startNs); }
+
+    eMetricRoute route;
+    uint64_t startNs;
+};
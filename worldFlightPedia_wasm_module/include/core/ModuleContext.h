@@ -1,20 +1,19 @@
 #pragma once
 #include <MSFS/MSFS_WindowsTypes.h>
+#include <cstdint>
 #include <vector>
 #include <utility>
+#include "core/PoiColumns.h"
 
 // Declarations (do not define here, only 'extern')
 // Global handle to SimConnect connection
 extern HANDLE g_hSimConnect;
 // Single-object ID used for single-spawn operations
 extern DWORD g_lasersID;
-// Global list of POI coordinates (latitude, longitude)
-extern std::vector<std::pair<double, double>> g_poi_coords;
-
-// Last seen L: var states for change detection
-extern double g_lastSpawnState;   // last value of L:spawnAllLasersRed
-extern double g_lastStartFlight;  // last value of L:WFP_StartFlight
-extern double g_lastNextPoi;      // last value of L:WFP_NextPoi
+// Global list of POI coordinates (latitude, longitude and derived columns, see core/PoiColumns.h)
+extern PoiColumns g_poi_coords;
+// Stable POI ids, parallel to g_poi_coords (see core/PoiStore.h)
+extern std::vector<uint32_t> g_poi_ids;
 
 // Flight and POI state
 extern bool   g_flightActive;     // is automated flight active
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/**
+ * PoiColumns
+ * ----------
+ * Structure-of-arrays storage for POI positions (g_poi_coords).
+ * - lat / lon in degrees, plus what distance and bearing math needs per POI,
+ *   computed once when a position is set: the ECEF unit vector (x, y, z) and
+ *   cos(lat)
+ * - Every column is a separate array aligned to POI_COLUMN_ALIGNMENT bytes, so
+ *   batch kernels (geo/PoiKernels.h) stream them with vector loads
+ * - Entry i of every column belongs to the same POI (and to g_poi_ids[i])
+ */
+
+const size_t POI_COLUMN_ALIGNMENT = 32; // AVX register width; covers simd128 / SSE
+
+template <typename T>
+struct AlignedAllocator
+{
+    typedef T value_type;
+
+    AlignedAllocator() {}
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        // aligned_alloc needs a size that is a multiple of the alignment
+        size_t bytes = (n * sizeof(T) + POI_COLUMN_ALIGNMENT - 1) & ~(POI_COLUMN_ALIGNMENT - 1);
+        void* p = aligned_alloc(POI_COLUMN_ALIGNMENT, bytes ? bytes : POI_COLUMN_ALIGNMENT);
+        if (!p)
+            std::abort(); // no exceptions in the module
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        std::free(p);
+    }
+
+    template <typename U>
+    struct rebind { typedef AlignedAllocator<U> other; };
+};
+
+template <typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+typedef std::vector<double, AlignedAllocator<double>> AlignedDoubles;
+
+struct PoiColumns
+{
+    AlignedDoubles lat;    // degrees
+    AlignedDoubles lon;    // degrees
+    AlignedDoubles x;      // unit vector: x towards (0N, 0E)
+    AlignedDoubles y;      //              y towards (0N, 90E)
+    AlignedDoubles z;      //              z towards the north pole
+    AlignedDoubles cosLat;
+
+    size_t size() const { return lat.size(); }
+    bool empty() const { return lat.empty(); }
+};
+
+void PoiColumns_Clear(PoiColumns& c);
+void PoiColumns_Reserve(PoiColumns& c, size_t count);
+// Grows or shrinks every column to 'count' entries; new entries are 0 until set
+void PoiColumns_Resize(PoiColumns& c, size_t count);
+void PoiColumns_Append(PoiColumns& c, double latDeg, double lonDeg);
+void PoiColumns_Set(PoiColumns& c, size_t i, double latDeg, double lonDeg);
+void PoiColumns_Erase(PoiColumns& c, size_t i);
+void PoiColumns_Swap(PoiColumns& a, PoiColumns& b);
+
+// Copies entry srcIndex of 'src' (all columns) over entry dstIndex of 'dst'
+void PoiColumns_CopyEntry(PoiColumns& dst, size_t dstIndex, const PoiColumns& src, size_t srcIndex);
+
+// Replaces 'dst' with entries [first, size) of 'src'
+void PoiColumns_AssignTail(PoiColumns& dst, const PoiColumns& src, size_t first);
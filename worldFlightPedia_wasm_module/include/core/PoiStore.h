@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include "core/PoiColumns.h"
+
+/**
+ * PoiStore
+ * --------
+ * Owns the POI list kept in ModuleContext (g_poi_coords / g_poi_ids) and applies
+ * changes to it in place, keyed by stable POI id. Tour order is the vector order.
+ * Responsibilities:
+ *  - Full replacement (POI_COORDINATES) with a diff against the previous list
+ *  - Incremental POI_ADD / POI_REMOVE / POI_UPDATE
+ *  - O(1) id -> index lookup
+ *  - Keep the spatial index (geo/PoiSpatialIndex.h) in sync
+ *  - Keep g_activePoiIndex pointing at the same POI when earlier entries are removed
+ *  - Count changes (revision), so observers can tell the list changed without diffing it
+ * Ids are expected to be unique; for duplicates the first entry wins lookups.
+ */
+
+struct PoiEntry
+{
+    uint32_t id;
+    double lat;
+    double lon;
+};
+
+// Swap 'coords'/'ids' in as the new POI list (the caller receives the old
+// contents back, keeping both capacities). Ids that were added, removed or
+// moved are appended to 'changed'.
+void PoiStore_Replace(PoiColumns& coords, std::vector<uint32_t>& ids, std::vector<uint32_t>& changed);
+
+// Appends a POI, or moves it when the id already exists.
+// Returns true when the store changed.
+bool PoiStore_Add(const PoiEntry& entry);
+
+// Moves an existing POI. Returns false for an unknown id or unchanged position.
+bool PoiStore_Update(const PoiEntry& entry);
+
+// Removes a POI, preserving the order of the others. Returns false for an unknown id.
+bool PoiStore_Remove(uint32_t id);
+
+// Reorders the tail of the tour: entry from + i becomes the entry that was at
+// from + order[i]. 'order' must be a permutation of 0..size-from-1.
+void PoiStore_Reorder(size_t from, const std::vector<uint32_t>& order);
+
+// Index of a POI in g_poi_coords, or -1 when not present
+int PoiStore_IndexOf(uint32_t id);
+
+// Increases with every change to the POI list (positions, membership or order)
+uint32_t PoiStore_Revision();
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Scheduler
+ * ---------
+ * Millisecond timers for delayed actions inside the module.
+ * - Hashed timer wheel (one slot per millisecond, wrapping); schedule,
+ *   cancel and reschedule are O(1)
+ * - Monotonic clock (std::chrono::steady_clock), independent of sim time
+ * - Advanced by Scheduler_Tick from the per-frame system event, so timers fire
+ *   on the first frame at or after their deadline
+ * Callbacks run on the dispatch thread and may schedule or cancel timers.
+ */
+
+typedef uint32_t TimerHandle; // 0 is never a valid handle
+typedef void (*TimerCallback)(void* ctx);
+typedef uint64_t (*SchedulerClock)(); // milliseconds, monotonic
+
+// Runs cb(ctx) once, delayMs from now. Returns 0 when the timer table is full.
+TimerHandle Scheduler_Schedule(uint32_t delayMs, TimerCallback cb, void* ctx);
+
+// Stops a pending timer. Returns false when it already fired or was cancelled.
+bool Scheduler_Cancel(TimerHandle handle);
+
+// Moves a pending timer to delayMs from now. Returns false when it is not pending.
+bool Scheduler_Reschedule(TimerHandle handle, uint32_t delayMs);
+
+bool Scheduler_IsPending(TimerHandle handle);
+
+// Fires every timer whose deadline has passed. Call once per frame.
+void Scheduler_Tick();
+
+// Milliseconds on the scheduler's monotonic clock
+uint64_t Scheduler_NowMs();
+
+// Replaces the clock (nullptr restores steady_clock), e.g. so a host build
+// can advance time deterministically. Drops all pending timers.
+void Scheduler_SetClock(SchedulerClock clock);
+
+// The replacement clock, nullptr while on steady_clock
+SchedulerClock Scheduler_GetClock();
+
+// Drops all pending timers without firing them
+void Scheduler_Clear();
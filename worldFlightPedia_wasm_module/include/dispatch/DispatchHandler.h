@@ -1,6 +1,12 @@
 #pragma once
 
 #include <MSFS/MSFS.h>
+#include <MSFS/MSFS_WindowsTypes.h>
+#include <SimConnect.h>
 
-// Declaracin del callback
+// Registers the module's message, event and request handlers
+// (see dispatch/DispatchRegistry.h). Call before the first dispatch.
+void DispatchHandler_Initialize();
+
+// SimConnect dispatch callback (installed with SimConnect_CallDispatch)
 void CALLBACK MyDispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext);
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <MSFS/MSFS.h>
+#include <MSFS/MSFS_WindowsTypes.h>
+#include <SimConnect.h>
+
+/**
+ * DispatchRegistry
+ * ----------------
+ * Table-driven routing of SimConnect messages to handlers.
+ * - Event messages (EVENT, EVENT_FILENAME, EVENT_FRAME) are routed by
+ *   uEventID, request messages (SIMOBJECT_DATA, SIMOBJECT_DATA_BYTYPE,
+ *   ASSIGNED_OBJECT_ID) by dwRequestID, through flat arrays indexed by the id
+ * - Request ids above the flat table are matched against a few registered
+ *   ranges (e.g. one request id per marker spawn)
+ * - A message without an id handler goes to the handler registered for its
+ *   message kind, if any; otherwise it is ignored
+ * Request ids share one namespace (eRequests), whatever the message kind.
+ * Registration returns false (and logs) when the id does not fit the tables
+ * or is already taken.
+ */
+
+typedef void (*DispatchFn)(SIMCONNECT_RECV* pData, DWORD cbData);
+
+const DWORD DISPATCH_MAX_RECV_ID = 64;       // message kinds (SIMCONNECT_RECV_ID)
+const DWORD DISPATCH_MAX_EVENT_ID = 64;      // client event ids (eEvents)
+const DWORD DISPATCH_MAX_REQUEST_ID = 1024;  // request ids in the flat table (eRequests)
+const size_t DISPATCH_MAX_REQUEST_RANGES = 8;
+
+// Handler for every message of a kind that has no more specific handler
+bool DispatchRegistry_OnMessage(DWORD recvId, DispatchFn fn);
+
+bool DispatchRegistry_OnEvent(DWORD eventId, DispatchFn fn);
+
+bool DispatchRegistry_OnRequest(DWORD requestId, DispatchFn fn);
+
+// Request ids firstId..lastId (inclusive), for ids at or above DISPATCH_MAX_REQUEST_ID
+bool DispatchRegistry_OnRequestRange(DWORD firstId, DWORD lastId, DispatchFn fn);
+
+// Drops every handler
+void DispatchRegistry_Clear();
+
+// Routes one message to its handler
+void DispatchRegistry_Dispatch(SIMCONNECT_RECV* pData, DWORD cbData);
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+struct PoiParseResult;
+
+/**
+ * DispatchTrace
+ * -------------
+ * Opt-in capture of the module's input traffic to a binary file, and replay
+ * of such a file through the same handlers in a host build.
+ * - Capture records every message passed to MyDispatchProc and every
+ *   CommBus message passed to OnMessageFromJS, with its arrival time
+ * - Replay feeds the records back to DispatchRegistry_Dispatch and
+ *   OnMessageFromJS, paced by the live frame events: either at the recorded
+ *   speed, or the whole trace on the next frame (maximum speed)
+ * - While replaying, live SimConnect messages and live JS messages other
+ *   than TRACE are dropped, and the scheduler runs on the recorded time, so
+ *   timers fire as they did during the capture. Pending timers are dropped
+ *   when a replay starts and ends (see Scheduler_SetClock).
+ * Replay is only compiled into host builds (WFP_HOST_BUILD, see README, Host
+ * Builds), where the handlers talk to the SimConnect stand-in: in the sim,
+ * replayed creates and object ids would act on the live flight's objects.
+ * The MSFS build captures only; its StartReplay logs and returns false.
+ *
+ * File format (little endian):
+ *   header  "WFPTRACE", uint32 version, uint32 reserved
+ *   record  uint32 microseconds since the previous record (the first one:
+ *           since the capture started), uint32 payload size, uint8 kind
+ *           (eTraceKind), payload bytes
+ */
+
+enum eTraceKind
+{
+    TRACE_KIND_SIMCONNECT = 1, // SIMCONNECT_RECV message, as received
+    TRACE_KIND_COMMBUS = 2     // CommBus payload from JS, as received
+};
+
+struct TraceStats
+{
+    bool capturing;
+    bool replaying;
+    uint64_t records;  // captured or replayed so far (current / last run)
+    uint64_t bytes;    // payload bytes captured or replayed
+    uint64_t traceMs;  // recorded time covered so far
+};
+
+// Starts writing a new trace to path (truncated). Stops a running replay first.
+bool DispatchTrace_StartCapture(const char* path);
+
+// Writes out buffered records and closes the file
+void DispatchTrace_StopCapture();
+
+// Opens a trace for replay; records are delivered from the next live frame on.
+// Always false outside a host build.
+bool DispatchTrace_StartReplay(const char* path, bool maxSpeed);
+
+// True in a host build, where traces can be replayed
+bool DispatchTrace_CanReplay();
+
+// Stops a running replay; sends the summary to JS
+void DispatchTrace_StopReplay();
+
+// Delivers the records that are due. Called by MyDispatchProc for each live
+// frame event while replaying.
+void DispatchTrace_PumpReplay();
+
+// Appends one record while capturing (no-op otherwise)
+void DispatchTrace_Record(eTraceKind kind, const void* data, size_t size);
+
+bool DispatchTrace_IsCapturing();
+bool DispatchTrace_IsReplaying();
+
+// True while a replayed record is being handled (the message is not live)
+bool DispatchTrace_IsDelivering();
+
+void DispatchTrace_GetStats(TraceStats* stats);
+
+// Stops capture and replay (module deinit)
+void DispatchTrace_Shutdown();
+
+// { "type": "TRACE", "enabled": true } captures to TRACE_FILE_PATH, replacing
+// the previous trace; "enabled": false stops the capture or a running replay.
+// False for a missing or invalid "enabled".
+bool DispatchTrace_OnTraceMessage(PoiParseResult& msg);
+
+// { "type": "TRACE_REPLAY", "maxSpeed": false } replays TRACE_FILE_PATH from
+// the next frame on; the end is reported with
+// { "type": "TRACE", "event": "REPLAY_DONE", ... } (host builds only)
+bool DispatchTrace_OnReplayMessage(PoiParseResult& msg);
@@ -1,13 +1,38 @@
 ﻿#pragma once
+#include <cstdint>
+
+struct PoiParseResult;
 
 // Public interface of the Flight Controller
 
-// Called when L:WFP_StartFlight changes (0 -> stop, 1 -> start)
+// Called when L:WFP_StartFlight changes (0 -> stop, 1 -> start); registered in the L:Var watch table
 void FlightController_OnStartFlight(double newValue);
 
-// Called when L:WFP_NextPoi changes (1 -> advance to next POI)
+// Called when L:WFP_NextPoi rises to 1 (advance to next POI); registered in the L:Var watch table
 void FlightController_OnNextPoi(double newValue);
 
-// Called periodically to handle time-based operations (e.g., sound reset timers)
-// Should be called from the dispatch callback to check if timers have expired
-void FlightController_Update();
+// Called by the geofence engine on arrival at POI[index] (active or a later one)
+void FlightController_OnPoiArrived(int index);
+
+// Continues a flight restored by the tour snapshot (flight/TourSnapshot.h)
+void FlightController_Resume();
+
+// Per-frame tick: keeps the lookahead window in line with the tour after POI
+// list changes (uploads, reorders) and flight start / stop
+void FlightController_OnFrame();
+
+// Lookahead: the markers of the next 'depth' POIs are created ahead of time
+// and parked out of sight, so advancing only raises the next one. At most
+// 'budget' markers are parked; depth 0 turns it off.
+struct MarkerLookaheadConfig
+{
+    uint32_t depth;
+    uint32_t budget;
+};
+
+void FlightController_SetLookahead(const MarkerLookaheadConfig& config);
+MarkerLookaheadConfig FlightController_GetLookahead();
+
+// { "type": "MARKER_LOOKAHEAD", "depth": 3, "budget": 8 }
+// Missing keys keep their current value; false for an invalid parameter.
+bool FlightController_OnLookaheadMessage(PoiParseResult& msg);
\ No newline at end of file
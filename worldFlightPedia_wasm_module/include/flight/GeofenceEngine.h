@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+struct PoiParseResult;
+
+/**
+ * GeofenceEngine
+ * --------------
+ * Arrival detection for the automated POI flight, evaluated inside the module
+ * on every user position sample (sim frame rate).
+ * Responsibilities:
+ *  - Circular fences around the active POI and the next few POIs (lookahead)
+ *  - Hysteresis: a fence is entered inside enterMeters and only left again
+ *    beyond exitMeters, so GPS-like jitter at the edge causes no event storm
+ *  - Within arrivalMeters (inside the fence) the POI counts as reached: the
+ *    flight advances past it (FlightController_OnPoiArrived) and JS is
+ *    notified over CommBus. Entering the fence alone does not advance, so the
+ *    marker stays up until the aircraft is actually there
+ * Events sent on "OnMessageFromWasm":
+ *   {"type":"GEOFENCE","event":"ENTER"|"EXIT","id":7,"index":3,"meters":412}
+ *   {"type":"POI_ARRIVED","id":7,"index":3,"active":4}
+ */
+
+void Geofence_OnUserPosition(double latDeg, double lonDeg);
+
+// Fences are rebuilt from the active POI on the next sample
+void Geofence_Reset();
+
+struct GeofenceConfig
+{
+    bool enabled;
+    double enterMeters;   // <= 0 falls back to GEOFENCE_ENTER_METERS
+    double exitMeters;    // raised to at least enterMeters
+    double arrivalMeters; // <= 0 falls back to GEOFENCE_ARRIVAL_METERS, capped at enterMeters
+    uint32_t lookahead;   // fenced POIs after the active one, capped at GEOFENCE_MAX_LOOKAHEAD
+};
+
+void Geofence_SetConfig(const GeofenceConfig& config);
+GeofenceConfig Geofence_GetConfig();
+
+// { "type": "GEOFENCE", "enabled": true, "radius": 500, "exitRadius": 800, "arrivalRadius": 200, "lookahead": 3 }
+// Missing keys keep their current value; false for an invalid parameter.
+bool Geofence_OnMessage(PoiParseResult& msg);
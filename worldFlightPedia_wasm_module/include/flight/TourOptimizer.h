@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "core/PoiColumns.h"
+
+struct PoiParseResult;
+
+/**
+ * TourOptimizer
+ * -------------
+ * Orders the POI tour so the flight does not zig-zag between POIs.
+ * - Open path (the flight does not return to its start), optionally anchored
+ *   at a fixed start point (aircraft position, or the active POI mid-flight)
+ * - Nearest-neighbour construction, then 2-opt and Or-opt (segments of up to
+ *   three POIs, either direction) over the 8 nearest neighbours of each POI
+ * - Stops at the time budget, which covers the whole run (neighbour search
+ *   and seed included); the best tour so far is always valid. The input
+ *   order is kept when the optimized one is not shorter.
+ * Runs synchronously on the calling (dispatch) thread, so the default budget
+ * fits inside a sim frame.
+ * Distances are great-circle on a sphere of mean Earth radius.
+ */
+
+struct TourStats
+{
+    double inputMeters;   // length in the given order
+    double seedMeters;    // after nearest-neighbour construction
+    double meters;        // length of the returned order
+    uint32_t twoOptMoves;
+    uint32_t orOptMoves;
+    double elapsedMs;
+    bool budgetExhausted; // stopped by the budget before reaching a local optimum
+};
+
+// Orders POIs [first, size) of 'pois'. order[i] receives the offset (from
+// 'first') of the POI to visit i-th. With hasStart the path begins at
+// (startLat, startLon); without it any POI may come first.
+void TourOptimizer_Solve(const PoiColumns& pois, size_t first, bool hasStart, double startLat, double startLon,
+    uint32_t budgetMs, std::vector<uint32_t>& order, TourStats& stats);
+
+// Reorders the POI store: the whole tour, or only the POIs after the active
+// one during a flight. Starts at the aircraft (when enabled and its position
+// is known) or at the active POI. Sends the new order to JS:
+//   {"type":"TOUR_ORDER","requestId":1,"from":0,"ids":[...],"meters":..,"inputMeters":..,"ms":..}
+void TourOptimizer_OptimizeTour(uint32_t requestId);
+
+struct TourOptimizerConfig
+{
+    bool enabled;      // optimize automatically on START FLIGHT (off by default)
+    bool fromAircraft; // start at the aircraft when its position is known
+    uint32_t budgetMs; // 0 counts as 1
+};
+
+void TourOptimizer_SetConfig(const TourOptimizerConfig& config);
+TourOptimizerConfig TourOptimizer_GetConfig();
+
+// { "type": "TOUR_OPTIMIZER", "enabled": true, "fromAircraft": true, "budgetMs": 100 }
+// Missing keys keep their current value; false for an invalid parameter.
+bool TourOptimizer_OnConfigMessage(PoiParseResult& msg);
+
+// { "type": "TOUR_OPTIMIZE", "requestId": 1 } runs TourOptimizer_OptimizeTour now
+bool TourOptimizer_OnOptimizeMessage(PoiParseResult& msg);
@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * TourSnapshot
+ * ------------
+ * Keeps the tour (POI list in tour order, active POI, flight on/off) in a
+ * binary file in the module's work folder, so it survives a module reload or
+ * flight restart without JS re-sending it.
+ * - TourSnapshot_OnFrame notices changes (PoiStore_Revision, g_activePoiIndex,
+ *   g_flightActive) and writes the file TOUR_SNAPSHOT_SAVE_DELAY_MS later, so a
+ *   burst of POI messages costs one write. The file is written under a
+ *   temporary name and renamed over the previous snapshot; when only the
+ *   active POI or the flight state changed, just the header is rewritten.
+ * - TourSnapshot_Load reads the whole file with one read, checks it and
+ *   replaces the POI store; a restored active flight is resumed
+ *   (FlightController_Resume). JS is told with
+ *     {"type":"TOUR_RESTORED","count":250,"active":12,"flightActive":true}
+ *   A missing, corrupt or older-version file is ignored.
+ *
+ * File format (little endian):
+ *   header  "WFPTOUR\0", uint32 version, uint32 count, int32 active index,
+ *           uint32 flags (bit 0: flight active), uint32 FNV-1a checksum of
+ *           the payload followed by the header fields from version to flags
+ *   payload uint32 ids[count], float64 lat[count], float64 lon[count]
+ */
+
+// Restores the tour; call once SimConnect and the CommBus are set up.
+// Returns false when there was nothing (valid) to restore.
+bool TourSnapshot_Load();
+
+// Schedules a write when the tour changed since the last one (once per frame)
+void TourSnapshot_OnFrame();
+
+// Writes a pending change now (module deinit)
+void TourSnapshot_Flush();
@@ -0,0 +1,387 @@
+#pragma once
+#include <cmath>
+
+/**
+ * Geodesy
+ * -------
+ * Header-only geodesic math for the whole module, every operation in two
+ * modes:
+ *  - GEO_FAST   sphere with the mean earth radius: closed forms, a handful of
+ *               trig calls, errors up to ~0.5% of the distance
+ *  - GEO_EXACT  WGS-84 ellipsoid: Vincenty's inverse / direct formulas
+ *               (iterated on the auxiliary sphere, ~0.1 mm) and ECEF for the
+ *               local offsets
+ * Operations:
+ *  - Geo_Inverse        distance, initial and final bearing between two points
+ *  - Geo_Direct         destination from a start point, bearing and distance
+ *  - Geo_EnuToGeodetic  point at an east / north / up offset from an origin
+ *  - Geo_GeodeticToEnu  ...and the offset of a point from an origin
+ *  - Geo_Interpolate    point at a fraction of the way along the geodesic
+ * Degrees and meters throughout; bearings are true, in [0, 360); longitudes
+ * come back in [-180, 180]. GEO_FAST uses the same sphere as PoiKernels and
+ * PoiSpatialIndex, so its distances match theirs.
+ * The Vincenty inverse does not converge for nearly antipodal points; it then
+ * falls back to GEO_FAST and reports converged = false.
+ */
+
+constexpr double GEO_PI = 3.14159265358979323846;
+constexpr double GEO_DEG_TO_RAD = GEO_PI / 180.0;
+constexpr double GEO_RAD_TO_DEG = 180.0 / GEO_PI;
+
+constexpr double GEO_MEAN_RADIUS_METERS = 6371008.8; // IUGG mean earth radius (GEO_FAST sphere)
+constexpr double GEO_WGS84_A = 6378137.0;            // semi-major axis, meters
+constexpr double GEO_WGS84_F = 1.0 / 298.257223563;  // flattening
+constexpr double GEO_WGS84_B = GEO_WGS84_A * (1.0 - GEO_WGS84_F);
+constexpr double GEO_WGS84_E2 = GEO_WGS84_F * (2.0 - GEO_WGS84_F); // first eccentricity squared
+
+enum eGeoMode
+{
+    GEO_FAST = 0, // sphere
+    GEO_EXACT     // WGS-84 ellipsoid
+};
+
+struct GeoPoint
+{
+    double latDeg;
+    double lonDeg;
+};
+
+struct GeoPosition
+{
+    double latDeg;
+    double lonDeg;
+    double altMeters; // above the sphere / ellipsoid
+};
+
+// Local tangent plane offset, meters
+struct GeoEnu
+{
+    double east;
+    double north;
+    double up;
+};
+
+struct GeoInverseResult
+{
+    double meters;
+    double bearingDeg;      // initial bearing at the first point
+    double finalBearingDeg; // bearing on arrival at the second point
+    bool converged;         // false: GEO_EXACT fell back to GEO_FAST (nearly antipodal)
+};
+
+inline double Geo_WrapLon(double lonDeg)
+{
+    lonDeg = std::fmod(lonDeg + 180.0, 360.0);
+    return (lonDeg < 0.0 ? lonDeg + 360.0 : lonDeg) - 180.0;
+}
+
+inline double Geo_WrapBearing(double bearingDeg)
+{
+    bearingDeg = std::fmod(bearingDeg, 360.0);
+    return bearingDeg < 0.0 ? bearingDeg + 360.0 : bearingDeg;
+}
+
+// -----------------------------------------------------------------------------
+// Sphere
+// -----------------------------------------------------------------------------
+inline GeoInverseResult GeoSphere_Inverse(double lat1, double lon1, double lat2, double lon2)
+{
+    double p1 = lat1 * GEO_DEG_TO_RAD;
+    double p2 = lat2 * GEO_DEG_TO_RAD;
+    double dLon = Geo_WrapLon(lon2 - lon1) * GEO_DEG_TO_RAD;
+    double sinP1 = std::sin(p1), cosP1 = std::cos(p1);
+    double sinP2 = std::sin(p2), cosP2 = std::cos(p2);
+    double sinDLon = std::sin(dLon), cosDLon = std::cos(dLon);
+
+    // Haversine of the central angle
+    double sinHalfDLat = std::sin((p2 - p1) * 0.5);
+    double sinHalfDLon = std::sin(dLon * 0.5);
+    double h = sinHalfDLat * sinHalfDLat + cosP1 * cosP2 * sinHalfDLon * sinHalfDLon;
+
+    GeoInverseResult r;
+    r.meters = 2.0 * GEO_MEAN_RADIUS_METERS * std::atan2(std::sqrt(h), std::sqrt(1.0 - h));
+    r.bearingDeg = Geo_WrapBearing(std::atan2(sinDLon * cosP2, cosP1 * sinP2 - sinP1 * cosP2 * cosDLon) * GEO_RAD_TO_DEG);
+    r.finalBearingDeg = Geo_WrapBearing(std::atan2(sinDLon * cosP1, -sinP1 * cosP2 + cosP1 * sinP2 * cosDLon) * GEO_RAD_TO_DEG);
+    r.converged = true;
+    return r;
+}
+
+inline GeoPoint GeoSphere_Direct(double lat, double lon, double bearingDeg, double meters, double* finalBearingDeg)
+{
+    double p1 = lat * GEO_DEG_TO_RAD;
+    double b = bearingDeg * GEO_DEG_TO_RAD;
+    double d = meters / GEO_MEAN_RADIUS_METERS;
+    double sinP1 = std::sin(p1), cosP1 = std::cos(p1);
+    double sinB = std::sin(b), cosB = std::cos(b);
+    double sinD = std::sin(d), cosD = std::cos(d);
+
+    double sinP2 = sinP1 * cosD + cosP1 * sinD * cosB;
+    double p2 = std::asin(sinP2 > 1.0 ? 1.0 : (sinP2 < -1.0 ? -1.0 : sinP2));
+    double dLon = std::atan2(sinB * sinD * cosP1, cosD - sinP1 * sinP2);
+
+    if (finalBearingDeg)
+        *finalBearingDeg = Geo_WrapBearing(std::atan2(sinB * cosP1, cosP1 * cosD * cosB - sinP1 * sinD) * GEO_RAD_TO_DEG);
+
+    GeoPoint out;
+    out.latDeg = p2 * GEO_RAD_TO_DEG;
+    out.lonDeg = Geo_WrapLon(lon + dLon * GEO_RAD_TO_DEG);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// WGS-84 (Vincenty 1975; A and B with Vincenty's 1976 simplification)
+// -----------------------------------------------------------------------------
+inline void GeoEllipsoid_Series(double cos2Alpha, double* A, double* B)
+{
+    double u2 = cos2Alpha * (GEO_WGS84_A * GEO_WGS84_A - GEO_WGS84_B * GEO_WGS84_B) / (GEO_WGS84_B * GEO_WGS84_B);
+    double k1 = (std::sqrt(1.0 + u2) - 1.0) / (std::sqrt(1.0 + u2) + 1.0);
+    *A = (1.0 + 0.25 * k1 * k1) / (1.0 - k1);
+    *B = k1 * (1.0 - 0.375 * k1 * k1);
+}
+
+inline double GeoEllipsoid_DeltaSigma(double B, double sinSigma, double cosSigma, double cos2SigmaM)
+{
+    double c2 = cos2SigmaM * cos2SigmaM;
+    return B * sinSigma * (cos2SigmaM + B / 4.0 * (cosSigma * (-1.0 + 2.0 * c2) -
+        B / 6.0 * cos2SigmaM * (-3.0 + 4.0 * sinSigma * sinSigma) * (-3.0 + 4.0 * c2)));
+}
+
+inline GeoInverseResult GeoEllipsoid_Inverse(double lat1, double lon1, double lat2, double lon2)
+{
+    const double f = GEO_WGS84_F;
+    double L = Geo_WrapLon(lon2 - lon1) * GEO_DEG_TO_RAD;
+    double tanU1 = (1.0 - f) * std::tan(lat1 * GEO_DEG_TO_RAD);
+    double tanU2 = (1.0 - f) * std::tan(lat2 * GEO_DEG_TO_RAD);
+    double cosU1 = 1.0 / std::sqrt(1.0 + tanU1 * tanU1), sinU1 = tanU1 * cosU1;
+    double cosU2 = 1.0 / std::sqrt(1.0 + tanU2 * tanU2), sinU2 = tanU2 * cosU2;
+
+    double lambda = L;
+    double sinLambda = 0.0, cosLambda = 1.0;
+    double sinSigma = 0.0, cosSigma = 1.0, sigma = 0.0;
+    double cos2Alpha = 1.0, cos2SigmaM = 0.0;
+    bool converged = false;
+    for (int i = 0; i < 200; ++i)
+    {
+        sinLambda = std::sin(lambda);
+        cosLambda = std::cos(lambda);
+        double t1 = cosU2 * sinLambda;
+        double t2 = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+        sinSigma = std::sqrt(t1 * t1 + t2 * t2);
+        if (sinSigma == 0.0)
+        {
+            // Same point
+            GeoInverseResult r = { 0.0, 0.0, 0.0, true };
+            return r;
+        }
+        cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+        sigma = std::atan2(sinSigma, cosSigma);
+        double sinAlpha = cosU1 * cosU2 * sinLambda / sinSigma;
+        cos2Alpha = 1.0 - sinAlpha * sinAlpha;
+        cos2SigmaM = cos2Alpha != 0.0 ? cosSigma - 2.0 * sinU1 * sinU2 / cos2Alpha : 0.0; // 0 on the equator
+        double C = f / 16.0 * cos2Alpha * (4.0 + f * (4.0 - 3.0 * cos2Alpha));
+        double previous = lambda;
+        lambda = L + (1.0 - C) * f * sinAlpha *
+            (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+        if (std::fabs(lambda) > GEO_PI)
+            break; // nearly antipodal, no solution this way
+        if (std::fabs(lambda - previous) < 1e-12)
+        {
+            converged = true;
+            break;
+        }
+    }
+
+    if (!converged)
+    {
+        GeoInverseResult r = GeoSphere_Inverse(lat1, lon1, lat2, lon2);
+        r.converged = false;
+        return r;
+    }
+
+    double A, B;
+    GeoEllipsoid_Series(cos2Alpha, &A, &B);
+
+    GeoInverseResult r;
+    r.meters = GEO_WGS84_B * A * (sigma - GeoEllipsoid_DeltaSigma(B, sinSigma, cosSigma, cos2SigmaM));
+    r.bearingDeg = Geo_WrapBearing(std::atan2(cosU2 * sinLambda, cosU1 * sinU2 - sinU1 * cosU2 * cosLambda) * GEO_RAD_TO_DEG);
+    r.finalBearingDeg = Geo_WrapBearing(std::atan2(cosU1 * sinLambda, -sinU1 * cosU2 + cosU1 * sinU2 * cosLambda) * GEO_RAD_TO_DEG);
+    r.converged = true;
+    return r;
+}
+
+inline GeoPoint GeoEllipsoid_Direct(double lat, double lon, double bearingDeg, double meters, double* finalBearingDeg)
+{
+    const double f = GEO_WGS84_F;
+    double alpha1 = bearingDeg * GEO_DEG_TO_RAD;
+    double sinAlpha1 = std::sin(alpha1), cosAlpha1 = std::cos(alpha1);
+    double tanU1 = (1.0 - f) * std::tan(lat * GEO_DEG_TO_RAD);
+    double cosU1 = 1.0 / std::sqrt(1.0 + tanU1 * tanU1), sinU1 = tanU1 * cosU1;
+
+    double sigma1 = std::atan2(tanU1, cosAlpha1);
+    double sinAlpha = cosU1 * sinAlpha1;
+    double cos2Alpha = 1.0 - sinAlpha * sinAlpha;
+    double A, B;
+    GeoEllipsoid_Series(cos2Alpha, &A, &B);
+
+    double sigma0 = meters / (GEO_WGS84_B * A);
+    double sigma = sigma0;
+    double sinSigma = 0.0, cosSigma = 1.0, cos2SigmaM = 0.0;
+    for (int i = 0; i < 100; ++i)
+    {
+        cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+        sinSigma = std::sin(sigma);
+        cosSigma = std::cos(sigma);
+        double previous = sigma;
+        sigma = sigma0 + GeoEllipsoid_DeltaSigma(B, sinSigma, cosSigma, cos2SigmaM);
+        if (std::fabs(sigma - previous) < 1e-12)
+            break;
+    }
+    cos2SigmaM = std::cos(2.0 * sigma1 + sigma);
+    sinSigma = std::sin(sigma);
+    cosSigma = std::cos(sigma);
+
+    double x = sinU1 * sinSigma - cosU1 * cosSigma * cosAlpha1;
+    double lat2 = std::atan2(sinU1 * cosSigma + cosU1 * sinSigma * cosAlpha1, (1.0 - f) * std::sqrt(sinAlpha * sinAlpha + x * x));
+    double lambda = std::atan2(sinSigma * sinAlpha1, cosU1 * cosSigma - sinU1 * sinSigma * cosAlpha1);
+    double C = f / 16.0 * cos2Alpha * (4.0 + f * (4.0 - 3.0 * cos2Alpha));
+    double L = lambda - (1.0 - C) * f * sinAlpha *
+        (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1.0 + 2.0 * cos2SigmaM * cos2SigmaM)));
+
+    if (finalBearingDeg)
+        *finalBearingDeg = Geo_WrapBearing(std::atan2(sinAlpha, -x) * GEO_RAD_TO_DEG);
+
+    GeoPoint out;
+    out.latDeg = lat2 * GEO_RAD_TO_DEG;
+    out.lonDeg = Geo_WrapLon(lon + L * GEO_RAD_TO_DEG);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Earth-centered, earth-fixed coordinates (sphere: e2 = 0, a = mean radius)
+// -----------------------------------------------------------------------------
+inline void Geo_ToEcef(const GeoPosition& p, eGeoMode mode, double ecef[3])
+{
+    double a = mode == GEO_EXACT ? GEO_WGS84_A : GEO_MEAN_RADIUS_METERS;
+    double e2 = mode == GEO_EXACT ? GEO_WGS84_E2 : 0.0;
+    double lat = p.latDeg * GEO_DEG_TO_RAD, lon = p.lonDeg * GEO_DEG_TO_RAD;
+    double sinLat = std::sin(lat), cosLat = std::cos(lat);
+    double n = a / std::sqrt(1.0 - e2 * sinLat * sinLat); // prime vertical radius
+
+    ecef[0] = (n + p.altMeters) * cosLat * std::cos(lon);
+    ecef[1] = (n + p.altMeters) * cosLat * std::sin(lon);
+    ecef[2] = (n * (1.0 - e2) + p.altMeters) * sinLat;
+}
+
+inline GeoPosition Geo_FromEcef(const double ecef[3], eGeoMode mode)
+{
+    double a = mode == GEO_EXACT ? GEO_WGS84_A : GEO_MEAN_RADIUS_METERS;
+    double e2 = mode == GEO_EXACT ? GEO_WGS84_E2 : 0.0;
+    double p = std::sqrt(ecef[0] * ecef[0] + ecef[1] * ecef[1]);
+
+    // Fixed point on the latitude; each pass gains about a factor e2, so a
+    // few passes reach double precision (one for the sphere)
+    double lat = std::atan2(ecef[2], p * (1.0 - e2));
+    double sinLat = std::sin(lat);
+    for (int i = 0; i < 8 && e2 != 0.0; ++i)
+    {
+        double n = a / std::sqrt(1.0 - e2 * sinLat * sinLat);
+        double next = std::atan2(ecef[2] + e2 * n * sinLat, p);
+        bool done = std::fabs(next - lat) < 1e-14;
+        lat = next;
+        sinLat = std::sin(lat);
+        if (done)
+            break;
+    }
+
+    GeoPosition out;
+    out.latDeg = lat * GEO_RAD_TO_DEG;
+    out.lonDeg = std::atan2(ecef[1], ecef[0]) * GEO_RAD_TO_DEG;
+    // Height along the normal, stable at the poles as well
+    out.altMeters = p * std::cos(lat) + ecef[2] * sinLat - a * std::sqrt(1.0 - e2 * sinLat * sinLat);
+    return out;
+}
+
+// -----------------------------------------------------------------------------
+// Public operations
+// -----------------------------------------------------------------------------
+inline GeoInverseResult Geo_Inverse(double lat1, double lon1, double lat2, double lon2, eGeoMode mode = GEO_FAST)
+{
+    return mode == GEO_EXACT ? GeoEllipsoid_Inverse(lat1, lon1, lat2, lon2) : GeoSphere_Inverse(lat1, lon1, lat2, lon2);
+}
+
+inline GeoPoint Geo_Direct(double lat, double lon, double bearingDeg, double meters, eGeoMode mode = GEO_FAST, double* finalBearingDeg = nullptr)
+{
+    return mode == GEO_EXACT ? GeoEllipsoid_Direct(lat, lon, bearingDeg, meters, finalBearingDeg)
+                             : GeoSphere_Direct(lat, lon, bearingDeg, meters, finalBearingDeg);
+}
+
+inline GeoPosition Geo_EnuToGeodetic(const GeoPosition& origin, const GeoEnu& offset, eGeoMode mode = GEO_FAST)
+{
+    double lat = origin.latDeg * GEO_DEG_TO_RAD, lon = origin.lonDeg * GEO_DEG_TO_RAD;
+    double sinLat = std::sin(lat), cosLat = std::cos(lat);
+    double sinLon = std::sin(lon), cosLon = std::cos(lon);
+
+    double ecef[3];
+    Geo_ToEcef(origin, mode, ecef);
+    ecef[0] += -sinLon * offset.east - sinLat * cosLon * offset.north + cosLat * cosLon * offset.up;
+    ecef[1] += cosLon * offset.east - sinLat * sinLon * offset.north + cosLat * sinLon * offset.up;
+    ecef[2] += cosLat * offset.north + sinLat * offset.up;
+    return Geo_FromEcef(ecef, mode);
+}
+
+inline GeoEnu Geo_GeodeticToEnu(const GeoPosition& origin, const GeoPosition& point, eGeoMode mode = GEO_FAST)
+{
+    double lat = origin.latDeg * GEO_DEG_TO_RAD, lon = origin.lonDeg * GEO_DEG_TO_RAD;
+    double sinLat = std::sin(lat), cosLat = std::cos(lat);
+    double sinLon = std::sin(lon), cosLon = std::cos(lon);
+
+    double o[3], p[3];
+    Geo_ToEcef(origin, mode, o);
+    Geo_ToEcef(point, mode, p);
+    double dx = p[0] - o[0], dy = p[1] - o[1], dz = p[2] - o[2];
+
+    GeoEnu out;
+    out.east = -sinLon * dx + cosLon * dy;
+    out.north = -sinLat * cosLon * dx - sinLat * sinLon * dy + cosLat * dz;
+    out.up = cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+    return out;
+}
+
+// fraction 0 is the first point, 1 the second. GEO_FAST interpolates the
+// unit vectors along the great circle; GEO_EXACT walks the geodesic
+// (inverse, then direct with fraction * distance). Where the inverse does not
+// converge (nearly antipodal), GEO_EXACT interpolates like GEO_FAST: the
+// spherical bearing would lead the ellipsoidal direct off the line.
+inline GeoPoint Geo_Interpolate(double lat1, double lon1, double lat2, double lon2, double fraction, eGeoMode mode = GEO_FAST)
+{
+    if (mode == GEO_EXACT)
+    {
+        GeoInverseResult inv = GeoEllipsoid_Inverse(lat1, lon1, lat2, lon2);
+        if (inv.converged)
+            return GeoEllipsoid_Direct(lat1, lon1, inv.bearingDeg, inv.meters * fraction, nullptr);
+    }
+
+    GeoPosition a = { lat1, lon1, 0.0 }, b = { lat2, lon2, 0.0 };
+    double va[3], vb[3];
+    Geo_ToEcef(a, GEO_FAST, va);
+    Geo_ToEcef(b, GEO_FAST, vb);
+
+    double dot = (va[0] * vb[0] + va[1] * vb[1] + va[2] * vb[2]) / (GEO_MEAN_RADIUS_METERS * GEO_MEAN_RADIUS_METERS);
+    double angle = std::acos(dot > 1.0 ? 1.0 : (dot < -1.0 ? -1.0 : dot));
+    double sinAngle = std::sin(angle);
+    if (sinAngle < 1e-12)
+    {
+        // Same point (or antipodal, where any great circle will do)
+        GeoInverseResult inv = GeoSphere_Inverse(lat1, lon1, lat2, lon2);
+        return GeoSphere_Direct(lat1, lon1, inv.bearingDeg, inv.meters * fraction, nullptr);
+    }
+
+    double wa = std::sin((1.0 - fraction) * angle) / sinAngle;
+    double wb = std::sin(fraction * angle) / sinAngle;
+    double v[3] = { wa * va[0] + wb * vb[0], wa * va[1] + wb * vb[1], wa * va[2] + wb * vb[2] };
+
+    GeoPoint out;
+    out.latDeg = std::atan2(v[2], std::sqrt(v[0] * v[0] + v[1] * v[1])) * GEO_RAD_TO_DEG;
+    out.lonDeg = std::atan2(v[1], v[0]) * GEO_RAD_TO_DEG;
+    return out;
+}
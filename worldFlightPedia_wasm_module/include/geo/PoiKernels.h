@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include "core/PoiColumns.h"
+
+/**
+ * PoiKernels
+ * ----------
+ * Batch distance / bearing from one point to a range of POIs, reading the
+ * precomputed unit vectors of PoiColumns.
+ * - Per-POI work is a few multiply-adds on vector registers (wasm simd128
+ *   when built with -msimd128, AVX or SSE2 on x86, scalar otherwise), then
+ *   one asin / atan2 per POI for the final value
+ * - Results are written to out[0 .. count), out[i] belonging to POI first + i
+ * Distances are great-circle on a sphere of mean Earth radius.
+ */
+
+// Great-circle meters from (latDeg, lonDeg) to POIs [first, first + count)
+void PoiKernels_Distances(const PoiColumns& pois, size_t first, size_t count, double latDeg, double lonDeg, double* outMeters);
+
+// Initial great-circle bearing in degrees true [0, 360) from (latDeg, lonDeg) to POIs [first, first + count)
+void PoiKernels_Bearings(const PoiColumns& pois, size_t first, size_t count, double latDeg, double lonDeg, double* outDegrees);
+
+// Squared chord length on the unit sphere: grows with distance, so it ranks
+// and thresholds POIs without any transcendental function per POI
+void PoiKernels_ChordSq(const PoiColumns& pois, size_t first, size_t count, double latDeg, double lonDeg, double* outChordSq);
+
+// Instruction set the kernels were compiled for ("simd128", "avx", "sse2" or "scalar")
+const char* PoiKernels_Isa();
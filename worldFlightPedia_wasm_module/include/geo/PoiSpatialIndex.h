@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * PoiSpatialIndex
+ * ---------------
+ * Geospatial index over the POI store for proximity queries inside the module.
+ * - Lat/lon grid of 0.1 degree cells, stored sparsely (only non-empty cells)
+ * - Each entry keeps its unit-sphere vector so distance tests are a few
+ *   multiply-adds; meters are only computed for the final results
+ * - Kept in sync incrementally by PoiStore (no full rebuild per message)
+ * Distances are great-circle on a sphere of mean Earth radius.
+ * Any input is safe: a NaN or out-of-range POI is kept in an edge cell, and a
+ * query from a NaN or out-of-range point or radius returns nothing.
+ */
+
+struct PoiHit
+{
+    uint32_t id;
+    double meters;
+};
+
+void PoiIndex_Clear();
+void PoiIndex_Upsert(uint32_t id, double lat, double lon);
+void PoiIndex_Remove(uint32_t id);
+size_t PoiIndex_Size();
+
+// The k POIs closest to (lat, lon), closest first. 'out' is cleared.
+void PoiIndex_Nearest(double lat, double lon, size_t k, std::vector<PoiHit>& out);
+
+// All POIs within radiusMeters of (lat, lon), closest first. 'out' is cleared.
+void PoiIndex_Radius(double lat, double lon, double radiusMeters, std::vector<PoiHit>& out);
+
+// True if a POI other than excludeId lies within radiusMeters of (lat, lon)
+bool PoiIndex_AnyWithin(double lat, double lon, double radiusMeters, uint32_t excludeId);
+
+// Walks the store in tour order and reports every POI lying within
+// radiusMeters of an earlier POI that was kept. 'duplicates' is cleared.
+void PoiIndex_FindDuplicates(double radiusMeters, std::vector<uint32_t>& duplicates);
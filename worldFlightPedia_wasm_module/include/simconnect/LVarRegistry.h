@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * LVarRegistry
+ * ------------
+ * Declarative watch list for L:Vars.
+ * Responsibilities:
+ *  - Pack every watched L:Var into one data definition (one FLOAT64 per entry,
+ *    in table order) and subscribe to it once per sim frame, on change only
+ *  - Keep the last value of each entry and detect edges centrally
+ *  - Invoke the entry's callback when its edge fires
+ * Callbacks run from the dispatch callback and receive the new value.
+ */
+
+enum eLVarEdge
+{
+    LVAR_EDGE_CHANGE = 0, // any change of value
+    LVAR_EDGE_RISING,     // off (< 0.5) -> on (>= 0.5)
+    LVAR_EDGE_FALLING     // on -> off
+};
+
+typedef void (*LVarCallback)(double value);
+
+struct LVarWatch
+{
+    const char* name;  // e.g. "L:WFP_StartFlight"
+    const char* units; // e.g. "Bool"
+    eLVarEdge edge;
+    LVarCallback onEdge;
+};
+
+// Defines and subscribes the table. The table must outlive the registry
+// (use a static array). Returns false when SimConnect rejects the request.
+bool LVarRegistry_Initialize(const LVarWatch* table, size_t count);
+
+// Route SIMOBJECT_DATA for REQUEST_LVAR_WATCH (data = packed FLOAT64 values)
+void LVarRegistry_OnData(const void* data, size_t size);
+
+// Records value as the last sample of the named entry, so a sample with that
+// value fires no edge (state restored without going through the L:Var).
+// Returns false for a name that is not watched.
+bool LVarRegistry_SetLastValue(const char* name, double value);
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Telemetry
+ * ---------
+ * Cache of the user aircraft state, shared by every consumer (geofences,
+ * marker streaming, tour start, cube spawns, emitter follow).
+ * Responsibilities:
+ *  - Define the user-state struct once (DEFINITION_USER_STATE) and subscribe
+ *    to it once per sim frame, on change only
+ *  - Keep the latest sample with the time it arrived
+ * Consumers read the cache synchronously with Telemetry_Get; nothing waits for
+ * a SimConnect round trip. While the aircraft stands still the sim sends
+ * nothing, so sampleMs is the time of the last change, not of the last frame.
+ */
+
+struct AircraftState
+{
+    double latDeg;
+    double lonDeg;
+    double altMeters;            // above mean sea level
+    double altAboveGroundMeters;
+    double headingTrueDeg;
+    double groundSpeedMps;
+    double trackTrueDeg;         // direction of travel over the ground
+    double verticalSpeedMps;
+    uint64_t sampleMs;           // Scheduler_NowMs() when the sample arrived
+};
+
+// Defines and subscribes the user-state struct. Returns false when SimConnect
+// rejects the definition or the request.
+bool Telemetry_Initialize();
+
+// Route SIMOBJECT_DATA for REQUEST_USER_STATE (data = the packed struct).
+// Returns false for a short sample, which is ignored.
+bool Telemetry_OnData(const void* data, size_t size);
+
+// Copies the latest state. Returns false until the first sample arrived.
+bool Telemetry_Get(AircraftState* state);
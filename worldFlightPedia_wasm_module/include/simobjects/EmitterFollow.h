@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <MSFS/MSFS_WindowsTypes.h>
+
+struct PoiParseResult;
+
+/**
+ * EmitterFollow
+ * -------------
+ * Keeps the cube (the sound emitter spawned by SpawnCubeNearAircraft) at its
+ * offset next to the user aircraft.
+ * - The target position is dead reckoned: the last telemetry sample is
+ *   extrapolated along its track, ground speed and vertical speed to the
+ *   current frame
+ * - The cube is only moved (SetDataOnSimObject on DEFINITION_EMITTER_POSITION)
+ *   when it is further than the tolerance from that target, not every frame
+ * - A move places it slightly ahead along the velocity, so the aircraft
+ *   catches up with it before it falls behind again
+ * Only the most recent cube follows; an older one stays where it is.
+ */
+
+struct EmitterFollowConfig
+{
+    bool enabled;
+    double toleranceMeters; // <= 0 falls back to EMITTER_FOLLOW_TOLERANCE_METERS
+};
+
+struct EmitterFollowStats
+{
+    uint64_t frames;   // frames the cube followed: a per-frame follow sends one update each
+    uint64_t updates;  // ...of which moved the cube
+    uint64_t windowMs; // time since the counters were reset
+};
+
+// SpawnCubeAtOffsetFromUser submitted a cube create; its object id follows
+void EmitterFollow_OnCubeSpawned(double rightMeters);
+
+// ASSIGNED_OBJECT_ID for REQUEST_ADD_CUBE: the new cube starts following
+void EmitterFollow_OnCubeAssigned(DWORD objectId);
+
+// Per-frame tick: moves the cube when its drift exceeds the tolerance
+void EmitterFollow_OnFrame();
+
+void EmitterFollow_SetConfig(const EmitterFollowConfig& config);
+EmitterFollowConfig EmitterFollow_GetConfig();
+
+void EmitterFollow_GetStats(EmitterFollowStats* stats);
+void EmitterFollow_ResetStats();
+
+// { "type": "EMITTER_FOLLOW", "enabled": true, "tolerance": 2.0, "reset": false }
+// Missing keys keep their current value; a message with only "type" just
+// reports the counters. "reset" clears them after the reply. False for an
+// invalid parameter.
+bool EmitterFollow_OnMessage(PoiParseResult& msg);
@@ -1,9 +1,86 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <MSFS/MSFS_WindowsTypes.h>
+
+struct PoiParseResult;
+
+// Lifecycle of a POI marker
+enum eMarkerState
+{
+    MARKER_NONE = 0, // POI has no marker
+    MARKER_QUEUED,   // waiting in the spawn queue
+    MARKER_CREATING, // create submitted, object id not yet assigned
+    MARKER_LIVE,     // object exists in the sim
+    MARKER_FAILED    // create rejected or timed out; retried on a timer, and when the POI changes
+};
 
 // Utilities to manage laser_red SimObjects
 void SpawnSimObject();
 void RemoveSimObject();
 
+// Bring the marker of one POI in line with the POI store: spawn, remove or move
+// it as needed. Only issues SimConnect calls when something actually changed.
+// A removed marker's object is kept for reuse by the next marker until the
+// following frame tick, so reconcile removals before additions.
+void SimObjectManager_ReconcilePoi(uint32_t poiId);
+
+// Route an ASSIGNED_OBJECT_ID for a marker spawn request.
+// Returns false when the request id does not belong to a marker.
+bool SimObjectManager_OnMarkerAssigned(DWORD requestId, DWORD objectId);
+
+// Route a SimConnect exception; marks the marker whose create matches sendId
+// as failed. Returns false when sendId does not belong to a marker create.
+bool SimObjectManager_OnException(DWORD sendId, DWORD exception);
+
+// Marker spawn rate; 0 counts as 1
+struct SpawnRateConfig
+{
+    uint32_t perFrame;    // creates submitted per frame
+    uint32_t maxInFlight; // creates awaiting their object id
+};
+
+// Per-frame tick: submits queued creates within the spawn rate
+void SimObjectManager_OnFrame();
+void SimObjectManager_SetSpawnRate(const SpawnRateConfig& config);
+SpawnRateConfig SimObjectManager_GetSpawnRate();
+
+// { "type": "SPAWN_QUEUE", "perFrame": 4, "maxInFlight": 16 }
+// Missing keys keep their current value. Returns false (nothing applied) for
+// an invalid parameter, see PoiParseResult::error.
+bool SimObjectManager_OnSpawnQueueMessage(PoiParseResult& msg);
+
+eMarkerState SimObjectManager_GetMarkerState(uint32_t poiId);
+
+// Log the time until the marker of poiId becomes visible (next create or reuse)
+void SimObjectManager_TrackMarkerLatency(uint32_t poiId);
+
+// Visibility-radius streaming for show-all mode (on by default): only POIs within
+// radiusMeters of the aircraft keep a marker, at most 'budget' of them (closest
+// first). Markers despawn beyond radiusMeters * MARKER_STREAM_HYSTERESIS.
+// Disabling it restores one marker per POI.
+struct MarkerStreamingConfig
+{
+    bool enabled;
+    double radiusMeters; // <= 0 falls back to MARKER_STREAM_RADIUS_METERS
+    uint32_t budget;
+};
+
+void SimObjectManager_SetStreaming(const MarkerStreamingConfig& config);
+MarkerStreamingConfig SimObjectManager_GetStreaming();
+
+// { "type": "MARKER_STREAMING", "enabled": true, "radius": 30000, "budget": 64 }
+// Missing keys keep their current value; false for an invalid parameter.
+bool SimObjectManager_OnStreamingMessage(PoiParseResult& msg);
+
+// Lookahead: these POIs (the next ones of the tour) keep a marker parked below
+// the terrain, so the marker only has to be raised when the POI becomes active.
+// Set by the flight controller; a call with an unchanged list does nothing.
+void SimObjectManager_SetLookahead(const uint32_t* poiIds, size_t count);
+
+// The user aircraft moved (simconnect/Telemetry.h); updates the resident marker set
+void SimObjectManager_OnUserPosition();
+
 // Spawns a cube 1 meter to the right of the user's aircraft
 void SpawnCubeNearAircraft();
 
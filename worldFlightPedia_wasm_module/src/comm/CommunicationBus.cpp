@@ -4,29 +4,43 @@
 #include <cstring>
 #include <cstdlib>
 #include "comm/MessageParser.h"
+#include "comm/PoiWireFormat.h"
+#include "comm/PoiUpload.h"
 #include <MSFS/MSFS_CommBus.h>
+#include "comm/OutboundQueue.h"
+#include "comm/ReplyBuilder.h"
 
 #include "core/ModuleContext.h"   // for g_poi_coords
+#include "core/PoiStore.h"
+#include "core/Arena.h"
+#include "geo/PoiSpatialIndex.h"
+#include "simobjects/SimObjectManager.h"
+#include "simobjects/EmitterFollow.h"
+#include "flight/FlightController.h"
+#include "flight/GeofenceEngine.h"
+#include "flight/TourOptimizer.h"
+#include "dispatch/DispatchTrace.h"
 #include "comm/CommunicationBus.h"
+#include "core/Constants.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
+
+static void RegisterRoutes();
 
 // -----------------------------------------------------------
 // Initialize the CommBus and register the JS -> WASM listener
 // -----------------------------------------------------------
 void CommBus_Initialize()
 {
-    std::fprintf(stderr, "[MSFS] CommBus initialization...\n");
+    LOG_INFO("CommBus initialization...");
+
+    RegisterRoutes();
 
     // Register the handler exactly as in the original code
     fsCommBusRegister("OnMessageFromJs", OnMessageFromJS, nullptr);
 
-    // Send the startup message (moved here)
-    const char* startup = "WASM ready";
-    fsCommBusCall("OnMessageFromWasm",
-        startup,
-        (unsigned int)std::strlen(startup),
-        FsCommBusBroadcast_JS);
-
-    std::fprintf(stderr, "[MSFS] CommBus initialized and startup sent.\n");
+    // "WASM ready" is sent once by module_init, after everything is set up
+    LOG_INFO("CommBus initialized.");
 }
 
 
@@ -35,37 +49,522 @@ void CommBus_Initialize()
 // -----------------------------------------------------------
 void CommBus_Shutdown()
 {
+    OutboundQueue_Flush(); // replies still waiting for a frame
     fsCommBusUnregisterAll();
-    std::fprintf(stderr, "[MSFS] CommBus shutdown, handlers unregistered.\n");
+    LOG_INFO("CommBus shutdown, handlers unregistered.");
 }
 
-void OnMessageFromJS(const char* buf, unsigned int bufSize, void* ctx)
+// -----------------------------------------------------------
+// POI staging
+// Incoming entries are staged first so a malformed message leaves the store
+// untouched. The columns keep their capacity between messages; for a full
+// replacement the staged columns are swapped in as the new store.
+// -----------------------------------------------------------
+static uint32_t s_received = 0; // messages from JS so far, "rx" in acks / nacks
+
+static PoiColumns s_stagedCoords;
+static std::vector<uint32_t> s_stagedIds;
+static std::vector<uint32_t> s_changedIds;
+
+static void StagePoi(const PoiRecord& poi, void* ctx)
 {
-    std::string received(buf, bufSize);
-    std::fprintf(stderr, "[MSFS] Received from JS: %s\n", received.c_str());
+    PoiColumns_Append(s_stagedCoords, poi.lat, poi.lon);
+    s_stagedIds.push_back(poi.id);
+}
 
-    // Try to parse a simple JSON structure for POI_COORDINATES without pulling in a full JSON library
-    // Expected shape:
-    // { "type": "POI_COORDINATES", "data": [ {"lat": 40.7, "lon": -74.0}, ... ], "count": 2 }
+static void ClearStaging()
+{
+    PoiColumns_Clear(s_stagedCoords);
+    s_stagedIds.clear();
+}
+
+// Apply the staged entries to the POI store, then reconcile markers for the POIs
+// that actually changed. Returns the number of changed POIs.
+static size_t ApplyStagedPois(ePoiMessageType type)
+{
+    s_changedIds.clear();
 
-    // Parse POIs using the dedicated parser
-        auto parsed = ParsePoiCoordinates(received);
+    // Remember which POI is active so a shift in the list can be detected
+    bool hadActive = g_activePoiIndex >= 0 && g_activePoiIndex < (int)g_poi_ids.size();
+    uint32_t activeIdBefore = hadActive ? g_poi_ids[g_activePoiIndex] : 0;
 
-    // Replace global vector with parsed data
-    g_poi_coords = parsed;
+    if (type == POI_MSG_COORDINATES)
+    {
+        PoiStore_Replace(s_stagedCoords, s_stagedIds, s_changedIds);
+    }
+    else
+    {
+        for (size_t i = 0; i < s_stagedIds.size(); ++i)
+        {
+            PoiEntry entry;
+            entry.id = s_stagedIds[i];
+            entry.lat = s_stagedCoords.lat[i];
+            entry.lon = s_stagedCoords.lon[i];
+
+            bool changed = false;
+            if (type == POI_MSG_ADD)         changed = PoiStore_Add(entry);
+            else if (type == POI_MSG_UPDATE) changed = PoiStore_Update(entry);
+            else if (type == POI_MSG_REMOVE) changed = PoiStore_Remove(entry.id);
+
+            if (changed)
+                s_changedIds.push_back(entry.id);
+        }
+    }
+    ClearStaging();
+
+    // The active index may now point at a different POI (reorder, removal of the active entry)
+    bool hasActive = g_activePoiIndex >= 0 && g_activePoiIndex < (int)g_poi_ids.size();
+    if (hasActive && (!hadActive || g_poi_ids[g_activePoiIndex] != activeIdBefore))
+        s_changedIds.push_back(g_poi_ids[g_activePoiIndex]);
+    if (hadActive && (!hasActive || g_poi_ids[g_activePoiIndex] != activeIdBefore))
+        s_changedIds.push_back(activeIdBefore);
+
+    for (size_t i = 0; i < s_changedIds.size(); ++i)
+        SimObjectManager_ReconcilePoi(s_changedIds[i]);
+
+    return s_changedIds.size();
+}
+
+// -----------------------------------------------------------
+// POI list messages (POI_COORDINATES, POI_ADD, POI_REMOVE, POI_UPDATE)
+// { "type": "POI_COORDINATES", "data": [ {"id": 7, "lat": 40.7, "lon": -74.0}, ... ], "count": 2 }
+// The entries were staged while parsing.
+// -----------------------------------------------------------
+static bool HandlePoiList(PoiParseResult& msg)
+{
+    // Apply to the store; only changed POIs reach SimConnect
+    size_t changed = ApplyStagedPois(msg.type);
+    Metrics_Count(METRIC_POIS_PARSED, msg.count);
 
     // Logs
-    fprintf(stderr, "[MSFS] Parsed %zu POI coordinates from JS\n", g_poi_coords.size());
-    for (size_t i = 0; i < g_poi_coords.size(); ++i)
+    LOG_INFO("Applied %s: %u entries, %zu changed, %zu POIs total",
+        PoiMessage_TypeName(msg.type), msg.count, changed, g_poi_coords.size());
+    if (msg.type == POI_MSG_COORDINATES)
+    {
+        for (size_t i = 0; i < g_poi_coords.size(); ++i)
+        {
+            LOG_DEBUG("POI[%zu] = lat: %.6f, lon: %.6f",
+                i, g_poi_coords.lat[i], g_poi_coords.lon[i]);
+        }
+    }
+
+    // Compact acknowledgement: echoing the payload would double the traffic
+    uint32_t seq = OutboundQueue_Sendf("ack: %s rx=%u count=%u changed=%zu total=%zu",
+        PoiMessage_TypeName(msg.type), (unsigned)s_received, msg.count, changed, g_poi_coords.size());
+    LOG_DEBUG("Queued ack #%u to JS", (unsigned)seq);
+    return true;
+}
+
+// -----------------------------------------------------------
+// POI proximity queries (answered from geo/PoiSpatialIndex)
+// { "type": "POI_QUERY_NEAREST", "lat": 47.3, "lon": 8.5, "k": 5, "requestId": 3 }
+// { "type": "POI_QUERY_RADIUS", "lat": 47.3, "lon": 8.5, "radius": 20000, "requestId": 4 }
+// { "type": "POI_QUERY_DEDUP", "radius": 50, "requestId": 5 }
+// Reply shape:
+// { "type": "POI_QUERY_RESULT", "query": "NEAREST", "requestId": 3,
+//   "ids": [ ... ], "meters": [ ... ] }   ("meters" omitted for DEDUP)
+// -----------------------------------------------------------
+static std::vector<PoiHit> s_queryHits;
+static std::vector<uint32_t> s_queryIds;
+
+static const char* QueryName(ePoiMessageType type)
+{
+    if (type == POI_MSG_QUERY_NEAREST) return "NEAREST";
+    if (type == POI_MSG_QUERY_RADIUS)  return "RADIUS";
+    return "DEDUP";
+}
+
+static bool HandlePoiQuery(PoiParseResult& msg)
+{
+    double lat = 0.0;
+    double lon = 0.0;
+    double radius = 0.0;
+    uint32_t k = 1;
+    uint32_t requestId = 0;
+    bool hasLat = Param_DoubleIn(msg, "lat", -90.0, 90.0, &lat);
+    bool hasLon = Param_DoubleIn(msg, "lon", -180.0, 180.0, &lon);
+    bool hasRadius = Param_Double(msg, "radius", &radius);
+    Param_Count(msg, "k", 1, &k);
+    Param_Id(msg, "requestId", &requestId);
+    if (msg.type != POI_MSG_QUERY_DEDUP)
+        Param_Require(msg, hasLat && hasLon);
+    if (msg.type != POI_MSG_QUERY_NEAREST)
+        Param_Require(msg, hasRadius);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    bool withMeters = msg.type != POI_MSG_QUERY_DEDUP;
+
+    s_queryHits.clear();
+    if (msg.type == POI_MSG_QUERY_NEAREST)
+        PoiIndex_Nearest(lat, lon, k, s_queryHits);
+    else if (msg.type == POI_MSG_QUERY_RADIUS)
+        PoiIndex_Radius(lat, lon, radius, s_queryHits);
+    else
+    {
+        PoiIndex_FindDuplicates(radius, s_queryIds);
+        for (size_t i = 0; i < s_queryIds.size(); ++i)
+        {
+            PoiHit hit;
+            hit.id = s_queryIds[i];
+            hit.meters = 0.0;
+            s_queryHits.push_back(hit);
+        }
+    }
+
+    // Arena memory of the current message (see OnMessageFromJS)
+    ReplyBuilder reply;
+    Reply_Begin(reply, 96 + s_queryHits.size() * (withMeters ? 24 : 12));
+
+    Reply_Appendf(reply, "{\"type\":\"POI_QUERY_RESULT\",\"query\":\"%s\",\"requestId\":%u,\"ids\":[",
+        QueryName(msg.type), (unsigned)requestId);
+    for (size_t i = 0; i < s_queryHits.size(); ++i)
+        Reply_Appendf(reply, i ? ",%u" : "%u", (unsigned)s_queryHits[i].id);
+    Reply_AppendStr(reply, "]");
+
+    if (withMeters)
+    {
+        Reply_AppendStr(reply, ",\"meters\":[");
+        for (size_t i = 0; i < s_queryHits.size(); ++i)
+            Reply_Appendf(reply, i ? ",%.1f" : "%.1f", s_queryHits[i].meters);
+        Reply_AppendStr(reply, "]");
+    }
+    Reply_AppendStr(reply, "}");
+
+    Reply_Send(reply);
+    LOG_INFO("Answered POI query %s (requestId=%u): %zu results",
+        QueryName(msg.type), (unsigned)requestId, s_queryHits.size());
+    return true;
+}
+
+// -----------------------------------------------------------
+// Chunked POI upload (see comm/PoiUpload.h)
+// { "type": "POI_UPLOAD_BEGIN", "upload": 7, "total": 20000, "chunkSize": 500, "checksum": 2166136261 }
+// { "type": "POI_UPLOAD_CHUNK", "upload": 7, "chunk": 0, "data": [ {"id": 1, "lat": 40.7, "lon": -74.0}, ... ] }
+// { "type": "POI_UPLOAD_COMMIT", "upload": 7 }
+// { "type": "POI_UPLOAD_ABORT", "upload": 7 }
+// Chunks can also be binary (POI_WIRE_TYPE_CHUNK). A commit with chunks
+// missing is answered with
+// { "type": "POI_UPLOAD_MISSING", "upload": 7, "missing": 2, "chunks": [ 3, 17 ] }
+// -----------------------------------------------------------
+static std::vector<uint32_t> s_missingChunks;
+
+static void SendUploadNack(ePoiMessageType type, uint32_t upload, ePoiUploadStatus status)
+{
+    OutboundQueue_Sendf("nack: %s rx=%u upload=%u %s",
+        PoiMessage_TypeName(type), (unsigned)s_received, (unsigned)upload, PoiUpload_StatusName(status));
+}
+
+// "upload", required by every upload message
+static bool ReadUploadId(PoiParseResult& msg, uint32_t* upload)
+{
+    return Param_Require(msg, Param_Id(msg, "upload", upload));
+}
+
+static bool HandleUploadBegin(PoiParseResult& msg)
+{
+    uint32_t uploadId = 0;
+    uint32_t total = 0;
+    uint32_t chunkSize = 0;
+    uint32_t checksum = 0;
+    bool hasUpload = Param_Id(msg, "upload", &uploadId);
+    bool hasTotal = Param_Count(msg, "total", 0, &total);
+    bool hasChunkSize = Param_Count(msg, "chunkSize", 0, &chunkSize);
+    bool hasChecksum = Param_Id(msg, "checksum", &checksum);
+    if (!Param_Require(msg, hasUpload && hasTotal && hasChunkSize && hasChecksum))
+        return false;
+
+    bool resumed;
+    ePoiUploadStatus status = PoiUpload_Begin(uploadId, total, chunkSize, checksum, &resumed);
+    if (status != POI_UPLOAD_OK)
+    {
+        SendUploadNack(POI_MSG_UPLOAD_BEGIN, uploadId, status);
+        return true;
+    }
+
+    PoiUploadStatus upload;
+    PoiUpload_GetStatus(&upload);
+    OutboundQueue_Sendf("ack: POI_UPLOAD_BEGIN rx=%u upload=%u total=%u chunks=%u received=%u resumed=%d",
+        (unsigned)s_received, (unsigned)upload.uploadId, (unsigned)upload.total, (unsigned)upload.chunks,
+        (unsigned)upload.received, resumed ? 1 : 0);
+    return true;
+}
+
+// Moves the staged entries (one chunk) into the upload
+static void StoreUploadChunk(uint32_t upload, uint32_t chunk)
+{
+    size_t count = s_stagedIds.size();
+    ePoiUploadStatus status = PoiUpload_StoreChunk(upload, chunk, s_stagedCoords, s_stagedIds);
+    ClearStaging();
+
+    if (status != POI_UPLOAD_OK)
+    {
+        Metrics_Count(METRIC_MESSAGES_REJECTED);
+        LOG_WARN("Rejected chunk %u of POI upload %u: %s", chunk, upload, PoiUpload_StatusName(status));
+        OutboundQueue_Sendf("nack: POI_UPLOAD_CHUNK rx=%u upload=%u chunk=%u %s",
+            (unsigned)s_received, (unsigned)upload, (unsigned)chunk, PoiUpload_StatusName(status));
+        return;
+    }
+
+    Metrics_Count(METRIC_POIS_PARSED, count);
+    PoiUploadStatus state;
+    PoiUpload_GetStatus(&state);
+    OutboundQueue_Sendf("ack: POI_UPLOAD_CHUNK rx=%u upload=%u chunk=%u received=%u/%u",
+        (unsigned)s_received, (unsigned)upload, (unsigned)chunk, (unsigned)state.received, (unsigned)state.chunks);
+}
+
+static bool HandleUploadChunk(PoiParseResult& msg)
+{
+    uint32_t upload = 0;
+    uint32_t chunk = 0;
+    bool hasUpload = Param_Id(msg, "upload", &upload);
+    bool hasChunk = Param_Id(msg, "chunk", &chunk);
+    if (!Param_Require(msg, hasUpload && hasChunk))
+        return false;
+
+    StoreUploadChunk(upload, chunk);
+    return true;
+}
+
+static bool HandleUploadCommit(PoiParseResult& msg)
+{
+    uint32_t uploadId = 0;
+    if (!ReadUploadId(msg, &uploadId))
+        return false;
+
+    ePoiUploadStatus status = PoiUpload_Commit(uploadId, s_stagedCoords, s_stagedIds);
+    if (status == POI_UPLOAD_ERR_INCOMPLETE)
+    {
+        PoiUploadStatus upload;
+        PoiUpload_GetStatus(&upload);
+        s_missingChunks.clear();
+        PoiUpload_Missing(s_missingChunks, POI_UPLOAD_MAX_LISTED_MISSING);
+
+        ReplyBuilder reply;
+        Reply_Begin(reply, 96 + s_missingChunks.size() * 8);
+        Reply_Appendf(reply, "{\"type\":\"POI_UPLOAD_MISSING\",\"upload\":%u,\"missing\":%u,\"chunks\":[",
+            (unsigned)upload.uploadId, (unsigned)(upload.chunks - upload.received));
+        for (size_t i = 0; i < s_missingChunks.size(); ++i)
+            Reply_Appendf(reply, i ? ",%u" : "%u", (unsigned)s_missingChunks[i]);
+        Reply_AppendStr(reply, "]}");
+        Reply_Send(reply);
+        return true;
+    }
+    if (status != POI_UPLOAD_OK)
+    {
+        SendUploadNack(POI_MSG_UPLOAD_COMMIT, uploadId, status);
+        return true;
+    }
+
+    // The upload is in the staging columns now; apply it like POI_COORDINATES
+    size_t count = s_stagedIds.size();
+    size_t changed = ApplyStagedPois(POI_MSG_COORDINATES);
+    LOG_INFO("Committed POI upload %u: %zu POIs, %zu changed", (unsigned)uploadId, count, changed);
+
+    OutboundQueue_Sendf("ack: POI_UPLOAD_COMMIT rx=%u upload=%u count=%zu changed=%zu total=%zu",
+        (unsigned)s_received, (unsigned)uploadId, count, changed, g_poi_coords.size());
+    return true;
+}
+
+static bool HandleUploadAbort(PoiParseResult& msg)
+{
+    uint32_t uploadId = 0;
+    if (!ReadUploadId(msg, &uploadId))
+        return false;
+
+    if (!PoiUpload_Abort(uploadId))
+    {
+        SendUploadNack(POI_MSG_UPLOAD_ABORT, uploadId, POI_UPLOAD_ERR_NO_UPLOAD);
+        return true;
+    }
+
+    OutboundQueue_Sendf("ack: POI_UPLOAD_ABORT rx=%u upload=%u", (unsigned)s_received, (unsigned)uploadId);
+    return true;
+}
+
+// Live messages that arrive while a trace is replayed are not applied
+static void RejectWhileReplaying()
+{
+    Metrics_Count(METRIC_MESSAGES_REJECTED);
+    OutboundQueue_Sendf("nack: REPLAYING rx=%u", (unsigned)s_received);
+}
+
+static void SendNack(const PoiParseResult& result)
+{
+    Metrics_Count(METRIC_MESSAGES_REJECTED);
+    LOG_WARN("Rejected %s message: %s%s%s at offset %zu (entry %d)",
+        PoiMessage_TypeName(result.type),
+        PoiParse_ErrorName(result.error),
+        result.error == POI_PARSE_ERR_JSON ? "/" : "",
+        result.error == POI_PARSE_ERR_JSON ? JsonTokenizer_ErrorName(result.jsonError) : "",
+        result.offset, result.entry);
+
+    OutboundQueue_Sendf("nack: %s rx=%u offset=%zu entry=%d",
+        PoiParse_ErrorName(result.error), (unsigned)s_received, result.offset, result.entry);
+}
+
+// -----------------------------------------------------------
+// Binary POI upload (see comm/PoiWireFormat.h)
+// Reads lat/lon/ids straight out of the CommBus buffer into the staging
+// vectors; no intermediate string is built.
+// -----------------------------------------------------------
+static ePoiMessageType WireMessageType(uint16_t wireType)
+{
+    if (wireType == POI_WIRE_TYPE_ADD)    return POI_MSG_ADD;
+    if (wireType == POI_WIRE_TYPE_REMOVE) return POI_MSG_REMOVE;
+    if (wireType == POI_WIRE_TYPE_UPDATE) return POI_MSG_UPDATE;
+    return POI_MSG_COORDINATES;
+}
+
+static void OnBinaryPoiMessage(const char* buf, unsigned int bufSize)
+{
+    PoiWireView view;
+    ePoiWireStatus status = PoiWire_Parse(buf, bufSize, &view);
+
+    // Nacked like the text entry, at the offset of its lat
+    if (status == POI_WIRE_ERR_OUT_OF_RANGE)
+    {
+        PoiParseResult result;
+        std::memset(&result, 0, sizeof(result));
+        result.error = POI_PARSE_ERR_OUT_OF_RANGE;
+        result.offset = (size_t)(view.lat - reinterpret_cast<const unsigned char*>(buf)) + (size_t)view.entry * sizeof(double);
+        result.entry = view.entry;
+        result.type = WireMessageType(view.type);
+        SendNack(result);
+        return;
+    }
+
+    if (status != POI_WIRE_OK)
+    {
+        LOG_WARN("Rejected binary POI message (%u bytes): %s", bufSize, PoiWire_StatusName(status));
+        Metrics_Count(METRIC_MESSAGES_REJECTED);
+        OutboundQueue_Sendf("nack: POI_BINARY rx=%u %s", (unsigned)s_received, PoiWire_StatusName(status));
+        return;
+    }
+
+    ePoiMessageType type = WireMessageType(view.type);
+    ClearStaging();
+    PoiColumns_Reserve(s_stagedCoords, view.count);
+    s_stagedIds.reserve(view.count);
+    for (uint32_t i = 0; i < view.count; ++i)
     {
-        fprintf(stderr, "[MSFS] POI[%zu] = lat: %.6f, lon: %.6f\n",
-            i, g_poi_coords[i].first, g_poi_coords[i].second);
+        double lat = view.lat ? PoiWire_Lat(view, i) : 0.0;
+        double lon = view.lon ? PoiWire_Lon(view, i) : 0.0;
+        PoiColumns_Append(s_stagedCoords, lat, lon);
+        s_stagedIds.push_back(PoiWire_Id(view, i));
     }
 
-    // Send simple acknowledgement back to JS (original behavior)
-    std::string reply;
-    reply.append("ack: ");
-    reply += received;
-    fsCommBusCall("OnMessageFromWasm", reply.c_str(), (unsigned int)reply.size(), FsCommBusBroadcast_JS);
-    std::fprintf(stderr, "[MSFS] Sent ack to JS: %s\n", reply.c_str());
-}
\ No newline at end of file
+    if (view.type == POI_WIRE_TYPE_CHUNK)
+    {
+        StoreUploadChunk(view.upload, view.sequence);
+        return;
+    }
+
+    size_t changed = ApplyStagedPois(type);
+    Metrics_Count(METRIC_POIS_PARSED, view.count);
+    LOG_INFO("Applied binary %s (seq=%u, entries=%u, changed=%zu, total=%zu)",
+        PoiMessage_TypeName(type), view.sequence, view.count, changed, g_poi_coords.size());
+
+    // Compact ack: echoing a binary payload back would be meaningless
+    OutboundQueue_Sendf("ack: POI_BINARY rx=%u seq=%u count=%u changed=%zu",
+        (unsigned)s_received, view.sequence, view.count, changed);
+}
+
+// -----------------------------------------------------------
+// Message routes
+// One handler per ePoiMessageType (a flat table, like the SimConnect routes
+// of dispatch/DispatchRegistry). A handler reads its own parameters with
+// Param_* and returns false when one is missing or invalid; the message is
+// then nacked like a parse error and nothing is applied.
+// -----------------------------------------------------------
+typedef bool (*MessageHandler)(PoiParseResult& msg);
+
+static MessageHandler s_routes[POI_MSG_COUNT];
+
+static void Route(ePoiMessageType type, MessageHandler fn)
+{
+    s_routes[type] = fn;
+}
+
+static void RegisterRoutes()
+{
+    for (int type = 0; type < POI_MSG_COUNT; ++type)
+        s_routes[type] = nullptr;
+
+    Route(POI_MSG_COORDINATES, HandlePoiList);
+    Route(POI_MSG_ADD, HandlePoiList);
+    Route(POI_MSG_REMOVE, HandlePoiList);
+    Route(POI_MSG_UPDATE, HandlePoiList);
+    Route(POI_MSG_QUERY_NEAREST, HandlePoiQuery);
+    Route(POI_MSG_QUERY_RADIUS, HandlePoiQuery);
+    Route(POI_MSG_QUERY_DEDUP, HandlePoiQuery);
+    Route(POI_MSG_UPLOAD_BEGIN, HandleUploadBegin);
+    Route(POI_MSG_UPLOAD_CHUNK, HandleUploadChunk);
+    Route(POI_MSG_UPLOAD_COMMIT, HandleUploadCommit);
+    Route(POI_MSG_UPLOAD_ABORT, HandleUploadAbort);
+
+    Route(POI_MSG_MARKER_STREAMING, SimObjectManager_OnStreamingMessage);
+    Route(POI_MSG_SPAWN_QUEUE, SimObjectManager_OnSpawnQueueMessage);
+    Route(POI_MSG_MARKER_LOOKAHEAD, FlightController_OnLookaheadMessage);
+    Route(POI_MSG_EMITTER_FOLLOW, EmitterFollow_OnMessage);
+    Route(POI_MSG_GEOFENCE, Geofence_OnMessage);
+    Route(POI_MSG_TOUR_OPTIMIZER, TourOptimizer_OnConfigMessage);
+    Route(POI_MSG_TOUR_OPTIMIZE, TourOptimizer_OnOptimizeMessage);
+    Route(POI_MSG_METRICS, Metrics_OnMessage);
+    Route(POI_MSG_TRACE, DispatchTrace_OnTraceMessage);
+    Route(POI_MSG_TRACE_REPLAY, DispatchTrace_OnReplayMessage);
+}
+
+void OnMessageFromJS(const char* buf, unsigned int bufSize, void* ctx)
+{
+    MetricsScope scope(METRIC_ROUTE_COMMBUS);
+    ArenaScope arena; // scratch memory of this message (replies) is released on return
+    Metrics_Count(METRIC_MESSAGES);
+    s_received++;
+
+    bool replayed = DispatchTrace_IsDelivering();
+    DispatchTrace_Record(TRACE_KIND_COMMBUS, buf, bufSize);
+
+    if (PoiWire_IsBinary(buf, bufSize))
+    {
+        if (!replayed && DispatchTrace_IsReplaying())
+        {
+            RejectWhileReplaying();
+            return;
+        }
+        OnBinaryPoiMessage(buf, bufSize);
+        return;
+    }
+
+    LOG_DEBUG("Received from JS: %.*s", (int)bufSize, buf);
+
+    // Parse in a single pass directly over the CommBus buffer; POI entries
+    // ("data") are staged, other top-level keys kept for the handler
+    ClearStaging();
+    PoiParseResult result = ParsePoiMessage(buf, bufSize, StagePoi, nullptr);
+
+    if (result.error == POI_PARSE_OK)
+    {
+        // During a replay only the replayed messages are applied, plus live TRACE
+        // messages (to stop it); TRACE messages inside the trace are skipped
+        bool isTrace = result.type == POI_MSG_TRACE || result.type == POI_MSG_TRACE_REPLAY;
+        if (replayed ? isTrace : (DispatchTrace_IsReplaying() && !isTrace))
+        {
+            ClearStaging();
+            if (!replayed)
+                RejectWhileReplaying();
+            return;
+        }
+
+        MessageHandler handler = s_routes[result.type];
+        if (handler)
+            handler(result);
+        else
+            LOG_ERROR("No handler for %s", PoiMessage_TypeName(result.type));
+    }
+
+    // Whatever a handler did not take (rejected or parameter-only messages)
+    ClearStaging();
+    if (result.error != POI_PARSE_OK)
+        SendNack(result);
+}
@@ -0,0 +1,222 @@
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "comm/JsonTokenizer.h"
+
+// -----------------------------------------------------------------------------
+// JsonTokenizer
+// Every byte of the input is visited once. Numbers are validated against the
+// JSON grammar before conversion; the conversion itself uses strtod on a small
+// stack copy because the CommBus buffer is not guaranteed to be NUL terminated.
+// Literals beyond the double range (1e999) are rejected, so every number a
+// token carries is finite.
+// -----------------------------------------------------------------------------
+
+static const size_t kMaxNumberLength = 63;
+
+static inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+static inline bool IsHexDigit(char c)
+{
+    return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool Fail(JsonTokenizer* tz, JsonToken* tok, eJsonError error, const char* at)
+{
+    tok->type = JSON_TOK_ERROR;
+    tok->error = error;
+    tok->offset = (size_t)(at - tz->begin);
+    tz->cur = tz->end; // stop: further calls return JSON_TOK_END
+    return false;
+}
+
+static bool ScanString(JsonTokenizer* tz, JsonToken* tok)
+{
+    const char* start = tz->cur; // opening quote
+    const char* p = start + 1;
+    bool escapes = false;
+
+    while (p < tz->end && *p != '"')
+    {
+        if (*p == '\0' || (unsigned char)*p < 0x20)
+            return Fail(tz, tok, JSON_ERR_UNTERMINATED_STRING, p);
+
+        if (*p == '\\')
+        {
+            escapes = true;
+            if (++p >= tz->end)
+                return Fail(tz, tok, JSON_ERR_UNTERMINATED_STRING, p);
+
+            switch (*p)
+            {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                break;
+            case 'u':
+                if (tz->end - p < 5 || !IsHexDigit(p[1]) || !IsHexDigit(p[2]) || !IsHexDigit(p[3]) || !IsHexDigit(p[4]))
+                    return Fail(tz, tok, JSON_ERR_BAD_ESCAPE, p - 1);
+                p += 4;
+                break;
+            default:
+                return Fail(tz, tok, JSON_ERR_BAD_ESCAPE, p - 1);
+            }
+        }
+        ++p;
+    }
+
+    if (p >= tz->end)
+        return Fail(tz, tok, JSON_ERR_UNTERMINATED_STRING, start);
+
+    tok->type = JSON_TOK_STRING;
+    tok->text = start + 1;
+    tok->length = (size_t)(p - (start + 1));
+    tok->hasEscapes = escapes;
+    tz->cur = p + 1;
+    return true;
+}
+
+static bool ScanNumber(JsonTokenizer* tz, JsonToken* tok)
+{
+    const char* start = tz->cur;
+    const char* p = start;
+    const char* end = tz->end;
+
+    if (p < end && *p == '-') ++p;
+
+    // Integer part: a single 0 or a non-zero digit followed by digits
+    if (p >= end || !IsDigit(*p))
+        return Fail(tz, tok, JSON_ERR_BAD_NUMBER, start);
+    if (*p == '0') ++p;
+    else while (p < end && IsDigit(*p)) ++p;
+
+    if (p < end && *p == '.')
+    {
+        ++p;
+        if (p >= end || !IsDigit(*p))
+            return Fail(tz, tok, JSON_ERR_BAD_NUMBER, start);
+        while (p < end && IsDigit(*p)) ++p;
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        if (p < end && (*p == '+' || *p == '-')) ++p;
+        if (p >= end || !IsDigit(*p))
+            return Fail(tz, tok, JSON_ERR_BAD_NUMBER, start);
+        while (p < end && IsDigit(*p)) ++p;
+    }
+
+    size_t len = (size_t)(p - start);
+    if (len > kMaxNumberLength)
+        return Fail(tz, tok, JSON_ERR_BAD_NUMBER, start);
+
+    char scratch[kMaxNumberLength + 1];
+    std::memcpy(scratch, start, len);
+    scratch[len] = '\0';
+
+    double value = std::strtod(scratch, nullptr);
+    if (!std::isfinite(value))
+        return Fail(tz, tok, JSON_ERR_BAD_NUMBER, start);
+
+    tok->type = JSON_TOK_NUMBER;
+    tok->number = value;
+    tz->cur = p;
+    return true;
+}
+
+static bool ScanLiteral(JsonTokenizer* tz, JsonToken* tok, const char* word, eJsonTokenType type)
+{
+    size_t len = std::strlen(word);
+    if ((size_t)(tz->end - tz->cur) < len || std::memcmp(tz->cur, word, len) != 0)
+        return Fail(tz, tok, JSON_ERR_BAD_LITERAL, tz->cur);
+
+    tok->type = type;
+    tz->cur += len;
+    return true;
+}
+
+void JsonTokenizer_Init(JsonTokenizer* tz, const char* buf, size_t size)
+{
+    tz->begin = buf;
+    tz->cur = buf;
+    tz->end = buf ? buf + size : buf;
+}
+
+bool JsonTokenizer_Next(JsonTokenizer* tz, JsonToken* tok)
+{
+    // Skip insignificant whitespace
+    while (tz->cur < tz->end && (*tz->cur == ' ' || *tz->cur == '\t' || *tz->cur == '\n' || *tz->cur == '\r'))
+        ++tz->cur;
+
+    tok->error = JSON_ERR_NONE;
+    tok->offset = (size_t)(tz->cur - tz->begin);
+    tok->text = nullptr;
+    tok->length = 0;
+    tok->hasEscapes = false;
+    tok->number = 0.0;
+
+    if (tz->cur >= tz->end || *tz->cur == '\0')
+    {
+        tok->type = JSON_TOK_END;
+        return true;
+    }
+
+    char c = *tz->cur;
+    switch (c)
+    {
+    case '{': tok->type = JSON_TOK_OBJECT_BEGIN; ++tz->cur; return true;
+    case '}': tok->type = JSON_TOK_OBJECT_END;   ++tz->cur; return true;
+    case '[': tok->type = JSON_TOK_ARRAY_BEGIN;  ++tz->cur; return true;
+    case ']': tok->type = JSON_TOK_ARRAY_END;    ++tz->cur; return true;
+    case ':': tok->type = JSON_TOK_COLON;        ++tz->cur; return true;
+    case ',': tok->type = JSON_TOK_COMMA;        ++tz->cur; return true;
+    case '"': return ScanString(tz, tok);
+    case 't': return ScanLiteral(tz, tok, "true", JSON_TOK_TRUE);
+    case 'f': return ScanLiteral(tz, tok, "false", JSON_TOK_FALSE);
+    case 'n': return ScanLiteral(tz, tok, "null", JSON_TOK_NULL);
+    default:
+        if (c == '-' || IsDigit(c))
+            return ScanNumber(tz, tok);
+        return Fail(tz, tok, JSON_ERR_UNEXPECTED_CHAR, tz->cur);
+    }
+}
+
+const char* JsonTokenizer_ErrorName(eJsonError error)
+{
+    switch (error)
+    {
+    case JSON_ERR_NONE:                return "NONE";
+    case JSON_ERR_UNEXPECTED_CHAR:     return "UNEXPECTED_CHAR";
+    case JSON_ERR_UNTERMINATED_STRING: return "UNTERMINATED_STRING";
+    case JSON_ERR_BAD_ESCAPE:          return "BAD_ESCAPE";
+    case JSON_ERR_BAD_NUMBER:          return "BAD_NUMBER";
+    case JSON_ERR_BAD_LITERAL:         return "BAD_LITERAL";
+    }
+    return "UNKNOWN";
+}
+
+bool JsonToken_Equals(const JsonToken& tok, const char* literal)
+{
+    if (tok.type != JSON_TOK_STRING)
+        return false;
+
+    size_t len = std::strlen(literal);
+    return tok.length == len && std::memcmp(tok.text, literal, len) == 0;
+}
+
+bool JsonToken_ToUint32(const JsonToken& tok, uint32_t* out)
+{
+    if (tok.type != JSON_TOK_NUMBER || tok.number < 0.0 || tok.number > 4294967295.0
+        || tok.number != std::floor(tok.number))
+        return false;
+    *out = (uint32_t)tok.number;
+    return true;
+}
+
+uint32_t JsonToken_ClampUint32(const JsonToken& tok, uint32_t minValue)
+{
+    if (tok.number <= (double)minValue)
+        return minValue;
+    if (tok.number >= 4294967295.0)
+        return 4294967295u;
+    return (uint32_t)tok.number;
+}
@@ -4,70 +4,570 @@
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
+#include <cmath>
 #include "comm/MessageParser.h"
+#include "comm/JsonTokenizer.h"
 
 // -----------------------------------------------------------------------------
 // MessageParser
-// Lightweight parser for incoming JS -> WASM messages.
+// Parser for incoming JS -> WASM POI messages, built on JsonTokenizer.
 // NOTE: This is intentionally minimal to avoid pulling a full JSON library into
-// the WASM build. It only extracts "lat"/"lon" numeric pairs when the
-// message contains the marker "POI_COORDINATES" and a "data" array.
+// the WASM build. It walks the buffer once, does not allocate, and stops at the
+// first error with a structured PoiParseResult (error code + byte offset +
+// entry index) instead of silently truncating the list.
 //
-// Limitations / assumptions:
-// - Expects numbers in plain decimal form (no exponential formats guaranteed)
-// - No strict JSON validation is performed; malformed input will be skipped
-// - For production use consider replacing with a small JSON parser or
-//   performing validation on the JS side before sending.
+// Accepted shape:
+//   { "type": "POI_COORDINATES",
+//     "data": [ { "id": 1, "name": "...", "lat": 40.7, "lon": -74.0,
+//                 "elevation": 12.5, "category": "..." }, ... ],
+//     "count": n }
+// Only "lat" and "lon" are required per entry; "count" is optional.
+// POI_ADD / POI_REMOVE / POI_UPDATE use the same shape, keyed by "id";
+// POI_REMOVE entries may carry the id alone.
+// Other top-level keys with a scalar value are collected as parameters
+// (PoiMessageParams) for the handler of the type, which reads and checks them
+// with Param_*; e.g. POI_QUERY_NEAREST carries "lat", "lon", "k" and
+// "requestId" instead of a "data" array.
 // -----------------------------------------------------------------------------
 
-std::vector<std::pair<double, double>> ParsePoiCoordinates(const std::string& received)
+static const int kMaxSkipDepth = 32;
+
+struct PoiParser
+{
+    JsonTokenizer tz;
+    JsonToken tok;
+    PoiParseResult* result;
+    PoiRecordCallback onPoi;
+    void* ctx;
+
+    // Requirements that depend on "type" are checked once the whole message is read
+    int firstWithoutPosition;
+    size_t firstWithoutPositionOffset;
+    int firstWithoutId;
+    size_t firstWithoutIdOffset;
+};
+
+static bool Advance(PoiParser& p)
+{
+    if (JsonTokenizer_Next(&p.tz, &p.tok))
+        return true;
+
+    p.result->error = POI_PARSE_ERR_JSON;
+    p.result->jsonError = p.tok.error;
+    p.result->offset = p.tok.offset;
+    return false;
+}
+
+static bool Error(PoiParser& p, ePoiParseError error)
+{
+    p.result->error = error;
+    p.result->offset = p.tok.offset;
+    return false;
+}
+
+static bool Expect(PoiParser& p, eJsonTokenType type)
+{
+    if (!Advance(p))
+        return false;
+    if (p.tok.type != type)
+        return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+    return true;
+}
+
+// Skips the value whose first token is already in p.tok
+static bool SkipValue(PoiParser& p)
+{
+    int depth = 0;
+    do
+    {
+        switch (p.tok.type)
+        {
+        case JSON_TOK_OBJECT_BEGIN:
+        case JSON_TOK_ARRAY_BEGIN:
+            if (++depth > kMaxSkipDepth)
+                return Error(p, POI_PARSE_ERR_TOO_DEEP);
+            break;
+        case JSON_TOK_OBJECT_END:
+        case JSON_TOK_ARRAY_END:
+            if (--depth < 0)
+                return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+            break;
+        case JSON_TOK_END:
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+        default:
+            break;
+        }
+        if (depth == 0)
+            return true;
+    } while (Advance(p));
+    return false;
+}
+
+static uint32_t HashId(const char* text, size_t length)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h ^= (unsigned char)text[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Reads an optional string field (string or null)
+static bool ReadOptionalString(PoiParser& p, const char** text, size_t* length)
+{
+    if (p.tok.type == JSON_TOK_NULL)
+        return true;
+    if (p.tok.type != JSON_TOK_STRING)
+        return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+    *text = p.tok.text;
+    *length = p.tok.length;
+    return true;
+}
+
+// Reads a numeric identifier: a fraction is the wrong type, anything outside
+// uint32 is out of range (a plain cast of either would be undefined)
+static bool ReadId(PoiParser& p, uint32_t* out)
+{
+    if (JsonToken_ToUint32(p.tok, out))
+        return true;
+    return Error(p, p.tok.number == std::floor(p.tok.number) ? POI_PARSE_ERR_OUT_OF_RANGE : POI_PARSE_ERR_FIELD_TYPE);
+}
+
+// Parses one { ... } entry of the "data" array; p.tok holds the '{'
+static bool ParseEntry(PoiParser& p, int index)
+{
+    PoiRecord rec;
+    std::memset(&rec, 0, sizeof(rec));
+    rec.id = (uint32_t)index;
+
+    if (!Advance(p))
+        return false;
+
+    while (p.tok.type != JSON_TOK_OBJECT_END)
+    {
+        if (p.tok.type != JSON_TOK_STRING)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+
+        JsonToken key = p.tok;
+        if (!Expect(p, JSON_TOK_COLON) || !Advance(p))
+            return false;
+
+        if (JsonToken_Equals(key, "lat") || JsonToken_Equals(key, "lon") || JsonToken_Equals(key, "elevation"))
+        {
+            bool isElevation = key.text[0] == 'e';
+            if (isElevation && p.tok.type == JSON_TOK_NULL)
+            {
+                // explicit null elevation: leave unset
+            }
+            else if (p.tok.type != JSON_TOK_NUMBER)
+                return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+            else if (isElevation) { rec.elevation = p.tok.number; rec.fields |= POI_FIELD_ELEVATION; }
+            else if (key.text[1] == 'a') { rec.lat = p.tok.number; rec.fields |= POI_FIELD_LAT; }
+            else { rec.lon = p.tok.number; rec.fields |= POI_FIELD_LON; }
+        }
+        else if (JsonToken_Equals(key, "id"))
+        {
+            if (p.tok.type == JSON_TOK_NUMBER)
+            {
+                if (!ReadId(p, &rec.id))
+                    return false;
+            }
+            else if (p.tok.type == JSON_TOK_STRING)
+                rec.id = HashId(p.tok.text, p.tok.length);
+            else
+                return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+            rec.fields |= POI_FIELD_ID;
+        }
+        else if (JsonToken_Equals(key, "name"))
+        {
+            if (!ReadOptionalString(p, &rec.name, &rec.nameLength))
+                return false;
+            if (rec.name) rec.fields |= POI_FIELD_NAME;
+        }
+        else if (JsonToken_Equals(key, "category"))
+        {
+            if (!ReadOptionalString(p, &rec.category, &rec.categoryLength))
+                return false;
+            if (rec.category) rec.fields |= POI_FIELD_CATEGORY;
+        }
+        else if (!SkipValue(p))
+            return false;
+
+        // Either ',' followed by the next key, or the closing '}'
+        if (!Advance(p))
+            return false;
+        if (p.tok.type == JSON_TOK_COMMA)
+        {
+            if (!Advance(p))
+                return false;
+            if (p.tok.type != JSON_TOK_STRING)
+                return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+        }
+        else if (p.tok.type != JSON_TOK_OBJECT_END)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+    }
+
+    // Half a coordinate is always an error; none at all is fine for POI_REMOVE
+    unsigned position = rec.fields & (POI_FIELD_LAT | POI_FIELD_LON);
+    if (position == 0)
+    {
+        if (p.firstWithoutPosition < 0)
+        {
+            p.firstWithoutPosition = index;
+            p.firstWithoutPositionOffset = p.tok.offset;
+        }
+    }
+    else if (position != (POI_FIELD_LAT | POI_FIELD_LON))
+        return Error(p, POI_PARSE_ERR_MISSING_LAT_LON);
+    else if (rec.lat < -90.0 || rec.lat > 90.0 || rec.lon < -180.0 || rec.lon > 180.0)
+        return Error(p, POI_PARSE_ERR_OUT_OF_RANGE);
+
+    if (!(rec.fields & POI_FIELD_ID) && p.firstWithoutId < 0)
+    {
+        p.firstWithoutId = index;
+        p.firstWithoutIdOffset = p.tok.offset;
+    }
+
+    if (p.onPoi)
+        p.onPoi(rec, p.ctx);
+    return true;
+}
+
+// Parses the "data" array; p.tok holds the '['
+static bool ParseData(PoiParser& p)
 {
-    std::vector<std::pair<double, double>> result;
+    if (!Advance(p))
+        return false;
+
+    int index = 0;
+    while (p.tok.type != JSON_TOK_ARRAY_END)
+    {
+        if (p.tok.type != JSON_TOK_OBJECT_BEGIN)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+
+        p.result->entry = index;
+        if (!ParseEntry(p, index))
+            return false;
+        p.result->count = (uint32_t)++index;
 
-    // Quick check for message type to avoid unnecessary scanning
-    if (received.find("POI_COORDINATES") == std::string::npos)
-        return result;
+        if (!Advance(p))
+            return false;
+        if (p.tok.type == JSON_TOK_COMMA)
+        {
+            if (!Advance(p))
+                return false;
+            if (p.tok.type != JSON_TOK_OBJECT_BEGIN)
+                return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+        }
+        else if (p.tok.type != JSON_TOK_ARRAY_END)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+    }
+
+    p.result->entry = -1;
+    return true;
+}
 
-    // Find the "data" array open bracket
-    size_t dataPos = received.find("\"data\"");
-    if (dataPos == std::string::npos)
-        return result;
+// "type" strings, indexed by ePoiMessageType
+static const char* const kTypeNames[POI_MSG_COUNT] = {
+    "UNKNOWN",
+    "POI_COORDINATES",
+    "POI_ADD",
+    "POI_REMOVE",
+    "POI_UPDATE",
+    "POI_QUERY_NEAREST",
+    "POI_QUERY_RADIUS",
+    "POI_QUERY_DEDUP",
+    "MARKER_STREAMING",
+    "SPAWN_QUEUE",
+    "GEOFENCE",
+    "TOUR_OPTIMIZE",
+    "TOUR_OPTIMIZER",
+    "METRICS",
+    "TRACE",
+    "TRACE_REPLAY",
+    "POI_UPLOAD_BEGIN",
+    "POI_UPLOAD_CHUNK",
+    "POI_UPLOAD_COMMIT",
+    "POI_UPLOAD_ABORT",
+    "MARKER_LOOKAHEAD",
+    "EMITTER_FOLLOW"
+};
 
-    size_t bracket = received.find('[', dataPos);
-    if (bracket == std::string::npos)
-        return result;
+static ePoiMessageType ClassifyType(const JsonToken& tok)
+{
+    for (int type = POI_MSG_UNKNOWN + 1; type < POI_MSG_COUNT; ++type)
+        if (JsonToken_Equals(tok, kTypeNames[type]))
+            return (ePoiMessageType)type;
+    return POI_MSG_UNKNOWN;
+}
+
+// Keeps a top-level key with a scalar value for the handler; p.tok holds the value
+static bool StoreParam(PoiParser& p, const JsonToken& key)
+{
+    PoiMessageParams& params = p.result->params;
+    if (params.count == POI_MAX_MESSAGE_PARAMS)
+        return Error(p, POI_PARSE_ERR_TOO_MANY_PARAMS);
+
+    params.items[params.count].key = key;
+    params.items[params.count].value = p.tok;
+    params.count++;
+    return true;
+}
+
+static bool ParseTopLevel(PoiParser& p)
+{
+    if (!Expect(p, JSON_TOK_OBJECT_BEGIN) || !Advance(p))
+        return false;
 
-    const char* cstr = received.c_str();
-    const char* ptr = cstr + bracket + 1;
-    char* endptr = nullptr;
+    bool hasCount = false;
+    bool hasData = false;
+    double declaredCount = 0.0;
 
-    // Iterate looking for "lat" then "lon" keys and parse following numbers
-    while (true)
+    while (p.tok.type != JSON_TOK_OBJECT_END)
     {
-        const char* latKey = strstr(ptr, "\"lat\"");
-        if (!latKey) break;
+        if (p.tok.type != JSON_TOK_STRING)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
 
-        const char* colon = strchr(latKey, ':');
-        if (!colon) break;
+        JsonToken key = p.tok;
+        if (!Expect(p, JSON_TOK_COLON) || !Advance(p))
+            return false;
 
-        double lat = strtod(colon + 1, &endptr);
-        if (endptr == colon + 1) break; // no valid number parsed
+        if (JsonToken_Equals(key, "type"))
+        {
+            if (p.tok.type != JSON_TOK_STRING)
+                return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+            p.result->type = ClassifyType(p.tok);
+        }
+        else if (JsonToken_Equals(key, "data"))
+        {
+            if (p.tok.type != JSON_TOK_ARRAY_BEGIN)
+                return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+            // A second array would restart the entry index under records already delivered
+            if (hasData)
+                return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+            hasData = true;
+            if (!ParseData(p))
+                return false;
+        }
+        else if (JsonToken_Equals(key, "count"))
+        {
+            if (p.tok.type != JSON_TOK_NUMBER)
+                return Error(p, POI_PARSE_ERR_FIELD_TYPE);
+            hasCount = true;
+            declaredCount = p.tok.number;
+        }
+        else if (p.tok.type == JSON_TOK_STRING || p.tok.type == JSON_TOK_NUMBER || p.tok.type == JSON_TOK_TRUE
+            || p.tok.type == JSON_TOK_FALSE || p.tok.type == JSON_TOK_NULL)
+        {
+            if (!StoreParam(p, key))
+                return false;
+        }
+        else if (!SkipValue(p))
+            return false;
 
-        const char* lonKey = strstr(endptr, "\"lon\"");
-        if (!lonKey) break;
+        if (!Advance(p))
+            return false;
+        if (p.tok.type == JSON_TOK_COMMA)
+        {
+            if (!Advance(p))
+                return false;
+            if (p.tok.type != JSON_TOK_STRING)
+                return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+        }
+        else if (p.tok.type != JSON_TOK_OBJECT_END)
+            return Error(p, POI_PARSE_ERR_UNEXPECTED_TOKEN);
+    }
+
+    // Nothing but whitespace may follow the top-level object
+    if (!Expect(p, JSON_TOK_END))
+        return false;
+    p.result->params.end = p.tok.offset;
 
-        const char* colonLon = strchr(lonKey, ':');
-        if (!colonLon) break;
+    if (p.result->type == POI_MSG_UNKNOWN)
+        return Error(p, POI_PARSE_ERR_UNKNOWN_TYPE);
 
-        double lon = strtod(colonLon + 1, &endptr);
-        if (endptr == colonLon + 1) break;
+    if (hasCount && declaredCount != (double)p.result->count)
+        return Error(p, POI_PARSE_ERR_COUNT_MISMATCH);
 
-        // Append parsed coordinate pair
-        result.push_back(std::make_pair(lat, lon));
+    if (p.result->type != POI_MSG_REMOVE && p.firstWithoutPosition >= 0)
+    {
+        p.result->entry = p.firstWithoutPosition;
+        p.result->error = POI_PARSE_ERR_MISSING_LAT_LON;
+        p.result->offset = p.firstWithoutPositionOffset;
+        return false;
+    }
 
-        // Advance pointer to continue parsing subsequent entries
-        ptr = endptr;
+    bool keyedById = p.result->type == POI_MSG_ADD || p.result->type == POI_MSG_REMOVE || p.result->type == POI_MSG_UPDATE
+        || p.result->type == POI_MSG_UPLOAD_CHUNK;
+    if (keyedById && p.firstWithoutId >= 0)
+    {
+        p.result->entry = p.firstWithoutId;
+        p.result->error = POI_PARSE_ERR_MISSING_ID;
+        p.result->offset = p.firstWithoutIdOffset;
+        return false;
     }
 
+    return true;
+}
+
+PoiParseResult ParsePoiMessage(const char* buf, size_t size, PoiRecordCallback onPoi, void* ctx)
+{
+    PoiParseResult result;
+    result.error = POI_PARSE_OK;
+    result.jsonError = JSON_ERR_NONE;
+    result.offset = 0;
+    result.entry = -1;
+    result.type = POI_MSG_UNKNOWN;
+    result.count = 0;
+    result.params.count = 0;
+    result.params.end = 0;
+
+    PoiParser p;
+    JsonTokenizer_Init(&p.tz, buf, size);
+    p.result = &result;
+    p.onPoi = onPoi;
+    p.ctx = ctx;
+    p.firstWithoutPosition = -1;
+    p.firstWithoutPositionOffset = 0;
+    p.firstWithoutId = -1;
+    p.firstWithoutIdOffset = 0;
+
+    ParseTopLevel(p);
     return result;
 }
+
+static void CollectCoordinate(const PoiRecord& poi, void* ctx)
+{
+    auto* out = static_cast<std::vector<std::pair<double, double>>*>(ctx);
+    out->push_back(std::make_pair(poi.lat, poi.lon));
+}
+
+PoiParseResult ParsePoiCoordinates(const char* buf, size_t size, std::vector<std::pair<double, double>>& out)
+{
+    out.clear();
+    return ParsePoiMessage(buf, size, CollectCoordinate, &out);
+}
+
+const char* PoiParse_ErrorName(ePoiParseError error)
+{
+    switch (error)
+    {
+    case POI_PARSE_OK:                   return "OK";
+    case POI_PARSE_ERR_JSON:             return "JSON";
+    case POI_PARSE_ERR_UNEXPECTED_TOKEN: return "UNEXPECTED_TOKEN";
+    case POI_PARSE_ERR_FIELD_TYPE:       return "FIELD_TYPE";
+    case POI_PARSE_ERR_MISSING_LAT_LON:  return "MISSING_LAT_LON";
+    case POI_PARSE_ERR_MISSING_ID:       return "MISSING_ID";
+    case POI_PARSE_ERR_OUT_OF_RANGE:     return "OUT_OF_RANGE";
+    case POI_PARSE_ERR_COUNT_MISMATCH:   return "COUNT_MISMATCH";
+    case POI_PARSE_ERR_UNKNOWN_TYPE:     return "UNKNOWN_TYPE";
+    case POI_PARSE_ERR_MISSING_PARAM:    return "MISSING_PARAM";
+    case POI_PARSE_ERR_TOO_DEEP:         return "TOO_DEEP";
+    case POI_PARSE_ERR_TOO_MANY_PARAMS:  return "TOO_MANY_PARAMS";
+    }
+    return "UNKNOWN";
+}
+
+const char* PoiMessage_TypeName(ePoiMessageType type)
+{
+    return type > POI_MSG_UNKNOWN && type < POI_MSG_COUNT ? kTypeNames[type] : kTypeNames[POI_MSG_UNKNOWN];
+}
+
+// -----------------------------------------------------------------------------
+// Parameter readers
+// -----------------------------------------------------------------------------
+
+// Value of the last occurrence of key, nullptr when missing or null
+static const JsonToken* FindParam(const PoiParseResult& msg, const char* key)
+{
+    for (size_t i = msg.params.count; i-- > 0;)
+    {
+        const PoiMessageParam& param = msg.params.items[i];
+        if (JsonToken_Equals(param.key, key))
+            return param.value.type == JSON_TOK_NULL ? nullptr : &param.value;
+    }
+    return nullptr;
+}
+
+static bool ParamError(PoiParseResult& msg, ePoiParseError error, size_t offset)
+{
+    if (msg.error == POI_PARSE_OK)
+    {
+        msg.error = error;
+        msg.offset = offset;
+        msg.entry = -1;
+    }
+    return false;
+}
+
+// Finds a number parameter; a value of another type is FIELD_TYPE
+static const JsonToken* FindNumber(PoiParseResult& msg, const char* key)
+{
+    const JsonToken* value = FindParam(msg, key);
+    if (value && value->type != JSON_TOK_NUMBER)
+    {
+        ParamError(msg, POI_PARSE_ERR_FIELD_TYPE, value->offset);
+        return nullptr;
+    }
+    return value;
+}
+
+bool Param_Bool(PoiParseResult& msg, const char* key, bool* out)
+{
+    const JsonToken* value = FindParam(msg, key);
+    if (!value)
+        return false;
+    if (value->type != JSON_TOK_TRUE && value->type != JSON_TOK_FALSE)
+        return ParamError(msg, POI_PARSE_ERR_FIELD_TYPE, value->offset);
+    *out = value->type == JSON_TOK_TRUE;
+    return true;
+}
+
+bool Param_Double(PoiParseResult& msg, const char* key, double* out)
+{
+    const JsonToken* value = FindNumber(msg, key);
+    if (!value)
+        return false;
+    *out = value->number;
+    return true;
+}
+
+bool Param_DoubleIn(PoiParseResult& msg, const char* key, double minValue, double maxValue, double* out)
+{
+    const JsonToken* value = FindNumber(msg, key);
+    if (!value)
+        return false;
+    if (value->number < minValue || value->number > maxValue)
+        return ParamError(msg, POI_PARSE_ERR_OUT_OF_RANGE, value->offset);
+    *out = value->number;
+    return true;
+}
+
+bool Param_Id(PoiParseResult& msg, const char* key, uint32_t* out)
+{
+    const JsonToken* value = FindNumber(msg, key);
+    if (!value)
+        return false;
+    if (JsonToken_ToUint32(*value, out))
+        return true;
+    return ParamError(msg, value->number == std::floor(value->number) ? POI_PARSE_ERR_OUT_OF_RANGE : POI_PARSE_ERR_FIELD_TYPE,
+        value->offset);
+}
+
+bool Param_Count(PoiParseResult& msg, const char* key, uint32_t minValue, uint32_t* out)
+{
+    const JsonToken* value = FindNumber(msg, key);
+    if (!value)
+        return false;
+    *out = JsonToken_ClampUint32(*value, minValue);
+    return true;
+}
+
+bool Param_Require(PoiParseResult& msg, bool present)
+{
+    if (!present)
+        ParamError(msg, POI_PARSE_ERR_MISSING_PARAM, msg.params.end);
+    return present;
+}
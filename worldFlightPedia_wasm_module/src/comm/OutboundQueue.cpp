@@ -0,0 +1,79 @@
+#include <cstdarg>
+#include <cstdio>
+#include <string>
+#include <MSFS/MSFS_CommBus.h>
+#include "comm/OutboundQueue.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Outbound queue
+// - Records are appended straight into the payload of the next call; the
+//   buffer keeps its capacity, so a steady frame does not allocate
+// -----------------------------------------------------------------------------
+
+static std::string s_batch;
+static uint32_t s_nextSeq = 1;
+static OutboundStats s_stats = { 0, 0, 0, 0 };
+
+static void SendBatch()
+{
+    if (s_batch.empty())
+        return;
+
+    fsCommBusCall("OnMessageFromWasm", s_batch.c_str(), (unsigned int)s_batch.size(), FsCommBusBroadcast_JS);
+    s_stats.calls++;
+    s_stats.bytes += s_batch.size();
+    s_stats.pending = 0;
+    s_batch.clear();
+}
+
+uint32_t OutboundQueue_Send(const char* msg, size_t length)
+{
+    uint32_t seq = s_nextSeq++;
+
+    char prefix[16];
+    int prefixLength = std::snprintf(prefix, sizeof(prefix), "#%u ", (unsigned)seq);
+
+    size_t recordBytes = (s_batch.empty() ? 0 : 1) + (size_t)prefixLength + length;
+    if (!s_batch.empty() && s_batch.size() + recordBytes > COMMBUS_BATCH_MAX_BYTES)
+        SendBatch();
+
+    if (!s_batch.empty())
+        s_batch.push_back('\n');
+    s_batch.append(prefix, (size_t)prefixLength);
+
+    size_t start = s_batch.size();
+    s_batch.append(msg, length);
+    for (size_t i = start; i < s_batch.size(); ++i)
+        if (s_batch[i] == '\n')
+            s_batch[i] = ' ';
+
+    s_stats.messages++;
+    s_stats.pending++;
+    return seq;
+}
+
+uint32_t OutboundQueue_Sendf(const char* format, ...)
+{
+    char msg[OUTBOUND_FORMAT_MAX_BYTES];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(msg, sizeof(msg), format, args);
+    va_end(args);
+
+    if (length < 0)
+        length = 0;
+    if ((size_t)length >= sizeof(msg))
+        length = (int)sizeof(msg) - 1;
+    return OutboundQueue_Send(msg, (size_t)length);
+}
+
+void OutboundQueue_Flush()
+{
+    SendBatch();
+}
+
+void OutboundQueue_GetStats(OutboundStats* stats)
+{
+    *stats = s_stats;
+}
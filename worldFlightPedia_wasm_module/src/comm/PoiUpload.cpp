@@ -0,0 +1,170 @@
+#include <cstring>
+#include <vector>
+#include "comm/PoiUpload.h"
+#include "core/Constants.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// PoiUpload
+// - The upload columns are sized to the full list at BEGIN, so a chunk is a
+//   plain copy into its slot and a resent chunk simply overwrites it
+// - The checksum is computed once, at COMMIT, over the assembled list
+// - Columns keep their capacity between uploads
+// -----------------------------------------------------------------------------
+
+static bool s_open = false;
+static uint32_t s_uploadId = 0;
+static uint32_t s_total = 0;
+static uint32_t s_chunkSize = 0;
+static uint32_t s_checksum = 0;
+static uint32_t s_receivedCount = 0;
+
+static PoiColumns s_coords;
+static std::vector<uint32_t> s_ids;
+static std::vector<uint8_t> s_received; // per chunk
+
+static uint32_t ChunkCount()
+{
+    return (uint32_t)(((uint64_t)s_total + s_chunkSize - 1) / s_chunkSize);
+}
+
+static uint32_t ComputeChecksum()
+{
+    uint32_t hash = 2166136261u;
+    unsigned char bytes[sizeof(uint32_t) + 2 * sizeof(double)];
+    for (size_t i = 0; i < s_ids.size(); ++i)
+    {
+        std::memcpy(bytes, &s_ids[i], sizeof(uint32_t));
+        std::memcpy(bytes + sizeof(uint32_t), &s_coords.lat[i], sizeof(double));
+        std::memcpy(bytes + sizeof(uint32_t) + sizeof(double), &s_coords.lon[i], sizeof(double));
+        for (size_t b = 0; b < sizeof(bytes); ++b)
+        {
+            hash ^= bytes[b];
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+ePoiUploadStatus PoiUpload_Begin(uint32_t uploadId, uint32_t total, uint32_t chunkSize, uint32_t checksum, bool* resumed)
+{
+    *resumed = false;
+    if (chunkSize == 0 || total > POI_UPLOAD_MAX_POIS)
+        return POI_UPLOAD_ERR_BAD_PARAMS;
+
+    if (s_open && uploadId == s_uploadId && total == s_total && chunkSize == s_chunkSize && checksum == s_checksum)
+    {
+        *resumed = true;
+        LOG_INFO("Resumed POI upload %u (%u of %u chunks received)", uploadId, s_receivedCount, ChunkCount());
+        return POI_UPLOAD_OK;
+    }
+
+    s_open = true;
+    s_uploadId = uploadId;
+    s_total = total;
+    s_chunkSize = chunkSize;
+    s_checksum = checksum;
+    s_receivedCount = 0;
+
+    PoiColumns_Resize(s_coords, total);
+    s_ids.resize(total);
+    s_received.assign(ChunkCount(), 0);
+
+    LOG_INFO("Started POI upload %u: %u POIs in %u chunks", uploadId, total, ChunkCount());
+    return POI_UPLOAD_OK;
+}
+
+ePoiUploadStatus PoiUpload_StoreChunk(uint32_t uploadId, uint32_t chunk, const PoiColumns& coords, const std::vector<uint32_t>& ids)
+{
+    if (!s_open || uploadId != s_uploadId)
+        return POI_UPLOAD_ERR_NO_UPLOAD;
+    if (chunk >= ChunkCount())
+        return POI_UPLOAD_ERR_BAD_CHUNK;
+
+    uint32_t first = chunk * s_chunkSize;
+    uint32_t expected = s_total - first < s_chunkSize ? s_total - first : s_chunkSize;
+    if (coords.size() != expected || ids.size() != expected)
+        return POI_UPLOAD_ERR_CHUNK_SIZE;
+
+    for (uint32_t i = 0; i < expected; ++i)
+    {
+        PoiColumns_CopyEntry(s_coords, first + i, coords, i);
+        s_ids[first + i] = ids[i];
+    }
+
+    if (!s_received[chunk])
+    {
+        s_received[chunk] = 1;
+        s_receivedCount++;
+    }
+    return POI_UPLOAD_OK;
+}
+
+ePoiUploadStatus PoiUpload_Commit(uint32_t uploadId, PoiColumns& coords, std::vector<uint32_t>& ids)
+{
+    if (!s_open || uploadId != s_uploadId)
+        return POI_UPLOAD_ERR_NO_UPLOAD;
+    if (s_receivedCount != ChunkCount())
+        return POI_UPLOAD_ERR_INCOMPLETE;
+
+    uint32_t checksum = ComputeChecksum();
+    s_open = false;
+    if (checksum != s_checksum)
+    {
+        LOG_WARN("Dropped POI upload %u: checksum %08x, expected %08x", uploadId, checksum, s_checksum);
+        return POI_UPLOAD_ERR_CHECKSUM;
+    }
+
+    PoiColumns_Swap(coords, s_coords);
+    ids.swap(s_ids);
+    return POI_UPLOAD_OK;
+}
+
+bool PoiUpload_Abort(uint32_t uploadId)
+{
+    if (!s_open || uploadId != s_uploadId)
+        return false;
+
+    s_open = false;
+    LOG_INFO("Aborted POI upload %u", uploadId);
+    return true;
+}
+
+void PoiUpload_Missing(std::vector<uint32_t>& out, size_t max)
+{
+    if (!s_open)
+        return;
+
+    for (uint32_t i = 0; i < s_received.size() && max > 0; ++i)
+    {
+        if (!s_received[i])
+        {
+            out.push_back(i);
+            max--;
+        }
+    }
+}
+
+void PoiUpload_GetStatus(PoiUploadStatus* status)
+{
+    status->open = s_open;
+    status->uploadId = s_uploadId;
+    status->total = s_total;
+    status->chunks = s_open ? ChunkCount() : 0;
+    status->received = s_receivedCount;
+}
+
+const char* PoiUpload_StatusName(ePoiUploadStatus status)
+{
+    switch (status)
+    {
+    case POI_UPLOAD_OK:             return "OK";
+    case POI_UPLOAD_ERR_BAD_PARAMS: return "BAD_PARAMS";
+    case POI_UPLOAD_ERR_NO_UPLOAD:  return "NO_UPLOAD";
+    case POI_UPLOAD_ERR_BAD_CHUNK:  return "BAD_CHUNK";
+    case POI_UPLOAD_ERR_CHUNK_SIZE: return "CHUNK_SIZE";
+    case POI_UPLOAD_ERR_INCOMPLETE: return "INCOMPLETE";
+    case POI_UPLOAD_ERR_CHECKSUM:   return "CHECKSUM";
+    }
+    return "UNKNOWN";
+}
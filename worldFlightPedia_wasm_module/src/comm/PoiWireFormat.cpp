@@ -0,0 +1,117 @@
+#include <cstring>
+#include <cstdint>
+#include "comm/PoiWireFormat.h"
+
+// -----------------------------------------------------------------------------
+// PoiWireFormat
+// Zero-copy reader for the binary POI message. The header is validated once;
+// element reads go through memcpy so that a CommBus buffer with arbitrary
+// alignment is still read correctly (the copy compiles down to a plain load).
+// -----------------------------------------------------------------------------
+
+bool PoiWire_IsBinary(const char* buf, size_t bufSize)
+{
+    if (!buf || bufSize < sizeof(uint32_t))
+        return false;
+
+    uint32_t magic = 0;
+    std::memcpy(&magic, buf, sizeof(magic));
+    return magic == POI_WIRE_MAGIC;
+}
+
+ePoiWireStatus PoiWire_Parse(const char* buf, size_t bufSize, PoiWireView* out)
+{
+    if (!buf || bufSize < sizeof(PoiWireHeader))
+        return POI_WIRE_ERR_TOO_SHORT;
+
+    PoiWireHeader header;
+    std::memcpy(&header, buf, sizeof(header));
+
+    if (header.magic != POI_WIRE_MAGIC)
+        return POI_WIRE_ERR_BAD_MAGIC;
+
+    // Newer senders may grow the header; older headers are never accepted
+    if (header.version == 0 || header.version > POI_WIRE_VERSION || header.headerSize < sizeof(PoiWireHeader))
+        return POI_WIRE_ERR_BAD_VERSION;
+
+    if (header.type < POI_WIRE_TYPE_COORDINATES || header.type > POI_WIRE_TYPE_CHUNK)
+        return POI_WIRE_ERR_BAD_TYPE;
+
+    const bool hasIds = (header.flags & POI_WIRE_FLAG_HAS_IDS) != 0;
+    const bool hasCoords = header.type != POI_WIRE_TYPE_REMOVE;
+
+    // Diff messages are keyed by id
+    if (header.type != POI_WIRE_TYPE_COORDINATES && !hasIds)
+        return POI_WIRE_ERR_MISSING_IDS;
+
+    // Compute the payload size in 64 bits so a hostile count cannot wrap
+    uint64_t perPoi = (hasCoords ? 2 * sizeof(double) : 0) + (hasIds ? sizeof(uint32_t) : 0);
+    uint64_t needed = (uint64_t)header.headerSize + (uint64_t)header.count * perPoi;
+    if (needed > bufSize)
+        return POI_WIRE_ERR_TRUNCATED;
+
+    const unsigned char* base = reinterpret_cast<const unsigned char*>(buf) + header.headerSize;
+
+    out->type = header.type;
+    out->count = header.count;
+    out->sequence = header.sequence;
+    out->upload = header.upload;
+    size_t coordBytes = hasCoords ? (size_t)header.count * sizeof(double) : 0;
+    out->lat = hasCoords ? base : nullptr;
+    out->lon = hasCoords ? base + coordBytes : nullptr;
+    out->ids = hasIds ? base + 2 * coordBytes : nullptr;
+    out->entry = -1;
+
+    // Same ranges as the text format; NaN fails both comparisons
+    for (uint32_t i = 0; hasCoords && i < header.count; ++i)
+    {
+        double lat = PoiWire_Lat(*out, i);
+        double lon = PoiWire_Lon(*out, i);
+        if (!(lat >= -90.0 && lat <= 90.0) || !(lon >= -180.0 && lon <= 180.0))
+        {
+            out->entry = (int)i;
+            return POI_WIRE_ERR_OUT_OF_RANGE;
+        }
+    }
+    return POI_WIRE_OK;
+}
+
+const char* PoiWire_StatusName(ePoiWireStatus status)
+{
+    switch (status)
+    {
+    case POI_WIRE_OK:              return "OK";
+    case POI_WIRE_ERR_TOO_SHORT:   return "TOO_SHORT";
+    case POI_WIRE_ERR_BAD_MAGIC:   return "BAD_MAGIC";
+    case POI_WIRE_ERR_BAD_VERSION: return "BAD_VERSION";
+    case POI_WIRE_ERR_BAD_TYPE:    return "BAD_TYPE";
+    case POI_WIRE_ERR_TRUNCATED:   return "TRUNCATED";
+    case POI_WIRE_ERR_MISSING_IDS: return "MISSING_IDS";
+    case POI_WIRE_ERR_OUT_OF_RANGE: return "OUT_OF_RANGE";
+    }
+    return "UNKNOWN";
+}
+
+double PoiWire_Lat(const PoiWireView& view, uint32_t index)
+{
+    double v;
+    std::memcpy(&v, view.lat + (size_t)index * sizeof(double), sizeof(v));
+    return v;
+}
+
+double PoiWire_Lon(const PoiWireView& view, uint32_t index)
+{
+    double v;
+    std::memcpy(&v, view.lon + (size_t)index * sizeof(double), sizeof(v));
+    return v;
+}
+
+uint32_t PoiWire_Id(const PoiWireView& view, uint32_t index)
+{
+    if (!view.ids)
+        return index;
+
+    uint32_t v;
+    std::memcpy(&v, view.ids + (size_t)index * sizeof(uint32_t), sizeof(v));
+    return v;
+}
@@ -0,0 +1,77 @@
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "comm/ReplyBuilder.h"
+#include "comm/OutboundQueue.h"
+#include "core/Arena.h"
+
+// -----------------------------------------------------------------------------
+// Reply builder
+// - The text stays NUL-terminated (capacity keeps one byte spare), so
+//   Reply_Appendf can format straight into the buffer
+// -----------------------------------------------------------------------------
+
+static void Reserve(ReplyBuilder& reply, size_t extra)
+{
+    size_t needed = reply.size + extra + 1;
+    if (needed <= reply.capacity)
+        return;
+
+    size_t capacity = reply.capacity * 2;
+    if (capacity < needed)
+        capacity = needed;
+
+    char* data = (char*)Arena_Alloc(capacity, 1);
+    std::memcpy(data, reply.data, reply.size + 1);
+    reply.data = data;
+    reply.capacity = capacity;
+}
+
+void Reply_Begin(ReplyBuilder& reply, size_t capacityHint)
+{
+    reply.capacity = capacityHint + 1;
+    reply.data = (char*)Arena_Alloc(reply.capacity, 1);
+    reply.data[0] = '\0';
+    reply.size = 0;
+}
+
+void Reply_Append(ReplyBuilder& reply, const char* text, size_t length)
+{
+    Reserve(reply, length);
+    std::memcpy(reply.data + reply.size, text, length);
+    reply.size += length;
+    reply.data[reply.size] = '\0';
+}
+
+void Reply_AppendStr(ReplyBuilder& reply, const char* text)
+{
+    Reply_Append(reply, text, std::strlen(text));
+}
+
+void Reply_Appendf(ReplyBuilder& reply, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list retry;
+    va_copy(retry, args);
+
+    size_t room = reply.capacity - reply.size;
+    int length = std::vsnprintf(reply.data + reply.size, room, format, args);
+    if (length >= 0 && (size_t)length >= room)
+    {
+        Reserve(reply, (size_t)length);
+        std::vsnprintf(reply.data + reply.size, (size_t)length + 1, format, retry);
+    }
+    if (length > 0)
+        reply.size += (size_t)length;
+    else
+        reply.data[reply.size] = '\0';
+
+    va_end(retry);
+    va_end(args);
+}
+
+uint32_t Reply_Send(const ReplyBuilder& reply)
+{
+    return OutboundQueue_Send(reply.data, reply.size);
+}
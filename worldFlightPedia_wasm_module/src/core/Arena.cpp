@@ -0,0 +1,80 @@
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "core/Arena.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Arena
+// - Blocks are used in order; an allocation that does not fit the current
+//   block moves on to the next one large enough (skipped space is reclaimed
+//   on release) or appends a new block of at least ARENA_BLOCK_BYTES
+// -----------------------------------------------------------------------------
+
+struct ArenaBlock
+{
+    char* data;
+    size_t size;
+};
+
+static std::vector<ArenaBlock> s_blocks;
+static size_t s_block = 0; // block in use
+static size_t s_used = 0;  // bytes used in it
+static size_t s_reserved = 0;
+
+static size_t AlignUp(size_t value, size_t align)
+{
+    return (value + align - 1) & ~(align - 1);
+}
+
+void* Arena_Alloc(size_t bytes, size_t align)
+{
+    if (bytes == 0)
+        bytes = 1;
+
+    while (s_block < s_blocks.size())
+    {
+        ArenaBlock& block = s_blocks[s_block];
+        // Blocks come from malloc, so aligning the offset aligns the address
+        // for every align up to alignof(max_align_t)
+        size_t offset = AlignUp(s_used, align);
+        if (offset + bytes <= block.size)
+        {
+            s_used = offset + bytes;
+            return block.data + offset;
+        }
+        ++s_block;
+        s_used = 0;
+    }
+
+    ArenaBlock block;
+    block.size = bytes > ARENA_BLOCK_BYTES ? bytes : ARENA_BLOCK_BYTES;
+    block.data = (char*)std::malloc(block.size);
+    if (!block.data)
+        std::abort(); // no exceptions in the module
+    s_blocks.push_back(block);
+    s_reserved += block.size;
+
+    s_block = s_blocks.size() - 1;
+    s_used = bytes;
+    return block.data;
+}
+
+ArenaMark Arena_Mark()
+{
+    ArenaMark mark;
+    mark.block = s_block;
+    mark.used = s_used;
+    return mark;
+}
+
+void Arena_Release(ArenaMark mark)
+{
+    s_block = mark.block;
+    s_used = mark.used;
+}
+
+size_t Arena_ReservedBytes()
+{
+    return s_reserved;
+}
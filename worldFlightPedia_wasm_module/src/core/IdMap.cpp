@@ -0,0 +1,130 @@
+#include <cstring>
+#include <utility>
+#include "core/IdMap.h"
+
+// -----------------------------------------------------------------------------
+// IdMap
+// - Fibonacci hashing: the top bits of key * 2^32/phi pick the home slot, so
+//   sequential ids (and ids differing only in their high bits) spread over
+//   the table
+// -----------------------------------------------------------------------------
+
+static const size_t kMinSlots = 16;
+
+static size_t HomeOf(const IdMap& m, uint32_t key)
+{
+    uint32_t hash = key * 2654435769u;
+    return (size_t)(((uint64_t)hash * m.slots.size()) >> 32);
+}
+
+// Slot holding key, or the empty slot where it would go
+static size_t Probe(const IdMap& m, uint32_t key)
+{
+    size_t mask = m.slots.size() - 1;
+    size_t i = HomeOf(m, key);
+    while (m.slots[i].valuePlusOne && m.slots[i].key != key)
+        i = (i + 1) & mask;
+    return i;
+}
+
+static void Rehash(IdMap& m, size_t slotCount)
+{
+    std::vector<IdMapSlot> old;
+    old.swap(m.slots);
+    m.slots.assign(slotCount, IdMapSlot());
+
+    for (size_t i = 0; i < old.size(); ++i)
+    {
+        if (old[i].valuePlusOne)
+            m.slots[Probe(m, old[i].key)] = old[i];
+    }
+}
+
+void IdMap_Clear(IdMap& m)
+{
+    if (m.count)
+        std::memset(m.slots.data(), 0, m.slots.size() * sizeof(IdMapSlot));
+    m.count = 0;
+}
+
+void IdMap_Reserve(IdMap& m, size_t count)
+{
+    size_t slotCount = m.slots.empty() ? kMinSlots : m.slots.size();
+    while (count * 4 > slotCount * 3)
+        slotCount *= 2;
+    if (slotCount != m.slots.size())
+        Rehash(m, slotCount);
+}
+
+bool IdMap_Find(const IdMap& m, uint32_t key, uint32_t* value)
+{
+    if (!m.count)
+        return false;
+
+    const IdMapSlot& slot = m.slots[Probe(m, key)];
+    if (!slot.valuePlusOne)
+        return false;
+    *value = slot.valuePlusOne - 1;
+    return true;
+}
+
+bool IdMap_Insert(IdMap& m, uint32_t key, uint32_t value)
+{
+    IdMap_Reserve(m, m.count + 1);
+
+    IdMapSlot& slot = m.slots[Probe(m, key)];
+    if (slot.valuePlusOne)
+        return false;
+    slot.key = key;
+    slot.valuePlusOne = value + 1;
+    m.count++;
+    return true;
+}
+
+void IdMap_Set(IdMap& m, uint32_t key, uint32_t value)
+{
+    IdMap_Reserve(m, m.count + 1);
+
+    IdMapSlot& slot = m.slots[Probe(m, key)];
+    if (!slot.valuePlusOne)
+        m.count++;
+    slot.key = key;
+    slot.valuePlusOne = value + 1;
+}
+
+bool IdMap_Erase(IdMap& m, uint32_t key)
+{
+    if (!m.count)
+        return false;
+
+    size_t mask = m.slots.size() - 1;
+    size_t hole = Probe(m, key);
+    if (!m.slots[hole].valuePlusOne)
+        return false;
+
+    // Move back every following entry of the cluster whose home slot does not
+    // lie between the hole and its current slot
+    size_t i = hole;
+    for (;;)
+    {
+        i = (i + 1) & mask;
+        if (!m.slots[i].valuePlusOne)
+            break;
+        size_t home = HomeOf(m, m.slots[i].key);
+        bool stays = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!stays)
+        {
+            m.slots[hole] = m.slots[i];
+            hole = i;
+        }
+    }
+    m.slots[hole] = IdMapSlot();
+    m.count--;
+    return true;
+}
+
+void IdMap_Swap(IdMap& a, IdMap& b)
+{
+    a.slots.swap(b.slots);
+    std::swap(a.count, b.count);
+}
@@ -0,0 +1,302 @@
+#include <cstdio>
+#include <cstring>
+#include "core/Log.h"
+#include "core/Constants.h"
+
+// -----------------------------------------------------------------------------
+// Log
+// - Ring of fixed-size records; head/tail are free-running counters (the
+//   module is single-threaded, so no atomics)
+// - A record holds the format pointer, the raw arguments and a small text
+//   area for copies of string arguments
+// - Flushing walks the format once, formatting each conversion on its own
+//   with snprintf (integers are widened to long long, so length modifiers
+//   in the format are replaced)
+// -----------------------------------------------------------------------------
+
+static const size_t kTextBytes = 128;    // string argument copies per record
+static const size_t kLineBytes = 512;    // longest formatted line
+
+struct LogRecord
+{
+    const char* fmt;
+    uint8_t level;
+    uint8_t argc;
+    LogArg args[LOG_MAX_ARGS];
+    char text[kTextBytes];
+};
+
+static LogRecord s_ring[LOG_RING_CAPACITY];
+static uint32_t s_head = 0; // next record to write
+static uint32_t s_tail = 0; // next record to flush
+static LogStats s_stats = { 0, 0, 0, 0, 0, 0, LOG_RING_CAPACITY };
+static uint64_t s_droppedReported = 0;
+
+// One conversion specification of a printf format
+struct FormatSpec
+{
+    char conv;         // conversion character, 0 at the end of the format
+    int stars;         // '*' width / precision taking an int argument
+    bool precisionStar;
+    int precision;     // explicit precision digits, -1 when none
+    char text[24];     // spec without length modifiers, e.g. "%-8.3"
+    size_t textLength;
+};
+
+// Parses the spec starting at f (just past '%'); returns the first char after it
+static const char* ParseSpec(const char* f, FormatSpec& spec)
+{
+    spec.stars = 0;
+    spec.precisionStar = false;
+    spec.precision = -1;
+    spec.textLength = 0;
+    spec.text[spec.textLength++] = '%';
+
+    auto keep = [&spec](char c) {
+        if (spec.textLength < sizeof(spec.text) - 4)
+            spec.text[spec.textLength++] = c;
+    };
+
+    while (*f && std::strchr("-+ #0", *f))
+        keep(*f++);
+    if (*f == '*')
+    {
+        keep(*f++);
+        spec.stars++;
+    }
+    while (*f >= '0' && *f <= '9')
+        keep(*f++);
+    if (*f == '.')
+    {
+        keep(*f++);
+        if (*f == '*')
+        {
+            keep(*f++);
+            spec.stars++;
+            spec.precisionStar = true;
+        }
+        else
+        {
+            spec.precision = 0;
+            while (*f >= '0' && *f <= '9')
+            {
+                spec.precision = spec.precision * 10 + (*f - '0');
+                keep(*f++);
+            }
+        }
+    }
+    while (*f && std::strchr("hljztL", *f))
+        ++f; // length modifiers are chosen from the stored argument type
+    spec.conv = *f;
+    return *f ? f + 1 : f;
+}
+
+void Log_Push(int level, const char* fmt, const LogArg* args, size_t argc)
+{
+    if (s_head - s_tail >= LOG_RING_CAPACITY)
+    {
+        s_stats.dropped++;
+        return;
+    }
+
+    LogRecord& rec = s_ring[s_head % LOG_RING_CAPACITY];
+    rec.fmt = fmt;
+    rec.level = (uint8_t)level;
+    rec.argc = (uint8_t)argc;
+
+    bool hasString = false;
+    for (size_t i = 0; i < argc; ++i)
+    {
+        rec.args[i] = args[i];
+        hasString = hasString || args[i].type == LOG_ARG_STRING;
+    }
+
+    // String arguments are copied; walking the format gives their precision,
+    // so a "%.*s" buffer without terminator is never read past its length
+    size_t textUsed = 0;
+    size_t argIndex = 0;
+    const char* f = hasString ? fmt : nullptr;
+    while (f && *f && argIndex < argc)
+    {
+        if (*f != '%')
+        {
+            ++f;
+            continue;
+        }
+        if (f[1] == '%')
+        {
+            f += 2;
+            continue;
+        }
+
+        FormatSpec spec;
+        f = ParseSpec(f + 1, spec);
+        long long starPrecision = -1;
+        for (int s = 0; s < spec.stars && argIndex < argc; ++s, ++argIndex)
+            if (spec.precisionStar && s == spec.stars - 1)
+                starPrecision = args[argIndex].i;
+        if (argIndex >= argc)
+            break;
+
+        LogArg& a = rec.args[argIndex++];
+        if (a.type != LOG_ARG_STRING)
+            continue;
+
+        const char* src = a.s ? a.s : "(null)";
+        size_t room = kTextBytes - 1 - textUsed;
+        size_t limit = room;
+        if (spec.precision >= 0 && (size_t)spec.precision < limit)
+            limit = (size_t)spec.precision;
+        if (starPrecision >= 0 && (size_t)starPrecision < limit)
+            limit = (size_t)starPrecision;
+
+        size_t length = 0;
+        while (length < limit && src[length])
+            ++length;
+        if (length == room && src[length])
+            s_stats.truncated++;
+
+        std::memcpy(rec.text + textUsed, src, length);
+        rec.text[textUsed + length] = '\0';
+        a.s = rec.text + textUsed;
+        textUsed += length + 1;
+        if (textUsed > kTextBytes - 1)
+            textUsed = kTextBytes - 1; // later strings come out empty
+    }
+
+    s_head++;
+    s_stats.written++;
+    uint32_t pending = s_head - s_tail;
+    if (pending > s_stats.highWater)
+        s_stats.highWater = pending;
+}
+
+// Formats one conversion; returns the characters written (clamped to size)
+static size_t FormatOne(char* out, size_t size, FormatSpec& spec, const int* stars, const LogArg* a)
+{
+    if (!a)
+        return (size_t)std::snprintf(out, size, "?");
+
+    // Length modifier for the widened argument, then the conversion
+    char* end = spec.text + spec.textLength;
+    if (std::strchr("diouxX", spec.conv))
+    {
+        *end++ = 'l';
+        *end++ = 'l';
+    }
+    *end++ = spec.conv;
+    *end = '\0';
+
+    int n = 0;
+    switch (spec.conv)
+    {
+    case 'd': case 'i':
+    case 'o': case 'u': case 'x': case 'X':
+    {
+        long long v = a->type == LOG_ARG_DOUBLE ? (long long)a->d : a->i;
+        if (spec.stars == 2)      n = std::snprintf(out, size, spec.text, stars[0], stars[1], v);
+        else if (spec.stars == 1) n = std::snprintf(out, size, spec.text, stars[0], v);
+        else                      n = std::snprintf(out, size, spec.text, v);
+        break;
+    }
+    case 'c':
+    {
+        int v = (int)a->i;
+        if (spec.stars == 1) n = std::snprintf(out, size, spec.text, stars[0], v);
+        else                 n = std::snprintf(out, size, spec.text, v);
+        break;
+    }
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+    {
+        double v = a->type == LOG_ARG_DOUBLE ? a->d : (a->type == LOG_ARG_INT ? (double)a->i : (double)a->u);
+        if (spec.stars == 2)      n = std::snprintf(out, size, spec.text, stars[0], stars[1], v);
+        else if (spec.stars == 1) n = std::snprintf(out, size, spec.text, stars[0], v);
+        else                      n = std::snprintf(out, size, spec.text, v);
+        break;
+    }
+    case 's':
+    {
+        const char* v = a->type == LOG_ARG_STRING && a->s ? a->s : "(null)";
+        if (spec.stars == 2)      n = std::snprintf(out, size, spec.text, stars[0], stars[1], v);
+        else if (spec.stars == 1) n = std::snprintf(out, size, spec.text, stars[0], v);
+        else                      n = std::snprintf(out, size, spec.text, v);
+        break;
+    }
+    case 'p':
+        n = std::snprintf(out, size, "%p", a->p);
+        break;
+    default:
+        n = std::snprintf(out, size, "?");
+        break;
+    }
+
+    if (n < 0)
+        return 0;
+    return (size_t)n < size ? (size_t)n : size - 1;
+}
+
+static void FormatRecord(const LogRecord& rec, char* out, size_t size)
+{
+    size_t used = 0;
+    size_t argIndex = 0;
+    const char* f = rec.fmt;
+
+    while (*f && used + 1 < size)
+    {
+        if (*f != '%')
+        {
+            out[used++] = *f++;
+            continue;
+        }
+        if (f[1] == '%')
+        {
+            out[used++] = '%';
+            f += 2;
+            continue;
+        }
+
+        FormatSpec spec;
+        f = ParseSpec(f + 1, spec);
+        if (!spec.conv)
+            break;
+
+        int stars[2] = { 0, 0 };
+        for (int s = 0; s < spec.stars; ++s)
+            stars[s] = argIndex < rec.argc ? (int)rec.args[argIndex++].i : 0;
+
+        const LogArg* a = argIndex < rec.argc ? &rec.args[argIndex++] : nullptr;
+        used += FormatOne(out + used, size - used, spec, stars, a);
+    }
+    out[used] = '\0';
+}
+
+void Log_Flush(uint32_t maxLines)
+{
+    char line[kLineBytes];
+    for (uint32_t i = 0; i < maxLines && s_tail != s_head; ++i)
+    {
+        FormatRecord(s_ring[s_tail % LOG_RING_CAPACITY], line, sizeof(line));
+        s_tail++;
+        s_stats.flushed++;
+        std::fprintf(stderr, "[MSFS] %s\n", line);
+    }
+
+    if (s_stats.dropped != s_droppedReported)
+    {
+        std::fprintf(stderr, "[MSFS] Log: %llu messages dropped (ring of %u full, %llu dropped in total)\n",
+            (unsigned long long)(s_stats.dropped - s_droppedReported), (unsigned)LOG_RING_CAPACITY,
+            (unsigned long long)s_stats.dropped);
+        s_droppedReported = s_stats.dropped;
+    }
+}
+
+void Log_FlushAll()
+{
+    Log_Flush(LOG_RING_CAPACITY);
+}
+
+void Log_GetStats(LogStats* stats)
+{
+    *stats = s_stats;
+    stats->pending = s_head - s_tail;
+}
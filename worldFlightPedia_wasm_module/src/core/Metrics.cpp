@@ -0,0 +1,197 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "core/Metrics.h"
+#include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// Metrics
+// - Fixed arrays indexed by route / counter; recording never allocates
+// - Durations are kept in nanoseconds and reported in microseconds
+// - Periodic snapshots run on a Scheduler timer that re-arms itself
+// -----------------------------------------------------------------------------
+
+static MetricHistogram s_routes[METRIC_ROUTE_COUNT];
+static uint64_t s_counters[METRIC_COUNTER_COUNT];
+static uint64_t s_windowStartNs = 0; // last reset
+
+static uint32_t s_pushIntervalMs = METRICS_PUSH_INTERVAL_MS;
+static TimerHandle s_pushTimer = 0;
+
+static std::string s_snapshot; // keeps its capacity between snapshots
+
+static const char* const kRouteNames[METRIC_ROUTE_COUNT] =
+{
+    "dispatch", "frame", "lvar", "assignedId", "userPosition", "commBus", "spawn", "remove"
+};
+
+static const char* const kCounterNames[METRIC_COUNTER_COUNT] =
+{
+    "createsIssued", "idsAssigned", "removes", "failures", "poisParsed", "messages", "messagesRejected",
+    "emitterFrames", "emitterUpdates"
+};
+
+static std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+
+uint64_t Metrics_NowNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+// Bucket 0: < 1 us; bucket b: [2^(b-1), 2^b) us; the last bucket is open-ended
+static size_t BucketOf(uint64_t ns)
+{
+    uint64_t us = ns / 1000;
+    size_t bucket = 0;
+    while (us && bucket < METRIC_BUCKETS - 1)
+    {
+        us >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void Metrics_Record(eMetricRoute route, uint64_t startNs)
+{
+    uint64_t now = Metrics_NowNs();
+    uint64_t ns = now > startNs ? now - startNs : 0;
+
+    MetricHistogram& h = s_routes[route];
+    h.count++;
+    h.totalNs += ns;
+    if (ns > h.maxNs)
+        h.maxNs = ns;
+    h.buckets[BucketOf(ns)]++;
+}
+
+void Metrics_Count(eMetricCounter counter, uint32_t amount)
+{
+    s_counters[counter] += amount;
+}
+
+const MetricHistogram& Metrics_GetHistogram(eMetricRoute route)
+{
+    return s_routes[route];
+}
+
+uint64_t Metrics_GetCounter(eMetricCounter counter)
+{
+    return s_counters[counter];
+}
+
+void Metrics_Reset()
+{
+    std::memset(s_routes, 0, sizeof(s_routes));
+    std::memset(s_counters, 0, sizeof(s_counters));
+    s_windowStartNs = Metrics_NowNs();
+}
+
+// -----------------------------------------------------------------------------
+// Snapshot
+// -----------------------------------------------------------------------------
+
+void Metrics_SendSnapshot(uint32_t requestId)
+{
+    s_snapshot.clear();
+
+    char item[160];
+    int len = std::snprintf(item, sizeof(item), "{\"type\":\"METRICS\",\"requestId\":%u,\"windowMs\":%llu,\"counters\":{",
+        (unsigned)requestId, (unsigned long long)((Metrics_NowNs() - s_windowStartNs) / 1000000));
+    s_snapshot.append(item, (size_t)len);
+
+    for (size_t c = 0; c < METRIC_COUNTER_COUNT; ++c)
+    {
+        len = std::snprintf(item, sizeof(item), "%s\"%s\":%llu", c ? "," : "",
+            kCounterNames[c], (unsigned long long)s_counters[c]);
+        s_snapshot.append(item, (size_t)len);
+    }
+    s_snapshot.append("},\"routes\":{");
+
+    for (size_t r = 0; r < METRIC_ROUTE_COUNT; ++r)
+    {
+        const MetricHistogram& h = s_routes[r];
+        len = std::snprintf(item, sizeof(item), "%s\"%s\":{\"n\":%llu,\"totalUs\":%llu,\"maxUs\":%.1f,\"buckets\":[",
+            r ? "," : "", kRouteNames[r], (unsigned long long)h.count,
+            (unsigned long long)(h.totalNs / 1000), (double)h.maxNs / 1000.0);
+        s_snapshot.append(item, (size_t)len);
+
+        size_t used = METRIC_BUCKETS;
+        while (used > 0 && h.buckets[used - 1] == 0)
+            --used;
+        for (size_t b = 0; b < used; ++b)
+        {
+            len = std::snprintf(item, sizeof(item), b ? ",%u" : "%u", (unsigned)h.buckets[b]);
+            s_snapshot.append(item, (size_t)len);
+        }
+        s_snapshot.append("]}");
+    }
+
+    LogStats log;
+    Log_GetStats(&log);
+    len = std::snprintf(item, sizeof(item), "},\"log\":{\"written\":%llu,\"dropped\":%llu,\"highWater\":%u}",
+        (unsigned long long)log.written, (unsigned long long)log.dropped, (unsigned)log.highWater);
+    s_snapshot.append(item, (size_t)len);
+
+    OutboundStats out;
+    OutboundQueue_GetStats(&out);
+    len = std::snprintf(item, sizeof(item), ",\"outbound\":{\"messages\":%llu,\"calls\":%llu,\"bytes\":%llu}}",
+        (unsigned long long)out.messages, (unsigned long long)out.calls, (unsigned long long)out.bytes);
+    s_snapshot.append(item, (size_t)len);
+
+    OutboundQueue_Send(s_snapshot.c_str(), s_snapshot.size());
+}
+
+static void OnPushTimer(void*)
+{
+    s_pushTimer = 0;
+    if (!s_pushIntervalMs)
+        return;
+
+    Metrics_SendSnapshot(0);
+    s_pushTimer = Scheduler_Schedule(s_pushIntervalMs, OnPushTimer, nullptr);
+}
+
+void Metrics_SetPushInterval(uint32_t intervalMs)
+{
+    if (s_pushTimer)
+    {
+        Scheduler_Cancel(s_pushTimer);
+        s_pushTimer = 0;
+    }
+
+    s_pushIntervalMs = intervalMs;
+    if (intervalMs)
+        s_pushTimer = Scheduler_Schedule(intervalMs, OnPushTimer, nullptr);
+    LOG_INFO("Metrics: snapshot every %u ms%s", (unsigned)intervalMs, intervalMs ? "" : " (on request only)");
+}
+
+uint32_t Metrics_GetPushInterval()
+{
+    return s_pushIntervalMs;
+}
+
+bool Metrics_OnMessage(PoiParseResult& msg)
+{
+    uint32_t requestId = 0;
+    bool reset = false;
+    uint32_t intervalMs = 0;
+    Param_Id(msg, "requestId", &requestId);
+    Param_Bool(msg, "reset", &reset);
+    bool hasInterval = Param_Count(msg, "intervalMs", 0, &intervalMs);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    if (hasInterval)
+        Metrics_SetPushInterval(intervalMs);
+
+    Metrics_SendSnapshot(requestId);
+    if (reset)
+        Metrics_Reset();
+    return true;
+}
@@ -6,11 +6,9 @@
 
 HANDLE g_hSimConnect = 0;
 DWORD g_lasersID = SIMCONNECT_OBJECT_ID_USER;
-std::vector<std::pair<double, double>> g_poi_coords;
+PoiColumns g_poi_coords;
+std::vector<uint32_t> g_poi_ids;
 
-double g_lastSpawnState = -1.0;
-double g_lastStartFlight = -1.0;
-double g_lastNextPoi = -1.0;
 bool   g_flightActive = false;
 int    g_activePoiIndex = -1;
 
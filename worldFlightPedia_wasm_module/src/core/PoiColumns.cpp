@@ -0,0 +1,119 @@
+#include <cmath>
+#include "core/PoiColumns.h"
+#include "geo/Geodesy.h"
+
+// -----------------------------------------------------------------------------
+// PoiColumns
+// - Derived columns are always written together with lat/lon, so they can
+//   never disagree with the position
+// -----------------------------------------------------------------------------
+
+
+struct DerivedColumns
+{
+    double x, y, z, cosLat;
+};
+
+static DerivedColumns Derive(double latDeg, double lonDeg)
+{
+    double lat = latDeg * GEO_DEG_TO_RAD;
+    double lon = lonDeg * GEO_DEG_TO_RAD;
+    DerivedColumns d;
+    d.cosLat = std::cos(lat);
+    d.x = d.cosLat * std::cos(lon);
+    d.y = d.cosLat * std::sin(lon);
+    d.z = std::sin(lat);
+    return d;
+}
+
+void PoiColumns_Clear(PoiColumns& c)
+{
+    c.lat.clear();
+    c.lon.clear();
+    c.x.clear();
+    c.y.clear();
+    c.z.clear();
+    c.cosLat.clear();
+}
+
+void PoiColumns_Reserve(PoiColumns& c, size_t count)
+{
+    c.lat.reserve(count);
+    c.lon.reserve(count);
+    c.x.reserve(count);
+    c.y.reserve(count);
+    c.z.reserve(count);
+    c.cosLat.reserve(count);
+}
+
+void PoiColumns_Resize(PoiColumns& c, size_t count)
+{
+    c.lat.resize(count);
+    c.lon.resize(count);
+    c.x.resize(count);
+    c.y.resize(count);
+    c.z.resize(count);
+    c.cosLat.resize(count);
+}
+
+void PoiColumns_Append(PoiColumns& c, double latDeg, double lonDeg)
+{
+    DerivedColumns d = Derive(latDeg, lonDeg);
+    c.lat.push_back(latDeg);
+    c.lon.push_back(lonDeg);
+    c.x.push_back(d.x);
+    c.y.push_back(d.y);
+    c.z.push_back(d.z);
+    c.cosLat.push_back(d.cosLat);
+}
+
+void PoiColumns_Set(PoiColumns& c, size_t i, double latDeg, double lonDeg)
+{
+    DerivedColumns d = Derive(latDeg, lonDeg);
+    c.lat[i] = latDeg;
+    c.lon[i] = lonDeg;
+    c.x[i] = d.x;
+    c.y[i] = d.y;
+    c.z[i] = d.z;
+    c.cosLat[i] = d.cosLat;
+}
+
+void PoiColumns_Erase(PoiColumns& c, size_t i)
+{
+    c.lat.erase(c.lat.begin() + i);
+    c.lon.erase(c.lon.begin() + i);
+    c.x.erase(c.x.begin() + i);
+    c.y.erase(c.y.begin() + i);
+    c.z.erase(c.z.begin() + i);
+    c.cosLat.erase(c.cosLat.begin() + i);
+}
+
+void PoiColumns_Swap(PoiColumns& a, PoiColumns& b)
+{
+    a.lat.swap(b.lat);
+    a.lon.swap(b.lon);
+    a.x.swap(b.x);
+    a.y.swap(b.y);
+    a.z.swap(b.z);
+    a.cosLat.swap(b.cosLat);
+}
+
+void PoiColumns_CopyEntry(PoiColumns& dst, size_t dstIndex, const PoiColumns& src, size_t srcIndex)
+{
+    dst.lat[dstIndex] = src.lat[srcIndex];
+    dst.lon[dstIndex] = src.lon[srcIndex];
+    dst.x[dstIndex] = src.x[srcIndex];
+    dst.y[dstIndex] = src.y[srcIndex];
+    dst.z[dstIndex] = src.z[srcIndex];
+    dst.cosLat[dstIndex] = src.cosLat[srcIndex];
+}
+
+void PoiColumns_AssignTail(PoiColumns& dst, const PoiColumns& src, size_t first)
+{
+    dst.lat.assign(src.lat.begin() + first, src.lat.end());
+    dst.lon.assign(src.lon.begin() + first, src.lon.end());
+    dst.x.assign(src.x.begin() + first, src.x.end());
+    dst.y.assign(src.y.begin() + first, src.y.end());
+    dst.z.assign(src.z.begin() + first, src.z.end());
+    dst.cosLat.assign(src.cosLat.begin() + first, src.cosLat.end());
+}
@@ -0,0 +1,165 @@
+#include <cstdio>
+#include <vector>
+#include <utility>
+#include "core/PoiStore.h"
+#include "core/IdMap.h"
+#include "core/ModuleContext.h"
+#include "geo/PoiSpatialIndex.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// PoiStore
+// - g_poi_coords / g_poi_ids are the source of truth (parallel columns)
+// - s_indexById mirrors them for O(1) id lookups
+// - Removal keeps tour order (erase + reindex of the tail); the SimConnect side
+//   only ever sees the ids reported as changed.
+// - The spatial index is updated for changed ids only.
+// -----------------------------------------------------------------------------
+
+static IdMap s_indexById;
+static IdMap s_nextIndexById; // scratch for Replace, keeps its slots
+static PoiColumns s_reorderCoords;                               // scratch for Reorder
+static std::vector<uint32_t> s_reorderIds;
+static uint32_t s_revision = 0;
+
+static bool SamePosition(const PoiColumns& c, size_t i, double lat, double lon)
+{
+    return c.lat[i] == lat && c.lon[i] == lon;
+}
+
+void PoiStore_Replace(PoiColumns& coords, std::vector<uint32_t>& ids, std::vector<uint32_t>& changed)
+{
+    // Messages without ids fall back to positional ids
+    if (ids.size() != coords.size())
+    {
+        ids.resize(coords.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+            ids[i] = (uint32_t)i;
+    }
+
+    size_t firstChanged = changed.size();
+
+    IdMap_Clear(s_nextIndexById);
+    IdMap_Reserve(s_nextIndexById, ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        IdMap_Insert(s_nextIndexById, ids[i], (uint32_t)i);
+
+    // New or moved POIs
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        uint32_t index;
+        if (!IdMap_Find(s_indexById, ids[i], &index) || !SamePosition(g_poi_coords, index, coords.lat[i], coords.lon[i]))
+            changed.push_back(ids[i]);
+    }
+
+    // POIs that disappeared
+    for (size_t i = 0; i < g_poi_ids.size(); ++i)
+    {
+        uint32_t index;
+        if (!IdMap_Find(s_nextIndexById, g_poi_ids[i], &index))
+            changed.push_back(g_poi_ids[i]);
+    }
+
+    PoiColumns_Swap(g_poi_coords, coords);
+    g_poi_ids.swap(ids);
+    IdMap_Swap(s_indexById, s_nextIndexById);
+    if (changed.size() > firstChanged)
+        ++s_revision;
+
+    for (size_t i = firstChanged; i < changed.size(); ++i)
+    {
+        int index = PoiStore_IndexOf(changed[i]);
+        if (index >= 0)
+            PoiIndex_Upsert(changed[i], g_poi_coords.lat[index], g_poi_coords.lon[index]);
+        else
+            PoiIndex_Remove(changed[i]);
+    }
+}
+
+bool PoiStore_Add(const PoiEntry& entry)
+{
+    uint32_t index;
+    if (IdMap_Find(s_indexById, entry.id, &index))
+        return PoiStore_Update(entry);
+
+    IdMap_Insert(s_indexById, entry.id, (uint32_t)g_poi_coords.size());
+    PoiColumns_Append(g_poi_coords, entry.lat, entry.lon);
+    g_poi_ids.push_back(entry.id);
+    PoiIndex_Upsert(entry.id, entry.lat, entry.lon);
+    ++s_revision;
+    return true;
+}
+
+bool PoiStore_Update(const PoiEntry& entry)
+{
+    uint32_t index;
+    if (!IdMap_Find(s_indexById, entry.id, &index))
+    {
+        LOG_WARN("PoiStore: update for unknown POI id=%u ignored.", (unsigned)entry.id);
+        return false;
+    }
+
+    if (SamePosition(g_poi_coords, index, entry.lat, entry.lon))
+        return false;
+
+    PoiColumns_Set(g_poi_coords, index, entry.lat, entry.lon);
+    PoiIndex_Upsert(entry.id, entry.lat, entry.lon);
+    ++s_revision;
+    return true;
+}
+
+bool PoiStore_Remove(uint32_t id)
+{
+    uint32_t index;
+    if (!IdMap_Find(s_indexById, id, &index))
+        return false;
+
+    IdMap_Erase(s_indexById, id);
+    PoiIndex_Remove(id);
+
+    PoiColumns_Erase(g_poi_coords, index);
+    g_poi_ids.erase(g_poi_ids.begin() + index);
+
+    // Entries after the removed one shift down by one
+    for (size_t i = index; i < g_poi_ids.size(); ++i)
+        IdMap_Set(s_indexById, g_poi_ids[i], (uint32_t)i);
+
+    // Keep the active POI stable; removing the active one makes the next POI active
+    if ((int)index < g_activePoiIndex)
+        --g_activePoiIndex;
+
+    ++s_revision;
+    return true;
+}
+
+void PoiStore_Reorder(size_t from, const std::vector<uint32_t>& order)
+{
+    if (from + order.size() != g_poi_ids.size())
+    {
+        LOG_ERROR("PoiStore: reorder of %zu entries from %zu does not match %zu POIs, ignored.",
+            order.size(), from, g_poi_ids.size());
+        return;
+    }
+
+    // Positions are unchanged, so the spatial index needs no update
+    PoiColumns_AssignTail(s_reorderCoords, g_poi_coords, from);
+    s_reorderIds.assign(g_poi_ids.begin() + from, g_poi_ids.end());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        PoiColumns_CopyEntry(g_poi_coords, from + i, s_reorderCoords, order[i]);
+        g_poi_ids[from + i] = s_reorderIds[order[i]];
+        IdMap_Set(s_indexById, g_poi_ids[from + i], (uint32_t)(from + i));
+    }
+    ++s_revision;
+}
+
+int PoiStore_IndexOf(uint32_t id)
+{
+    uint32_t index;
+    return IdMap_Find(s_indexById, id, &index) ? (int)index : -1;
+}
+
+uint32_t PoiStore_Revision()
+{
+    return s_revision;
+}
@@ -0,0 +1,250 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "core/Scheduler.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// Scheduler (hashed timer wheel)
+// - Timers live in a pool; a handle is (generation << 16) | (index + 1), so a
+//   stale handle never matches a reused slot
+// - Each wheel slot is an intrusive doubly-linked list of the timers whose
+//   deadline maps to it (deadline % kSlots); timers further out than one
+//   revolution wait in their slot until their deadline is reached
+// - A tick walks the slots between the last tick and now (all slots once
+//   when more than a revolution has passed), collects due timers, then fires
+//   them, so callbacks can freely schedule or cancel
+// -----------------------------------------------------------------------------
+
+static const uint32_t kSlots = 1024;      // 1 ms per slot
+static const uint32_t kMaxTimers = 0xFFFF;
+static const int32_t kNil = -1;
+
+enum eTimerState { TIMER_FREE = 0, TIMER_PENDING, TIMER_DUE };
+
+struct Timer
+{
+    uint64_t deadline; // ms
+    TimerCallback cb;
+    void* ctx;
+    int32_t prev;
+    int32_t next;      // also links the free list
+    uint16_t generation;
+    uint8_t state;
+};
+
+static std::vector<Timer> s_timers;
+static int32_t s_slots[kSlots];
+static bool s_slotsInitialized = false;
+static int32_t s_freeList = kNil;
+static uint64_t s_lastTick = 0;
+static std::vector<TimerHandle> s_due; // scratch for Tick
+
+static std::chrono::steady_clock::time_point s_epoch = std::chrono::steady_clock::now();
+static SchedulerClock s_clock = nullptr; // replacement clock, nullptr = steady_clock
+
+uint64_t Scheduler_NowMs()
+{
+    if (s_clock)
+        return s_clock();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - s_epoch).count();
+}
+
+static void InitSlots()
+{
+    for (uint32_t i = 0; i < kSlots; ++i)
+        s_slots[i] = kNil;
+    s_slotsInitialized = true;
+    s_lastTick = Scheduler_NowMs();
+}
+
+static TimerHandle MakeHandle(int32_t index)
+{
+    return ((TimerHandle)s_timers[index].generation << 16) | (TimerHandle)(index + 1);
+}
+
+// Index of the timer a handle refers to, or kNil when stale / invalid
+static int32_t Resolve(TimerHandle handle)
+{
+    int32_t index = (int32_t)(handle & 0xFFFF) - 1;
+    if (index < 0 || index >= (int32_t)s_timers.size())
+        return kNil;
+    const Timer& t = s_timers[index];
+    if (t.state == TIMER_FREE || t.generation != (uint16_t)(handle >> 16))
+        return kNil;
+    return index;
+}
+
+static void Link(int32_t index)
+{
+    Timer& t = s_timers[index];
+    int32_t& head = s_slots[t.deadline % kSlots];
+    t.prev = kNil;
+    t.next = head;
+    if (head != kNil)
+        s_timers[head].prev = index;
+    head = index;
+}
+
+static void Unlink(int32_t index)
+{
+    Timer& t = s_timers[index];
+    if (t.prev != kNil)
+        s_timers[t.prev].next = t.next;
+    else
+        s_slots[t.deadline % kSlots] = t.next;
+    if (t.next != kNil)
+        s_timers[t.next].prev = t.prev;
+    t.prev = t.next = kNil;
+}
+
+static void Release(int32_t index)
+{
+    Timer& t = s_timers[index];
+    t.state = TIMER_FREE;
+    t.cb = nullptr;
+    t.ctx = nullptr;
+    t.generation++;
+    t.next = s_freeList;
+    s_freeList = index;
+}
+
+TimerHandle Scheduler_Schedule(uint32_t delayMs, TimerCallback cb, void* ctx)
+{
+    if (!cb)
+        return 0;
+    if (!s_slotsInitialized)
+        InitSlots();
+
+    int32_t index = s_freeList;
+    if (index != kNil)
+    {
+        s_freeList = s_timers[index].next;
+    }
+    else
+    {
+        if (s_timers.size() >= kMaxTimers)
+        {
+            LOG_ERROR("Scheduler: timer table full, dropping timer.");
+            return 0;
+        }
+        Timer fresh = {};
+        fresh.generation = 1;
+        s_timers.push_back(fresh);
+        index = (int32_t)s_timers.size() - 1;
+    }
+
+    Timer& t = s_timers[index];
+    t.deadline = Scheduler_NowMs() + delayMs;
+    t.cb = cb;
+    t.ctx = ctx;
+    t.state = TIMER_PENDING;
+    Link(index);
+    return MakeHandle(index);
+}
+
+bool Scheduler_Cancel(TimerHandle handle)
+{
+    int32_t index = Resolve(handle);
+    if (index == kNil)
+        return false;
+
+    if (s_timers[index].state == TIMER_PENDING)
+        Unlink(index);
+    Release(index); // a due timer that has not fired yet is skipped by Tick
+    return true;
+}
+
+bool Scheduler_Reschedule(TimerHandle handle, uint32_t delayMs)
+{
+    int32_t index = Resolve(handle);
+    if (index == kNil || s_timers[index].state != TIMER_PENDING)
+        return false;
+
+    Unlink(index);
+    s_timers[index].deadline = Scheduler_NowMs() + delayMs;
+    Link(index);
+    return true;
+}
+
+bool Scheduler_IsPending(TimerHandle handle)
+{
+    int32_t index = Resolve(handle);
+    return index != kNil && s_timers[index].state == TIMER_PENDING;
+}
+
+static void CollectDue(uint32_t slot, uint64_t now)
+{
+    int32_t index = s_slots[slot];
+    while (index != kNil)
+    {
+        int32_t next = s_timers[index].next;
+        if (s_timers[index].deadline <= now)
+        {
+            Unlink(index);
+            s_timers[index].state = TIMER_DUE;
+            s_due.push_back(MakeHandle(index));
+        }
+        index = next;
+    }
+}
+
+void Scheduler_Tick()
+{
+    if (!s_slotsInitialized)
+        InitSlots();
+
+    uint64_t now = Scheduler_NowMs();
+    if (now < s_lastTick)
+        return;
+
+    s_due.clear();
+    if (now - s_lastTick >= kSlots)
+    {
+        for (uint32_t slot = 0; slot < kSlots; ++slot)
+            CollectDue(slot, now);
+    }
+    else
+    {
+        for (uint64_t tick = s_lastTick; tick <= now; ++tick)
+            CollectDue((uint32_t)(tick % kSlots), now);
+    }
+    s_lastTick = now;
+
+    for (size_t i = 0; i < s_due.size(); ++i)
+    {
+        int32_t index = Resolve(s_due[i]);
+        if (index == kNil || s_timers[index].state != TIMER_DUE)
+            continue; // cancelled by an earlier callback
+
+        TimerCallback cb = s_timers[index].cb;
+        void* ctx = s_timers[index].ctx;
+        Release(index);
+        cb(ctx);
+    }
+}
+
+void Scheduler_SetClock(SchedulerClock clock)
+{
+    Scheduler_Clear();
+    s_clock = clock;
+    s_slotsInitialized = false; // the wheel restarts at the new clock's "now"
+}
+
+SchedulerClock Scheduler_GetClock()
+{
+    return s_clock;
+}
+
+void Scheduler_Clear()
+{
+    for (int32_t i = 0; i < (int32_t)s_timers.size(); ++i)
+    {
+        if (s_timers[i].state == TIMER_PENDING)
+            Unlink(i);
+        if (s_timers[i].state != TIMER_FREE)
+            Release(i);
+    }
+    s_due.clear();
+}
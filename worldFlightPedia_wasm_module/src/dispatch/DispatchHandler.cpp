@@ -3,139 +3,214 @@
 #include <MSFS/MSFS_WindowsTypes.h>
 #include <SimConnect.h>
 #include "dispatch/DispatchHandler.h"
+#include "dispatch/DispatchRegistry.h"
+#include "dispatch/DispatchTrace.h"
+#include "comm/OutboundQueue.h"
 #include "core/Constants.h"
 #include "simobjects/SimObjectManager.h"
+#include "simobjects/EmitterFollow.h"
 #include <vector>
 #include "core/ModuleContext.h"
 #include "flight/FlightController.h"
+#include "flight/GeofenceEngine.h"
+#include "flight/TourSnapshot.h"
+#include "simconnect/LVarRegistry.h"
+#include "simconnect/Telemetry.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
 #include <cmath>
 
 // -----------------------------------------------------------------------------
-// Dispatch callback handler
-// - Central SimConnect message handler invoked via SimConnect_CallDispatch
-// - Routes system events, assigned object notifications and data updates
+// Dispatch handlers
+// - One small function per route, registered in DispatchHandler_Initialize
 // - Keeps logic minimal: delegates work to FlightController and SimObjectManager
+// - The busier routes are timed (see core/Metrics.h)
+// -----------------------------------------------------------------------------
+
+// Frame tick: fire due timers, follow the marker lookahead, submit queued
+// marker creates, keep the emitter cube next to the aircraft, schedule a tour
+// snapshot after changes, send the messages queued for JS in one call, then
+// write a bounded number of pending log lines
+static void OnFrame(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    MetricsScope frame(METRIC_ROUTE_FRAME);
+    Scheduler_Tick();
+    FlightController_OnFrame();
+    SimObjectManager_OnFrame();
+    EmitterFollow_OnFrame();
+    TourSnapshot_OnFrame();
+    OutboundQueue_Flush();
+    Log_Flush(LOG_FLUSH_LINES_PER_FRAME);
+}
+
+// Exceptions refer to the packet that caused them (dwSendID)
+static void OnException(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_EXCEPTION* ex = (SIMCONNECT_RECV_EXCEPTION*)pData;
+    if (!SimObjectManager_OnException(ex->dwSendID, ex->dwException))
+        LOG_WARN("SimConnect exception %u (sendId=%u, index=%u)",
+            (unsigned)ex->dwException, (unsigned)ex->dwSendID, (unsigned)ex->dwIndex);
+}
+
+// Event containing a filename (flight loaded)
+static void OnFlightLoaded(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_EVENT_FILENAME* evt = (SIMCONNECT_RECV_EVENT_FILENAME*)pData;
+    LOG_INFO("FlightLoaded detected: %s", evt->szFileName);
+}
+
+static void OnOtherFilenameEvent(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_EVENT_FILENAME* evt = (SIMCONNECT_RECV_EVENT_FILENAME*)pData;
+    LOG_INFO("EVENT_FILENAME other id=%u file='%s'", (unsigned)evt->uEventID, evt->szFileName);
+}
+
+static void OnSimStart(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    LOG_INFO("SimStart event received.");
+}
+
+static void OnFlightPlanLoaded(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    LOG_INFO("FlightPlanLoaded event received.");
+}
+
+// Manual spawn trigger (mapped to key 'M')
+static void OnKeyM(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    LOG_INFO("Key 'M' pressed - EVENT_TRIGGER_M");
+    SpawnSimObject(); // Delegate to SimObjectManager
+}
+
+// Manual remove trigger (mapped to key 'N')
+static void OnKeyN(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    LOG_INFO("Key 'N' pressed - EVENT_TRIGGER_N");
+    RemoveSimObject(); // Delegate to SimObjectManager
+}
+
+static void OnOtherEvent(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_EVENT* evt = (SIMCONNECT_RECV_EVENT*)pData;
+    LOG_INFO("EVENT generic id=%u", (unsigned)evt->uEventID);
+}
+
+// POI marker spawn: tie the object id back to its POI
+static void OnMarkerAssigned(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID* pObj = (SIMCONNECT_RECV_ASSIGNED_OBJECT_ID*)pData;
+    MetricsScope assigned(METRIC_ROUTE_ASSIGNED_ID);
+    Metrics_Count(METRIC_IDS_ASSIGNED);
+
+    if (!SimObjectManager_OnMarkerAssigned(pObj->dwRequestID, pObj->dwObjectID))
+    {
+        // Request already given up on (timed out): nothing tracks this object
+        LOG_WARN("Unknown marker request %u (object id %u), removing.", (unsigned)pObj->dwRequestID, (unsigned)pObj->dwObjectID);
+        if (SimConnect_AIRemoveObject(g_hSimConnect, pObj->dwObjectID, REQUEST_REMOVE_LASERS) == S_OK)
+            Metrics_Count(METRIC_REMOVES);
+    }
+}
+
+// Single spawn: store and track id
+static void OnLaserAssigned(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID* pObj = (SIMCONNECT_RECV_ASSIGNED_OBJECT_ID*)pData;
+    MetricsScope assigned(METRIC_ROUTE_ASSIGNED_ID);
+    Metrics_Count(METRIC_IDS_ASSIGNED);
+
+    g_lasersID = pObj->dwObjectID;
+    g_lasersIDs.push_back(g_lasersID);
+    LOG_INFO("Single spawn object id: %u", (unsigned)g_lasersID);
+}
+
+// Cube spawn: the new cube follows the aircraft (see simobjects/EmitterFollow.h)
+static void OnCubeAssigned(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_ASSIGNED_OBJECT_ID* pObj = (SIMCONNECT_RECV_ASSIGNED_OBJECT_ID*)pData;
+    MetricsScope assigned(METRIC_ROUTE_ASSIGNED_ID);
+    Metrics_Count(METRIC_IDS_ASSIGNED);
+
+    LOG_INFO("Cube assigned object id: %u", (unsigned)pObj->dwObjectID);
+    EmitterFollow_OnCubeAssigned(pObj->dwObjectID);
+}
+
+// Watched L:Vars changed: the registry detects edges and calls the handlers
+static void OnLVarWatch(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = (SIMCONNECT_RECV_SIMOBJECT_DATA*)pData;
+    MetricsScope lvar(METRIC_ROUTE_LVAR);
+
+    size_t header = (size_t)((const char*)&pObjData->dwData - (const char*)pData);
+    LVarRegistry_OnData(&pObjData->dwData, cbData > header ? cbData - header : 0);
+}
+
+// User aircraft state changed: refresh the telemetry cache, then arrival
+// geofences and the resident marker set
+static void OnUserState(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = (SIMCONNECT_RECV_SIMOBJECT_DATA*)pData;
+    MetricsScope position(METRIC_ROUTE_USER_POSITION);
+
+    size_t header = (size_t)((const char*)&pObjData->dwData - (const char*)pData);
+    if (!Telemetry_OnData(&pObjData->dwData, cbData > header ? cbData - header : 0))
+        return;
+
+    AircraftState aircraft;
+    Telemetry_Get(&aircraft);
+    Geofence_OnUserPosition(aircraft.latDeg, aircraft.lonDeg);
+    SimObjectManager_OnUserPosition();
+}
+
+// -----------------------------------------------------------------------------
+// Routes
+// Adding a feature: write its handler above and register it here. Message
+// kinds, events and request ids without a handler are ignored.
+// -----------------------------------------------------------------------------
+void DispatchHandler_Initialize()
+{
+    DispatchRegistry_Clear();
+
+    DispatchRegistry_OnMessage(SIMCONNECT_RECV_ID_EXCEPTION, OnException);
+    DispatchRegistry_OnMessage(SIMCONNECT_RECV_ID_EVENT, OnOtherEvent);
+    DispatchRegistry_OnMessage(SIMCONNECT_RECV_ID_EVENT_FILENAME, OnOtherFilenameEvent);
+
+    DispatchRegistry_OnEvent(EVENT_FRAME, OnFrame);
+    DispatchRegistry_OnEvent(EVENT_FLIGHT_LOADED, OnFlightLoaded);
+    DispatchRegistry_OnEvent(EVENT_SIM_START, OnSimStart);
+    DispatchRegistry_OnEvent(EVENT_FLIGHTPLAN_LOADED, OnFlightPlanLoaded);
+    DispatchRegistry_OnEvent(EVENT_TRIGGER_M, OnKeyM);
+    DispatchRegistry_OnEvent(EVENT_TRIGGER_N, OnKeyN);
+
+    DispatchRegistry_OnRequest(REQUEST_ADD_LASERS, OnLaserAssigned);
+    DispatchRegistry_OnRequest(REQUEST_ADD_CUBE, OnCubeAssigned);
+    DispatchRegistry_OnRequest(REQUEST_LVAR_WATCH, OnLVarWatch);
+    DispatchRegistry_OnRequest(REQUEST_USER_STATE, OnUserState);
+
+    // One request id per marker create: g_spawnReqBase + n
+    DispatchRegistry_OnRequestRange(g_spawnReqBase, 0xFFFFFFFFu, OnMarkerAssigned);
+}
+
+// -----------------------------------------------------------------------------
+// Dispatch callback
+// - Central SimConnect message handler invoked via SimConnect_CallDispatch
+// - Looks the handler up in the registry; each call is timed
+// - Records the message when a trace is captured; while a trace is replayed,
+//   live messages are dropped and live frames only pace the replay
 // -----------------------------------------------------------------------------
 void CALLBACK MyDispatchProc(SIMCONNECT_RECV* pData, DWORD cbData, void* pContext)
 {
-    // Check FlightController timers on every dispatch callback
-    // This ensures sound resets are checked frequently (every SimConnect message)
-    FlightController_Update();
-    
     if (!pData)
         return; // Defensive: ignore null pointers
 
-    switch (pData->dwID)
-    {
-    case SIMCONNECT_RECV_ID_EVENT_FILENAME:
-    {
-        // Event containing a filename (e.g. flight loaded)
-        SIMCONNECT_RECV_EVENT_FILENAME* evt = (SIMCONNECT_RECV_EVENT_FILENAME*)pData;
-        if (evt->uEventID == EVENT_FLIGHT_LOADED)
-            fprintf(stderr, "[MSFS] FlightLoaded detected: %s\n", evt->szFileName);
-        else
-            fprintf(stderr, "[MSFS] EVENT_FILENAME other id=%u file='%s'\n", (unsigned)evt->uEventID, evt->szFileName);
-        break;
-    }
-    case SIMCONNECT_RECV_ID_EVENT:
-    {
-        // Generic subscribed events (keyboard, sim start, flightplan loaded...)
-        SIMCONNECT_RECV_EVENT* evt = (SIMCONNECT_RECV_EVENT*)pData;
-
-        if (evt->uEventID == EVENT_SIM_START)
-            fprintf(stderr, "[MSFS] SimStart event received.\n");
-        else if (evt->uEventID == EVENT_FLIGHTPLAN_LOADED)
-            fprintf(stderr, "[MSFS] FlightPlanLoaded event received.\n");
-        else if (evt->uEventID == EVENT_TRIGGER_M)
-        {
-            // Manual spawn trigger (mapped to key 'M')
-            fprintf(stderr, "[MSFS] Key 'M' pressed - EVENT_TRIGGER_M\n");
-            SpawnSimObject(); // Delegate to SimObjectManager
-        }
-        else if (evt->uEventID == EVENT_TRIGGER_N)
-        {
-            // Manual remove trigger (mapped to key 'N')
-            fprintf(stderr, "[MSFS] Key 'N' pressed - EVENT_TRIGGER_N\n");
-            RemoveSimObject(); // Delegate to SimObjectManager
-        }
-        else
-            fprintf(stderr, "[MSFS] EVENT generic id=%u\n", (unsigned)evt->uEventID);
-        break;
-    }
-    case SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID:
+    if (DispatchTrace_IsReplaying())
     {
-        // Received assigned object id after an AICreateSimulatedObject call
-        SIMCONNECT_RECV_ASSIGNED_OBJECT_ID* pObj = (SIMCONNECT_RECV_ASSIGNED_OBJECT_ID*)pData;
-
-        // Differentiate between multiple spawn requests and single cube spawn
-        if (pObj->dwRequestID >= g_spawnReqBase) {
-            // Multi-spawn mode: collect ids
-            g_lasersIDs.push_back(pObj->dwObjectID);
-            fprintf(stderr, "[MSFS] Multi-spawn assigned object id: %u (req=%u) (total=%zu)\n", (unsigned)pObj->dwObjectID, (unsigned)pObj->dwRequestID, g_lasersIDs.size());
-        }
-        else if (pObj->dwRequestID == REQUEST_ADD_LASERS) {
-            // Single spawn: store and track id
-            g_lasersID = pObj->dwObjectID;
-            g_lasersIDs.push_back(g_lasersID);
-            fprintf(stderr, "[MSFS] Single spawn object id: %u\n", (unsigned)g_lasersID);
-        }
-        else if (pObj->dwRequestID == REQUEST_ADD_CUBE) {
-            // Cube spawn: informational only (no further action required here)
-            fprintf(stderr, "[MSFS] Cube assigned object id: %u\n", (unsigned)pObj->dwObjectID);
-        }
-        break;
+        if (pData->dwID == SIMCONNECT_RECV_ID_EVENT_FRAME)
+            DispatchTrace_PumpReplay();
+        return;
     }
-    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
-    {
-        // Data response for requested SimVar / L:Var definitions
-        SIMCONNECT_RECV_SIMOBJECT_DATA* pObjData = (SIMCONNECT_RECV_SIMOBJECT_DATA*)pData;
-
-        if (pObjData->dwRequestID == REQUEST_LVAR_SPAWN)
-        {
-            // Handle L:spawnAllLasersRed (toggle spawn/remove)
-            double newValue = *(double*)&pObjData->dwData;
-            if (newValue != g_lastSpawnState)
-            {
-                fprintf(stderr, "[MSFS] L:spawnAllLasersRed changed -> %.0f\n", newValue);
-                if (newValue == 1.0) { fprintf(stderr, "[MSFS] -> Spawning all lasers\n"); SpawnSimObject(); }
-                else if (newValue == 0.0) { fprintf(stderr, "[MSFS] -> Removing all lasers\n"); RemoveSimObject(); }
-                g_lastSpawnState = newValue; // remember last state for edge detection
-            }
-        }
-        else if (pObjData->dwRequestID == REQUEST_LVAR_STARTFLIGHT)
-        {
-            // Delegate start/stop flight handling
-            double newValue = *(double*)&pObjData->dwData;
-            FlightController_OnStartFlight(newValue);
-        }
-        else if (pObjData->dwRequestID == REQUEST_LVAR_NEXTPOI)
-        {
-            // Delegate next POI handling
-            double newValue = *(double*)&pObjData->dwData;
-            FlightController_OnNextPoi(newValue);
-        }
-        else if (pObjData->dwRequestID == REQUEST_LVAR_SPAWN_CUBE)
-        {
-            // LVar-driven cube spawn: when L:WFP_SPAWN_CUBE becomes 1, request user pos and spawn cube
-            double newValue = *(double*)&pObjData->dwData;
-            if (newValue == 1.0)
-            {
-                fprintf(stderr, "[MSFS] L:WFP_SPAWN_CUBE triggered -> requesting user pos.\n");
-                SpawnCubeNearAircraft(); // will request user pos via SimConnect and later spawn
-            }
-        }
-        else if (pObjData->dwRequestID == REQUEST_USER_POS_FOR_CUBE)
-        {
-            // Response with user's aircraft position used to compute cube spawn location
-            struct UserPos { double lat; double lon; double alt; double hdg; };
-            UserPos* d = (UserPos*)&pObjData->dwData;
-            // Delegate geometric computation and spawn to SimObjectManager
-            SpawnCubeAtOffsetFromUser(d->lat, d->lon, d->alt, d->hdg, 1.0);
-        }
-        break;
-    }
-    default:
-        // Unhandled message types are ignored
-        break;
-    }
-}
\ No newline at end of file
+    DispatchTrace_Record(TRACE_KIND_SIMCONNECT, pData, cbData);
+
+    MetricsScope scope(METRIC_ROUTE_DISPATCH);
+    DispatchRegistry_Dispatch(pData, cbData);
+}
@@ -0,0 +1,154 @@
+#include <cstring>
+#include "dispatch/DispatchRegistry.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// Dispatch registry
+// - One flat table per key (message kind, event id, request id); a lookup is
+//   an index, never a comparison chain
+// - Request ranges are kept in a short fixed array; only ids past the flat
+//   table look at it
+// -----------------------------------------------------------------------------
+
+enum eDispatchKey
+{
+    DISPATCH_KEY_NONE = 0, // routed by message kind only
+    DISPATCH_KEY_EVENT,
+    DISPATCH_KEY_REQUEST
+};
+
+struct RequestRange
+{
+    DWORD first;
+    DWORD last;
+    DispatchFn fn;
+};
+
+static DispatchFn s_byMessage[DISPATCH_MAX_RECV_ID];
+static DispatchFn s_byEvent[DISPATCH_MAX_EVENT_ID];
+static DispatchFn s_byRequest[DISPATCH_MAX_REQUEST_ID];
+static RequestRange s_ranges[DISPATCH_MAX_REQUEST_RANGES];
+static size_t s_rangeCount = 0;
+
+// Which id a message kind is routed by
+static eDispatchKey KeyOf(DWORD recvId)
+{
+    switch (recvId)
+    {
+    case SIMCONNECT_RECV_ID_EVENT:
+    case SIMCONNECT_RECV_ID_EVENT_FILENAME:
+    case SIMCONNECT_RECV_ID_EVENT_FRAME:
+        return DISPATCH_KEY_EVENT;
+    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA:
+    case SIMCONNECT_RECV_ID_SIMOBJECT_DATA_BYTYPE:
+    case SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID:
+        return DISPATCH_KEY_REQUEST;
+    default:
+        return DISPATCH_KEY_NONE;
+    }
+}
+
+bool DispatchRegistry_OnMessage(DWORD recvId, DispatchFn fn)
+{
+    if (recvId >= DISPATCH_MAX_RECV_ID || s_byMessage[recvId])
+    {
+        LOG_ERROR("Dispatch: cannot register message kind %u", (unsigned)recvId);
+        return false;
+    }
+    s_byMessage[recvId] = fn;
+    return true;
+}
+
+bool DispatchRegistry_OnEvent(DWORD eventId, DispatchFn fn)
+{
+    if (eventId >= DISPATCH_MAX_EVENT_ID || s_byEvent[eventId])
+    {
+        LOG_ERROR("Dispatch: cannot register event %u", (unsigned)eventId);
+        return false;
+    }
+    s_byEvent[eventId] = fn;
+    return true;
+}
+
+bool DispatchRegistry_OnRequest(DWORD requestId, DispatchFn fn)
+{
+    if (requestId >= DISPATCH_MAX_REQUEST_ID || s_byRequest[requestId])
+    {
+        LOG_ERROR("Dispatch: cannot register request %u", (unsigned)requestId);
+        return false;
+    }
+    s_byRequest[requestId] = fn;
+    return true;
+}
+
+bool DispatchRegistry_OnRequestRange(DWORD firstId, DWORD lastId, DispatchFn fn)
+{
+    bool valid = firstId >= DISPATCH_MAX_REQUEST_ID && lastId >= firstId
+        && s_rangeCount < DISPATCH_MAX_REQUEST_RANGES;
+    for (size_t i = 0; valid && i < s_rangeCount; ++i)
+        valid = lastId < s_ranges[i].first || firstId > s_ranges[i].last;
+    if (!valid)
+    {
+        LOG_ERROR("Dispatch: cannot register requests %u..%u", (unsigned)firstId, (unsigned)lastId);
+        return false;
+    }
+
+    RequestRange& range = s_ranges[s_rangeCount++];
+    range.first = firstId;
+    range.last = lastId;
+    range.fn = fn;
+    return true;
+}
+
+void DispatchRegistry_Clear()
+{
+    std::memset(s_byMessage, 0, sizeof(s_byMessage));
+    std::memset(s_byEvent, 0, sizeof(s_byEvent));
+    std::memset(s_byRequest, 0, sizeof(s_byRequest));
+    s_rangeCount = 0;
+}
+
+static DispatchFn FindRequest(DWORD requestId)
+{
+    if (requestId < DISPATCH_MAX_REQUEST_ID)
+        return s_byRequest[requestId];
+    for (size_t i = 0; i < s_rangeCount; ++i)
+        if (requestId >= s_ranges[i].first && requestId <= s_ranges[i].last)
+            return s_ranges[i].fn;
+    return nullptr;
+}
+
+void DispatchRegistry_Dispatch(SIMCONNECT_RECV* pData, DWORD cbData)
+{
+    DWORD recvId = pData->dwID;
+    if (recvId >= DISPATCH_MAX_RECV_ID)
+        return;
+
+    DispatchFn fn = nullptr;
+    switch (KeyOf(recvId))
+    {
+    case DISPATCH_KEY_EVENT:
+    {
+        // EVENT_FILENAME and EVENT_FRAME extend SIMCONNECT_RECV_EVENT
+        DWORD eventId = ((SIMCONNECT_RECV_EVENT*)pData)->uEventID;
+        if (eventId < DISPATCH_MAX_EVENT_ID)
+            fn = s_byEvent[eventId];
+        break;
+    }
+    case DISPATCH_KEY_REQUEST:
+    {
+        DWORD requestId = recvId == SIMCONNECT_RECV_ID_ASSIGNED_OBJECT_ID
+            ? ((SIMCONNECT_RECV_ASSIGNED_OBJECT_ID*)pData)->dwRequestID
+            : ((SIMCONNECT_RECV_SIMOBJECT_DATA*)pData)->dwRequestID;
+        fn = FindRequest(requestId);
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (!fn)
+        fn = s_byMessage[recvId];
+    if (fn)
+        fn(pData, cbData);
+}
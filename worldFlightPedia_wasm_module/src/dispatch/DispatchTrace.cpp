@@ -0,0 +1,409 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <MSFS/MSFS.h>
+#include <MSFS/MSFS_WindowsTypes.h>
+#include <SimConnect.h>
+#include "dispatch/DispatchTrace.h"
+#include "dispatch/DispatchRegistry.h"
+#include "comm/CommunicationBus.h"
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
+
+// -----------------------------------------------------------------------------
+// Dispatch trace
+// - Capture appends each record to a stdio stream with a TRACE_WRITE_BUFFER_BYTES
+//   buffer, so the dispatch path only copies bytes; the file is written in
+//   large blocks
+// - Replay reads one record ahead; the payload buffer keeps its capacity
+// - Replay is only compiled into host builds (WFP_HOST_BUILD): replayed
+//   creates and object ids would act on the objects of the live flight. The
+//   MSFS build keeps capture and refuses to replay.
+// -----------------------------------------------------------------------------
+
+static const char kTraceMagic[8] = { 'W', 'F', 'P', 'T', 'R', 'A', 'C', 'E' };
+static const uint32_t kTraceVersion = 1;
+static const size_t kFileHeaderBytes = 16;
+static const size_t kRecordHeaderBytes = 9;
+
+struct RecordHeader
+{
+    uint32_t deltaUs;
+    uint32_t size;
+    uint8_t kind;
+};
+
+static TraceStats s_stats = { false, false, 0, 0, 0 };
+static uint64_t s_traceUs = 0; // recorded time of the last record captured / replayed
+
+// Capture
+static FILE* s_captureFile = nullptr;
+static uint64_t s_lastRecordUs = 0; // Metrics_NowNs clock, in microseconds
+
+
+// -----------------------------------------------------------------------------
+// Capture
+// -----------------------------------------------------------------------------
+
+bool DispatchTrace_StartCapture(const char* path)
+{
+    DispatchTrace_StopReplay();
+    DispatchTrace_StopCapture();
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file)
+    {
+        LOG_ERROR("Trace: cannot create %s", path);
+        return false;
+    }
+    std::setvbuf(file, nullptr, _IOFBF, TRACE_WRITE_BUFFER_BYTES);
+
+    unsigned char header[kFileHeaderBytes] = {};
+    std::memcpy(header, kTraceMagic, sizeof(kTraceMagic));
+    std::memcpy(header + 8, &kTraceVersion, sizeof(kTraceVersion));
+    if (std::fwrite(header, 1, sizeof(header), file) != sizeof(header))
+    {
+        LOG_ERROR("Trace: cannot write %s", path);
+        std::fclose(file);
+        return false;
+    }
+
+    s_captureFile = file;
+    s_lastRecordUs = Metrics_NowNs() / 1000;
+    s_traceUs = 0;
+    s_stats.capturing = true;
+    s_stats.records = 0;
+    s_stats.bytes = 0;
+    s_stats.traceMs = 0;
+    LOG_INFO("Trace: capturing to %s", path);
+    return true;
+}
+
+void DispatchTrace_StopCapture()
+{
+    if (!s_captureFile)
+        return;
+
+    std::fclose(s_captureFile); // writes out the buffered records
+    s_captureFile = nullptr;
+    s_stats.capturing = false;
+    LOG_INFO("Trace: capture stopped (%llu records, %llu bytes, %llu ms)",
+        (unsigned long long)s_stats.records, (unsigned long long)s_stats.bytes, (unsigned long long)s_stats.traceMs);
+}
+
+void DispatchTrace_Record(eTraceKind kind, const void* data, size_t size)
+{
+    if (!s_captureFile)
+        return;
+
+    uint64_t nowUs = Metrics_NowNs() / 1000;
+    uint64_t deltaUs = nowUs - s_lastRecordUs;
+    s_lastRecordUs = nowUs;
+
+    RecordHeader rec;
+    rec.deltaUs = deltaUs > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)deltaUs;
+    rec.size = (uint32_t)size;
+    rec.kind = (uint8_t)kind;
+
+    unsigned char header[kRecordHeaderBytes];
+    std::memcpy(header, &rec.deltaUs, 4);
+    std::memcpy(header + 4, &rec.size, 4);
+    header[8] = rec.kind;
+
+    if (std::fwrite(header, 1, sizeof(header), s_captureFile) != sizeof(header)
+        || (size && std::fwrite(data, 1, size, s_captureFile) != size))
+    {
+        LOG_ERROR("Trace: write failed, capture stopped");
+        DispatchTrace_StopCapture();
+        return;
+    }
+
+    s_traceUs += rec.deltaUs;
+    s_stats.records++;
+    s_stats.bytes += size;
+    s_stats.traceMs = s_traceUs / 1000;
+}
+
+// -----------------------------------------------------------------------------
+// Replay
+// -----------------------------------------------------------------------------
+
+#ifdef WFP_HOST_BUILD
+
+static FILE* s_replayFile = nullptr;
+static bool s_maxSpeed = false;
+static bool s_delivering = false;
+static bool s_replayStarted = false; // first live frame seen
+static uint64_t s_replayStartNs = 0;
+static uint64_t s_clockBaseMs = 0;
+static SchedulerClock s_liveClock = nullptr; // restored when the replay ends
+static bool s_hasNext = false;
+static RecordHeader s_next;
+static std::vector<char> s_payload;
+static uint64_t s_simConnectRecords = 0;
+static uint64_t s_commBusRecords = 0;
+static bool s_replayFailed = false;
+
+// Timers run on the recorded time while replaying
+static uint64_t ReplayClock()
+{
+    return s_clockBaseMs + s_traceUs / 1000;
+}
+
+// Switching clocks drops the pending timers; the periodic metrics push is
+// re-armed on the new clock
+static void SetSchedulerClock(SchedulerClock clock)
+{
+    Scheduler_SetClock(clock);
+    if (Metrics_GetPushInterval())
+        Metrics_SetPushInterval(Metrics_GetPushInterval());
+}
+
+// Reads the next record header; false at the end of the trace or when it is corrupt
+static bool ReadNextHeader()
+{
+    unsigned char header[kRecordHeaderBytes];
+    size_t got = std::fread(header, 1, sizeof(header), s_replayFile);
+    if (got == 0 && std::feof(s_replayFile))
+        return false;
+
+    if (got == sizeof(header))
+    {
+        std::memcpy(&s_next.deltaUs, header, 4);
+        std::memcpy(&s_next.size, header + 4, 4);
+        s_next.kind = header[8];
+        if ((s_next.kind == TRACE_KIND_SIMCONNECT || s_next.kind == TRACE_KIND_COMMBUS)
+            && s_next.size <= TRACE_MAX_RECORD_BYTES)
+            return true;
+    }
+
+    LOG_ERROR("Trace: corrupt record after %llu records", (unsigned long long)s_stats.records);
+    s_replayFailed = true;
+    return false;
+}
+
+static void Deliver(const RecordHeader& rec)
+{
+    s_delivering = true;
+    if (rec.kind == TRACE_KIND_SIMCONNECT)
+    {
+        s_simConnectRecords++;
+        if (rec.size >= sizeof(SIMCONNECT_RECV))
+        {
+            MetricsScope scope(METRIC_ROUTE_DISPATCH);
+            DispatchRegistry_Dispatch((SIMCONNECT_RECV*)s_payload.data(), (DWORD)rec.size);
+        }
+    }
+    else
+    {
+        s_commBusRecords++;
+        OnMessageFromJS(rec.size ? s_payload.data() : "", rec.size, nullptr);
+    }
+    s_delivering = false;
+}
+
+bool DispatchTrace_StartReplay(const char* path, bool maxSpeed)
+{
+    DispatchTrace_StopCapture();
+    DispatchTrace_StopReplay();
+
+    FILE* file = std::fopen(path, "rb");
+    if (!file)
+    {
+        LOG_ERROR("Trace: cannot open %s", path);
+        return false;
+    }
+
+    unsigned char header[kFileHeaderBytes] = {};
+    uint32_t version = 0;
+    if (std::fread(header, 1, sizeof(header), file) == sizeof(header))
+        std::memcpy(&version, header + 8, sizeof(version));
+    if (std::memcmp(header, kTraceMagic, sizeof(kTraceMagic)) != 0 || version != kTraceVersion)
+    {
+        LOG_ERROR("Trace: %s is not a version %u trace", path, (unsigned)kTraceVersion);
+        std::fclose(file);
+        return false;
+    }
+
+    s_replayFile = file;
+    s_maxSpeed = maxSpeed;
+    s_replayStarted = false;
+    s_replayFailed = false;
+    s_simConnectRecords = 0;
+    s_commBusRecords = 0;
+    s_traceUs = 0;
+    s_stats.replaying = true;
+    s_stats.records = 0;
+    s_stats.bytes = 0;
+    s_stats.traceMs = 0;
+    s_hasNext = ReadNextHeader();
+
+    s_clockBaseMs = Scheduler_NowMs();
+    s_liveClock = Scheduler_GetClock();
+    SetSchedulerClock(ReplayClock);
+    LOG_INFO("Trace: replaying %s at %s speed", path, maxSpeed ? "maximum" : "recorded");
+    return true;
+}
+
+void DispatchTrace_StopReplay()
+{
+    if (!s_replayFile)
+        return;
+
+    bool complete = !s_replayFailed && !s_hasNext;
+
+    std::fclose(s_replayFile);
+    s_replayFile = nullptr;
+    s_hasNext = false;
+    s_stats.replaying = false;
+    SetSchedulerClock(s_liveClock);
+
+    uint64_t wallMs = s_replayStarted ? (Metrics_NowNs() - s_replayStartNs) / 1000000 : 0;
+    LOG_INFO("Trace: replay stopped (%llu records, %llu ms recorded, %llu ms wall)",
+        (unsigned long long)s_stats.records, (unsigned long long)s_stats.traceMs, (unsigned long long)wallMs);
+
+    OutboundQueue_Sendf(
+        "{\"type\":\"TRACE\",\"event\":\"REPLAY_DONE\",\"complete\":%s,\"records\":%llu,\"simConnect\":%llu,"
+        "\"commBus\":%llu,\"traceMs\":%llu,\"wallMs\":%llu}",
+        complete ? "true" : "false", (unsigned long long)s_stats.records,
+        (unsigned long long)s_simConnectRecords, (unsigned long long)s_commBusRecords,
+        (unsigned long long)s_stats.traceMs, (unsigned long long)wallMs);
+}
+
+void DispatchTrace_PumpReplay()
+{
+    if (!s_replayFile || s_delivering)
+        return;
+
+    uint64_t nowNs = Metrics_NowNs();
+    if (!s_replayStarted)
+    {
+        s_replayStarted = true;
+        s_replayStartNs = nowNs;
+    }
+    uint64_t dueUs = (nowNs - s_replayStartNs) / 1000;
+
+    while (s_hasNext)
+    {
+        uint64_t atUs = s_traceUs + s_next.deltaUs;
+        if (!s_maxSpeed && atUs > dueUs)
+            return;
+
+        RecordHeader rec = s_next;
+        s_payload.resize(rec.size);
+        if (rec.size && std::fread(s_payload.data(), 1, rec.size, s_replayFile) != rec.size)
+        {
+            LOG_ERROR("Trace: truncated record after %llu records", (unsigned long long)s_stats.records);
+            s_replayFailed = true;
+            s_hasNext = false;
+            break;
+        }
+
+        s_traceUs = atUs;
+        s_stats.records++;
+        s_stats.bytes += rec.size;
+        s_stats.traceMs = s_traceUs / 1000;
+        s_hasNext = ReadNextHeader();
+
+        Deliver(rec);
+        if (!s_replayFile)
+            return;
+    }
+
+    DispatchTrace_StopReplay();
+}
+
+bool DispatchTrace_CanReplay()
+{
+    return true;
+}
+
+bool DispatchTrace_IsReplaying()
+{
+    return s_replayFile != nullptr;
+}
+
+bool DispatchTrace_IsDelivering()
+{
+    return s_delivering;
+}
+
+#else
+
+bool DispatchTrace_StartReplay(const char* path, bool)
+{
+    LOG_ERROR("Trace: %s not replayed, replay is only available in a host build", path);
+    return false;
+}
+
+void DispatchTrace_StopReplay() {}
+void DispatchTrace_PumpReplay() {}
+bool DispatchTrace_CanReplay() { return false; }
+bool DispatchTrace_IsReplaying() { return false; }
+bool DispatchTrace_IsDelivering() { return false; }
+
+#endif
+
+// -----------------------------------------------------------------------------
+// State
+// -----------------------------------------------------------------------------
+
+bool DispatchTrace_IsCapturing()
+{
+    return s_captureFile != nullptr;
+}
+
+void DispatchTrace_GetStats(TraceStats* stats)
+{
+    *stats = s_stats;
+}
+
+void DispatchTrace_Shutdown()
+{
+    DispatchTrace_StopReplay();
+    DispatchTrace_StopCapture();
+}
+
+// -----------------------------------------------------------------------------
+// CommBus messages
+// -----------------------------------------------------------------------------
+
+bool DispatchTrace_OnTraceMessage(PoiParseResult& msg)
+{
+    bool enabled = false;
+    if (!Param_Require(msg, Param_Bool(msg, "enabled", &enabled)))
+        return false;
+
+    if (enabled)
+    {
+        DispatchTrace_StartCapture(TRACE_FILE_PATH);
+    }
+    else
+    {
+        DispatchTrace_StopReplay();
+        DispatchTrace_StopCapture();
+    }
+
+    OutboundQueue_Sendf("ack: TRACE capturing=%d records=%llu bytes=%llu traceMs=%llu",
+        s_stats.capturing ? 1 : 0, (unsigned long long)s_stats.records, (unsigned long long)s_stats.bytes,
+        (unsigned long long)s_stats.traceMs);
+    return true;
+}
+
+bool DispatchTrace_OnReplayMessage(PoiParseResult& msg)
+{
+    bool maxSpeed = false;
+    Param_Bool(msg, "maxSpeed", &maxSpeed);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    if (DispatchTrace_StartReplay(TRACE_FILE_PATH, maxSpeed))
+        OutboundQueue_Sendf("ack: TRACE_REPLAY maxSpeed=%d", maxSpeed ? 1 : 0);
+    else
+        OutboundQueue_Sendf("nack: TRACE_REPLAY %s", DispatchTrace_CanReplay() ? "no trace" : "host build only");
+    return true;
+}
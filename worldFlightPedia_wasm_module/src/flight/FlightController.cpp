@@ -2,25 +2,38 @@
 #include "core/ModuleContext.h"
 #include "simobjects/SimObjectManager.h"
 #include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "flight/GeofenceEngine.h"
+#include "flight/TourOptimizer.h"
+#include "simconnect/LVarRegistry.h"
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "core/Log.h"
 
 #include <MSFS/MSFS.h>
 #include <MSFS/Legacy/gauges.h>
 #include <SimConnect.h>
 #include <cstdio>
 #include <string>
-#include <ctime>
+#include <vector>
 
 // -----------------------------------------------------------------------------
 // Flight controller
-// - Handles L:Vars related to automated flight/POI navigation
-// - Uses globals from ModuleContext (g_poi_coords, g_lastStartFlight, g_flightActive, g_activePoiIndex)
+// - Handles L:Vars related to automated flight/POI navigation (edges are
+//   detected by the L:Var registry, see simconnect/LVarRegistry.h)
+// - Uses globals from ModuleContext (g_poi_coords, g_poi_ids, g_flightActive, g_activePoiIndex)
 // - Spawns/removes SimObjects via SimConnect and SimObjectManager helpers
+// - Lookahead: the POIs after the active one keep a parked marker (see
+//   SimObjectManager_SetLookahead); the window follows every advance at once
+//   and is checked again on each frame for list changes
 // -----------------------------------------------------------------------------
 
-// Static variables to track NextPoi sound reset timing
-// Using absolute timestamp for compatibility
-static time_t g_nextPoiSoundResetTimestamp = 0;
-static bool g_nextPoiSoundActive = false;
+// Pending reset of the NextPoi sound L:Var (0 when none)
+static TimerHandle s_nextPoiSoundReset = 0;
+
+static uint32_t s_lookaheadDepth = MARKER_LOOKAHEAD_DEPTH;
+static uint32_t s_lookaheadBudget = MARKER_LOOKAHEAD_BUDGET;
+static std::vector<uint32_t> s_lookaheadIds;
 
 /**
  * Helper function to execute calculator code (for setting L:Vars)
@@ -34,139 +47,206 @@ static void ExecuteCalculatorCode(const char* code)
     // It's commonly used to set L:Vars from WASM
     execute_calculator_code(code, nullptr, nullptr, nullptr);
     
-    fprintf(stderr, "[MSFS] Executed calculator code: %s\n", code);
+    LOG_DEBUG("Executed calculator code: %s", code);
 }
 
 /**
- * Called periodically to check if NextPoi sound should be reset
- * This gets called from the dispatch handler on every SimConnect message
+ * Hands the next POIs of the tour to the marker manager (none without a flight)
  */
-void FlightController_Update()
+static void UpdateLookahead()
 {
-    if (g_nextPoiSoundActive)
+    s_lookaheadIds.clear();
+    if (g_flightActive && g_activePoiIndex >= 0)
     {
-        // Get current time
-        time_t now = time(nullptr);
-        
-        // Check if 2 seconds have passed
-        if (now >= g_nextPoiSoundResetTimestamp)
-        {
-            // Reset the sound L:Var to 0
-            ExecuteCalculatorCode("0 (>L:WFP_NEXT_POI_SOUND)");
-            g_nextPoiSoundActive = false;
-            fprintf(stderr, "[MSFS] NextPoi sound reset to 0 after 4 seconds.\n");
-        }
+        uint32_t depth = s_lookaheadDepth < s_lookaheadBudget ? s_lookaheadDepth : s_lookaheadBudget;
+        for (size_t i = (size_t)g_activePoiIndex + 1; i < g_poi_ids.size() && s_lookaheadIds.size() < depth; ++i)
+            s_lookaheadIds.push_back(g_poi_ids[i]);
     }
+    SimObjectManager_SetLookahead(s_lookaheadIds.data(), s_lookaheadIds.size());
 }
 
 /**
- * Called when the local variable L:WFP_StartFlight changes.
+ * Scheduler callback: silence the NextPoi sound again
+ */
+static void ResetNextPoiSound(void*)
+{
+    s_nextPoiSoundReset = 0;
+    ExecuteCalculatorCode("0 (>L:WFP_NEXT_POI_SOUND)");
+    LOG_INFO("NextPoi sound reset to 0 after %u ms.", NEXT_POI_SOUND_RESET_MS);
+}
+
+/**
+ * Called by the L:Var registry when L:WFP_StartFlight changes.
  * newValue: 1.0 => start flight (spawn first POI), 0.0 => stop flight (remove all objects)
  */
 void FlightController_OnStartFlight(double newValue)
 {
-    if (newValue != g_lastStartFlight)
+    if (newValue == 1.0)
     {
-        fprintf(stderr, "[MSFS] L:WFP_StartFlight changed -> %.0f\n", newValue);
+        // Start flight: clear any previously spawned objects then spawn the first POI
+        LOG_INFO("-> Starting Flight: removing all, spawning first POI.");
+        RemoveSimObject();
+        Geofence_Reset();
+        g_flightActive = false;
+
+        // Shorten the tour before it starts; JS receives the new order
+        if (TourOptimizer_GetConfig().enabled && g_poi_coords.size() > 1)
+            TourOptimizer_OptimizeTour(0);
+
+        g_activePoiIndex = 0;
+        g_flightActive = true;
 
-        if (newValue == 1.0)
+        if (!g_poi_coords.empty())
         {
-            // Start flight: clear any previously spawned objects then spawn the first POI
-            fprintf(stderr, "[MSFS] -> Starting Flight: removing all, spawning first POI.\n");
-            RemoveSimObject();
-            g_activePoiIndex = 0;
-            g_flightActive = true;
-
-            if (!g_poi_coords.empty())
-            {
-                double lat = g_poi_coords[0].first;
-                double lon = g_poi_coords[0].second;
-
-                // Prepare SimConnect init position structure for terrain-level spawn
-                SIMCONNECT_DATA_INITPOSITION pos = {};
-                pos.Latitude = lat;
-                pos.Longitude = lon;
-                pos.Altitude = 0; // 0 means use terrain elevation when OnGround=1
-                pos.OnGround = 1;
-
-                // Request creation of a 'laser_red' SimObject at the POI
-                SimConnect_AICreateSimulatedObject(g_hSimConnect, "laser_red", pos, REQUEST_ADD_LASERS);
-                fprintf(stderr, "[MSFS] Spawned first POI at index 0 (%.6f, %.6f)\n", lat, lon);
-            }
-            else
-            {
-                fprintf(stderr, "[MSFS] No POIs available to spawn.\n");
-            }
+            // The active POI is the only one that wants a marker in flight mode
+            SimObjectManager_TrackMarkerLatency(g_poi_ids[0]);
+            SimObjectManager_ReconcilePoi(g_poi_ids[0]);
+            UpdateLookahead();
+            LOG_INFO("Spawned first POI at index 0 (%.6f, %.6f)", g_poi_coords.lat[0], g_poi_coords.lon[0]);
         }
-        else if (newValue == 0.0)
+        else
         {
-            // Stop flight: remove all spawned objects and reset state
-            fprintf(stderr, "[MSFS] -> Flight stopped, removing all objects.\n");
-            RemoveSimObject();
-            g_flightActive = false;
-            g_activePoiIndex = -1;
+            LOG_INFO("No POIs available to spawn.");
         }
-
-        // Store last observed value for change detection (rising/falling edges)
-        g_lastStartFlight = newValue;
+    }
+    else if (newValue == 0.0)
+    {
+        // Stop flight: remove all spawned objects and reset state
+        LOG_INFO("-> Flight stopped, removing all objects.");
+        RemoveSimObject();
+        g_flightActive = false;
+        g_activePoiIndex = -1;
     }
 }
 
 
 /**
- * Called when the local variable L:WFP_NextPoi changes.
- * newValue: value becomes 1.0 to advance to next POI (if flight is active)
+ * Makes nextIndex the active POI (or ends the flight past the last POI):
+ * moves the marker and plays the NextPoi sound.
  */
-void FlightController_OnNextPoi(double newValue) {
-    if (newValue != g_lastNextPoi)
+static void AdvanceTo(int nextIndex)
+{
+    int previousIndex = g_activePoiIndex;
+    g_activePoiIndex = nextIndex;
+    if (g_activePoiIndex < (int)g_poi_coords.size())
+    {
+        double lat = g_poi_coords.lat[g_activePoiIndex];
+        double lon = g_poi_coords.lon[g_activePoiIndex];
+
+        // Release the previous POI's marker first so its object can be reused
+        // (moved in place instead of remove + create). Shifting the lookahead
+        // raises the active POI's parked marker and parks the freed object at
+        // the new end of the window.
+        SimObjectManager_TrackMarkerLatency(g_poi_ids[g_activePoiIndex]);
+        if (previousIndex >= 0 && previousIndex < (int)g_poi_ids.size())
+            SimObjectManager_ReconcilePoi(g_poi_ids[previousIndex]);
+        UpdateLookahead();
+        SimObjectManager_ReconcilePoi(g_poi_ids[g_activePoiIndex]);
+
+        LOG_INFO("Advanced to POI[%d] -> %.6f, %.6f", g_activePoiIndex, lat, lon);
+
+        // ---------------------------------------------------------------
+        // Trigger NextPoi sound: set L:WFP_NEXT_POI_VOLUME to 100 and
+        // L:WFP_NEXT_POI_SOUND to 1, then reset it to 0 after
+        // NEXT_POI_SOUND_RESET_MS (a pending reset is pushed back)
+        // ---------------------------------------------------------------
+        ExecuteCalculatorCode("100 (>L:WFP_NEXT_POI_VOLUME)");
+        ExecuteCalculatorCode("1 (>L:WFP_NEXT_POI_SOUND)");
+
+        if (!Scheduler_Reschedule(s_nextPoiSoundReset, NEXT_POI_SOUND_RESET_MS))
+            s_nextPoiSoundReset = Scheduler_Schedule(NEXT_POI_SOUND_RESET_MS, ResetNextPoiSound, nullptr);
+
+        LOG_INFO("NextPoi sound triggered, will reset in %u ms.", NEXT_POI_SOUND_RESET_MS);
+    }
+    else
     {
-        fprintf(stderr, "[MSFS] L:WFP_NextPoi changed -> %.0f\n", newValue);
+        // Reached end of POI list: cleanup and deactivate flight
+        LOG_INFO("End of POI list reached.");
+        RemoveSimObject();
+        g_flightActive = false;
+    }
+}
 
-        // Only react to NextPoi if the flight is currently active
-        if (g_flightActive && newValue == 1.0)
-        {
-            g_activePoiIndex++;
-            if (g_activePoiIndex < (int)g_poi_coords.size())
-            {
-                // Remove previous POI objects then spawn the next one
-                RemoveSimObject();
-
-                double lat = g_poi_coords[g_activePoiIndex].first;
-                double lon = g_poi_coords[g_activePoiIndex].second;
-
-                SIMCONNECT_DATA_INITPOSITION pos = {};
-                pos.Latitude = lat;
-                pos.Longitude = lon;
-                pos.Altitude = 0;
-                pos.OnGround = 1;
-
-                SimConnect_AICreateSimulatedObject(g_hSimConnect, "laser_red", pos, REQUEST_ADD_LASERS);
-
-                fprintf(stderr, "[MSFS] Advanced to POI[%d] -> %.6f, %.6f\n", g_activePoiIndex, lat, lon);
-                
-                // ---------------------------------------------------------------
-                // Trigger NextPoi sound: set L:WFP_NEXT_POI_VOLUME to 100 and
-                // L:WFP_NEXT_POI_SOUND to 1, then schedule reset to 0 after 2s
-                // ---------------------------------------------------------------
-                ExecuteCalculatorCode("100 (>L:WFP_NEXT_POI_VOLUME)");
-                ExecuteCalculatorCode("1 (>L:WFP_NEXT_POI_SOUND)");
-                
-                // Schedule sound reset for 2 seconds from now (using absolute timestamp)
-                g_nextPoiSoundResetTimestamp = time(nullptr) + 4; // current time + 4 seconds
-                g_nextPoiSoundActive = true;
-                
-                fprintf(stderr, "[MSFS] NextPoi sound triggered, will reset in 4 seconds.\n");
-            }
-            else
-            {
-                // Reached end of POI list: cleanup and deactivate flight
-                fprintf(stderr, "[MSFS] End of POI list reached.\n");
-                RemoveSimObject();
-                g_flightActive = false;
-            }
-        }
+/**
+ * Called by the L:Var registry when L:WFP_NextPoi rises to 1.
+ * Advances to the next POI if the flight is active.
+ */
+void FlightController_OnNextPoi(double newValue) {
+    // Only react to NextPoi if the flight is currently active
+    if (!g_flightActive)
+        return;
 
-        // Update last seen NextPoi value
-        g_lastNextPoi = newValue;
-    }
-}
\ No newline at end of file
+    AdvanceTo(g_activePoiIndex + 1);
+}
+
+/**
+ * Called by the geofence engine when the aircraft arrives at POI[index]
+ * (the active POI or one of the next few). Continues with the POI after it.
+ */
+void FlightController_OnPoiArrived(int index)
+{
+    if (!g_flightActive || index < g_activePoiIndex)
+        return;
+
+    if (index > g_activePoiIndex)
+        LOG_INFO("Arrived at POI[%d], skipping %d POI(s).", index, index - g_activePoiIndex);
+    else
+        LOG_INFO("Arrived at POI[%d].", index);
+
+    AdvanceTo(index + 1);
+}
+
+/**
+ * Continues a flight restored from the tour snapshot at module init: shows the
+ * active POI's marker and sets L:WFP_StartFlight to 1 (the registry is told
+ * first, so the L:Var sample does not restart the tour from POI[0]).
+ */
+void FlightController_Resume()
+{
+    if (!g_flightActive || g_activePoiIndex < 0 || g_activePoiIndex >= (int)g_poi_ids.size())
+        return;
+
+    LVarRegistry_SetLastValue("L:WFP_StartFlight", 1.0);
+    ExecuteCalculatorCode("1 (>L:WFP_StartFlight)");
+
+    SimObjectManager_TrackMarkerLatency(g_poi_ids[g_activePoiIndex]);
+    SimObjectManager_ReconcilePoi(g_poi_ids[g_activePoiIndex]);
+    UpdateLookahead();
+    LOG_INFO("Resumed flight at POI[%d] (%.6f, %.6f)", g_activePoiIndex,
+        g_poi_coords.lat[g_activePoiIndex], g_poi_coords.lon[g_activePoiIndex]);
+}
+
+void FlightController_OnFrame()
+{
+    UpdateLookahead();
+}
+
+void FlightController_SetLookahead(const MarkerLookaheadConfig& config)
+{
+    s_lookaheadDepth = config.depth;
+    s_lookaheadBudget = config.budget;
+    LOG_INFO("Marker lookahead: %u POIs, budget %u", (unsigned)s_lookaheadDepth, (unsigned)s_lookaheadBudget);
+    UpdateLookahead();
+}
+
+MarkerLookaheadConfig FlightController_GetLookahead()
+{
+    MarkerLookaheadConfig config;
+    config.depth = s_lookaheadDepth;
+    config.budget = s_lookaheadBudget;
+    return config;
+}
+
+bool FlightController_OnLookaheadMessage(PoiParseResult& msg)
+{
+    MarkerLookaheadConfig config = FlightController_GetLookahead();
+    Param_Count(msg, "depth", 0, &config.depth);
+    Param_Count(msg, "budget", 0, &config.budget);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    FlightController_SetLookahead(config);
+    OutboundQueue_Sendf("ack: MARKER_LOOKAHEAD depth=%u budget=%u",
+        (unsigned)s_lookaheadDepth, (unsigned)s_lookaheadBudget);
+    return true;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <vector>
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "flight/GeofenceEngine.h"
+#include "flight/FlightController.h"
+#include "core/ModuleContext.h"
+#include "core/Constants.h"
+#include "geo/PoiKernels.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// GeofenceEngine
+// - The fence window is POI[active .. active + lookahead]; its inside flags
+//   are carried over by POI id when the window moves
+// - Distances for the whole window come from one batch kernel call per
+//   frame; nothing runs while no flight is active
+// - At most one arrival per sample: the earliest fenced POI within the
+//   arrival radius
+// -----------------------------------------------------------------------------
+
+struct FenceState
+{
+    uint32_t poiId;
+    bool inside;
+};
+
+static bool s_enabled = true;
+static double s_enterMeters = GEOFENCE_ENTER_METERS;
+static double s_exitMeters = GEOFENCE_EXIT_METERS;
+static double s_arrivalMeters = GEOFENCE_ARRIVAL_METERS;
+static uint32_t s_lookahead = GEOFENCE_LOOKAHEAD;
+
+static std::vector<FenceState> s_fences;     // current window, tour order
+static std::vector<FenceState> s_nextFences; // scratch
+static std::vector<double> s_meters;         // scratch, per window entry
+
+static void SendFenceEvent(const char* event, uint32_t poiId, int index, double meters)
+{
+    OutboundQueue_Sendf("{\"type\":\"GEOFENCE\",\"event\":\"%s\",\"id\":%u,\"index\":%d,\"meters\":%.0f}",
+        event, (unsigned)poiId, index, meters);
+}
+
+static bool WasInside(uint32_t poiId)
+{
+    for (size_t i = 0; i < s_fences.size(); ++i)
+        if (s_fences[i].poiId == poiId)
+            return s_fences[i].inside;
+    return false;
+}
+
+void Geofence_OnUserPosition(double latDeg, double lonDeg)
+{
+    if (!s_enabled || !g_flightActive || g_activePoiIndex < 0)
+    {
+        s_fences.clear();
+        return;
+    }
+
+    // Window end in size_t: no signed overflow whatever the lookahead
+    size_t count = g_poi_coords.size();
+    if ((size_t)g_activePoiIndex >= count)
+    {
+        s_fences.clear();
+        return;
+    }
+    int first = g_activePoiIndex;
+    int last = (int)std::min((size_t)first + s_lookahead, count - 1);
+
+    s_meters.resize((size_t)(last - first + 1));
+    PoiKernels_Distances(g_poi_coords, (size_t)first, s_meters.size(), latDeg, lonDeg, s_meters.data());
+
+    int arrivedIndex = -1;
+    s_nextFences.clear();
+    for (int i = first; i <= last; ++i)
+    {
+        FenceState fence;
+        fence.poiId = g_poi_ids[i];
+        bool wasInside = WasInside(fence.poiId);
+
+        double meters = s_meters[i - first];
+        fence.inside = wasInside ? meters <= s_exitMeters : meters <= s_enterMeters;
+        s_nextFences.push_back(fence);
+
+        if (fence.inside != wasInside)
+        {
+            LOG_INFO("Geofence %s POI[%d] id=%u (%.0f m)",
+                fence.inside ? "ENTER" : "EXIT", i, (unsigned)fence.poiId, meters);
+            SendFenceEvent(fence.inside ? "ENTER" : "EXIT", fence.poiId, i, meters);
+        }
+
+        if (fence.inside && meters <= s_arrivalMeters && arrivedIndex < 0)
+            arrivedIndex = i;
+    }
+    s_fences.swap(s_nextFences);
+
+    if (arrivedIndex < 0)
+        return;
+
+    uint32_t arrivedId = g_poi_ids[arrivedIndex];
+    FlightController_OnPoiArrived(arrivedIndex);
+
+    OutboundQueue_Sendf("{\"type\":\"POI_ARRIVED\",\"id\":%u,\"index\":%d,\"active\":%d}",
+        (unsigned)arrivedId, arrivedIndex, g_flightActive ? g_activePoiIndex : -1);
+}
+
+void Geofence_Reset()
+{
+    s_fences.clear();
+}
+
+void Geofence_SetConfig(const GeofenceConfig& config)
+{
+    s_enabled = config.enabled;
+    s_enterMeters = config.enterMeters > 0.0 ? config.enterMeters : GEOFENCE_ENTER_METERS;
+    s_exitMeters = config.exitMeters > s_enterMeters ? config.exitMeters : s_enterMeters;
+    s_arrivalMeters = config.arrivalMeters > 0.0 ? config.arrivalMeters : GEOFENCE_ARRIVAL_METERS;
+    if (s_arrivalMeters > s_enterMeters)
+        s_arrivalMeters = s_enterMeters;
+    s_lookahead = std::min(config.lookahead, (uint32_t)GEOFENCE_MAX_LOOKAHEAD);
+    s_fences.clear();
+
+    LOG_INFO("Geofences %s (enter=%.0fm, exit=%.0fm, arrival=%.0fm, lookahead=%u)",
+        s_enabled ? "enabled" : "disabled", s_enterMeters, s_exitMeters, s_arrivalMeters, (unsigned)s_lookahead);
+}
+
+GeofenceConfig Geofence_GetConfig()
+{
+    GeofenceConfig config;
+    config.enabled = s_enabled;
+    config.enterMeters = s_enterMeters;
+    config.exitMeters = s_exitMeters;
+    config.arrivalMeters = s_arrivalMeters;
+    config.lookahead = s_lookahead;
+    return config;
+}
+
+bool Geofence_OnMessage(PoiParseResult& msg)
+{
+    GeofenceConfig config = Geofence_GetConfig();
+    Param_Bool(msg, "enabled", &config.enabled);
+    Param_Double(msg, "radius", &config.enterMeters);
+    Param_Double(msg, "exitRadius", &config.exitMeters);
+    Param_Double(msg, "arrivalRadius", &config.arrivalMeters);
+    Param_Count(msg, "lookahead", 0, &config.lookahead);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    Geofence_SetConfig(config);
+    OutboundQueue_Sendf("ack: GEOFENCE enabled=%d radius=%.0f exitRadius=%.0f arrivalRadius=%.0f lookahead=%u",
+        s_enabled ? 1 : 0, s_enterMeters, s_exitMeters, s_arrivalMeters, (unsigned)s_lookahead);
+    return true;
+}
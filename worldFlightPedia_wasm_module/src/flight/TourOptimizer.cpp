@@ -0,0 +1,614 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "comm/ReplyBuilder.h"
+#include "core/Arena.h"
+#include "flight/TourOptimizer.h"
+#include "geo/Geodesy.h"
+#include "core/ModuleContext.h"
+#include "core/Constants.h"
+#include "core/PoiStore.h"
+#include "simconnect/Telemetry.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// TourOptimizer
+// - Nodes 0..n-1 are the POIs; node n is the depot, which is always at tour
+//   position 0. With a start point the depot sits there; without one its
+//   edges cost nothing, so any POI may come first.
+// - The path end is open: the edge after position n costs nothing.
+// - tour[] holds nodes by position and pos[] the inverse, so both moves are
+//   plain array operations (reverse / rotate) of O(segment length)
+// - Candidate neighbours come from a k-d tree over the POIs' unit vectors
+//   (taken from PoiColumns)
+// - Costs are central angles (radians); meters only for the stats
+// -----------------------------------------------------------------------------
+
+static const uint32_t kNeighbours = 8;
+static const uint32_t kMaxOrOptSegment = 3;
+static const double kEpsilon = 1e-10; // radians, ~0.6 mm
+
+struct TourNode
+{
+    double v[3]; // unit vector
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static double ElapsedMs(Clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+static std::vector<TourNode> s_nodes;         // POIs, then the depot
+static std::vector<uint32_t> s_tour;          // node by position
+static std::vector<uint32_t> s_pos;           // position by node
+static std::vector<uint32_t> s_neighbours;    // kNeighbours per POI, closest first
+static std::vector<uint32_t> s_neighbourCount;
+static std::vector<uint32_t> s_kdTree;        // implicit k-d tree (median split)
+static std::vector<uint32_t> s_unvisited;     // scratch for the seed
+static std::vector<uint32_t> s_unvisitedSlot;
+static uint32_t s_depot = 0;
+static bool s_hasStart = false;
+
+static bool s_autoOptimize = false; // the panel does not apply TOUR_ORDER yet
+static bool s_fromAircraft = true;
+static uint32_t s_budgetMs = TOUR_OPTIMIZE_BUDGET_MS;
+
+static TourNode ToNode(double latDeg, double lonDeg)
+{
+    double lat = latDeg * GEO_DEG_TO_RAD;
+    double lon = lonDeg * GEO_DEG_TO_RAD;
+    TourNode n;
+    n.v[0] = std::cos(lat) * std::cos(lon);
+    n.v[1] = std::cos(lat) * std::sin(lon);
+    n.v[2] = std::sin(lat);
+    return n;
+}
+
+static double Chord2(const TourNode& a, const TourNode& b)
+{
+    double dx = a.v[0] - b.v[0];
+    double dy = a.v[1] - b.v[1];
+    double dz = a.v[2] - b.v[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Cost of the edge between two nodes (central angle)
+static double Cost(uint32_t a, uint32_t b)
+{
+    if ((a == s_depot || b == s_depot) && !s_hasStart)
+        return 0.0;
+    double half = 0.5 * std::sqrt(Chord2(s_nodes[a], s_nodes[b]));
+    return 2.0 * std::asin(half < 1.0 ? half : 1.0);
+}
+
+// Cost of the edge leaving tour position p (nothing after the last one)
+static double CostAfter(uint32_t p)
+{
+    return p < s_depot ? Cost(s_tour[p], s_tour[p + 1]) : 0.0;
+}
+
+static double TourCost()
+{
+    double total = 0.0;
+    for (uint32_t p = 0; p < s_depot; ++p)
+        total += Cost(s_tour[p], s_tour[p + 1]);
+    return total;
+}
+
+// -----------------------------------------------------------------------------
+// Candidate neighbours
+// -----------------------------------------------------------------------------
+
+static void BuildKdTree(uint32_t lo, uint32_t hi, int axis)
+{
+    if (hi - lo < 2)
+        return;
+    uint32_t mid = lo + (hi - lo) / 2;
+    std::nth_element(s_kdTree.begin() + lo, s_kdTree.begin() + mid, s_kdTree.begin() + hi,
+        [axis](uint32_t a, uint32_t b) { return s_nodes[a].v[axis] < s_nodes[b].v[axis]; });
+    BuildKdTree(lo, mid, (axis + 1) % 3);
+    BuildKdTree(mid + 1, hi, (axis + 1) % 3);
+}
+
+struct NeighbourHeap
+{
+    uint32_t self;
+    uint32_t count;
+    uint32_t ids[kNeighbours];
+    double dist2[kNeighbours]; // ascending
+};
+
+static void Offer(NeighbourHeap& h, uint32_t id, double d2)
+{
+    if (id == h.self || (h.count == kNeighbours && d2 >= h.dist2[kNeighbours - 1]))
+        return;
+    uint32_t i = h.count < kNeighbours ? h.count++ : kNeighbours - 1;
+    while (i > 0 && h.dist2[i - 1] > d2)
+    {
+        h.ids[i] = h.ids[i - 1];
+        h.dist2[i] = h.dist2[i - 1];
+        --i;
+    }
+    h.ids[i] = id;
+    h.dist2[i] = d2;
+}
+
+static void QueryKdTree(uint32_t lo, uint32_t hi, int axis, NeighbourHeap& h)
+{
+    if (lo >= hi)
+        return;
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint32_t node = s_kdTree[mid];
+    const TourNode& q = s_nodes[h.self];
+    Offer(h, node, Chord2(q, s_nodes[node]));
+
+    double diff = q.v[axis] - s_nodes[node].v[axis];
+    int next = (axis + 1) % 3;
+    if (diff < 0.0)
+        QueryKdTree(lo, mid, next, h);
+    else
+        QueryKdTree(mid + 1, hi, next, h);
+
+    if (h.count < kNeighbours || diff * diff < h.dist2[h.count - 1])
+    {
+        if (diff < 0.0)
+            QueryKdTree(mid + 1, hi, next, h);
+        else
+            QueryKdTree(lo, mid, next, h);
+    }
+}
+
+// Returns false when the budget ran out first
+static bool BuildNeighbours(uint32_t n, Clock::time_point started, double budgetMs)
+{
+    s_kdTree.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+        s_kdTree[i] = i;
+    BuildKdTree(0, n, 0);
+
+    s_neighbours.resize((size_t)n * kNeighbours);
+    s_neighbourCount.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        NeighbourHeap h;
+        h.self = i;
+        h.count = 0;
+        QueryKdTree(0, n, 0, h);
+        for (uint32_t k = 0; k < h.count; ++k)
+            s_neighbours[(size_t)i * kNeighbours + k] = h.ids[k];
+        s_neighbourCount[i] = h.count;
+        if ((i & 63) == 63 && ElapsedMs(started) >= budgetMs)
+            return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Nearest-neighbour seed
+// - The closest unvisited candidate neighbour, or a scan over all unvisited
+//   POIs when every candidate is taken
+// -----------------------------------------------------------------------------
+
+static void TakeUnvisited(uint32_t node)
+{
+    uint32_t slot = s_unvisitedSlot[node];
+    uint32_t last = s_unvisited.back();
+    s_unvisited[slot] = last;
+    s_unvisitedSlot[last] = slot;
+    s_unvisited.pop_back();
+}
+
+static uint32_t ClosestUnvisited(uint32_t from)
+{
+    uint32_t best = s_unvisited[0];
+    double bestD2 = Chord2(s_nodes[from], s_nodes[best]);
+    for (size_t i = 1; i < s_unvisited.size(); ++i)
+    {
+        double d2 = Chord2(s_nodes[from], s_nodes[s_unvisited[i]]);
+        if (d2 < bestD2)
+        {
+            bestD2 = d2;
+            best = s_unvisited[i];
+        }
+    }
+    return best;
+}
+
+// Returns false when the budget ran out first; the POIs not placed yet then
+// follow in input order
+static bool BuildSeed(uint32_t n, Clock::time_point started, double budgetMs)
+{
+    s_unvisited.resize(n);
+    s_unvisitedSlot.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        s_unvisited[i] = i;
+        s_unvisitedSlot[i] = i;
+    }
+
+    s_tour.resize(n + 1);
+    s_pos.resize(n + 1);
+    s_tour[0] = s_depot;
+
+    // Without a start point the tour begins where the input did
+    bool complete = true;
+    uint32_t current = s_hasStart ? ClosestUnvisited(s_depot) : 0;
+    for (uint32_t p = 1; p <= n; ++p)
+    {
+        s_tour[p] = current;
+        TakeUnvisited(current);
+        if (s_unvisited.empty())
+            break;
+
+        // A step may scan every unvisited POI, so the clock is read often
+        if ((p & 15) == 0 && ElapsedMs(started) >= budgetMs)
+        {
+            std::sort(s_unvisited.begin(), s_unvisited.end());
+            std::copy(s_unvisited.begin(), s_unvisited.end(), s_tour.begin() + p + 1);
+            complete = false;
+            break;
+        }
+
+        uint32_t next = s_depot;
+        const uint32_t* candidates = &s_neighbours[(size_t)current * kNeighbours];
+        for (uint32_t k = 0; k < s_neighbourCount[current]; ++k)
+        {
+            uint32_t c = candidates[k];
+            if (s_unvisitedSlot[c] < s_unvisited.size() && s_unvisited[s_unvisitedSlot[c]] == c)
+            {
+                next = c;
+                break;
+            }
+        }
+        current = next != s_depot ? next : ClosestUnvisited(current);
+    }
+
+    for (uint32_t p = 0; p <= n; ++p)
+        s_pos[s_tour[p]] = p;
+    return complete;
+}
+
+// -----------------------------------------------------------------------------
+// Improvement moves
+// -----------------------------------------------------------------------------
+
+// Reverses tour positions [l, r] when that shortens the path
+static bool TryReverse(uint32_t l, uint32_t r)
+{
+    if (l < 1 || r <= l || r > s_depot)
+        return false;
+
+    double removed = Cost(s_tour[l - 1], s_tour[l]) + CostAfter(r);
+    double added = Cost(s_tour[l - 1], s_tour[r]) + (r < s_depot ? Cost(s_tour[l], s_tour[r + 1]) : 0.0);
+    if (added >= removed - kEpsilon)
+        return false;
+
+    std::reverse(s_tour.begin() + l, s_tour.begin() + r + 1);
+    for (uint32_t p = l; p <= r; ++p)
+        s_pos[s_tour[p]] = p;
+    return true;
+}
+
+// 2-opt around the POI at position i: new edge from it to a candidate
+// neighbour, taking the place of its outgoing or its incoming edge
+static bool TwoOptAt(uint32_t i)
+{
+    uint32_t a = s_tour[i];
+    double costOut = CostAfter(i);
+    double costIn = Cost(s_tour[i - 1], a);
+
+    // Reverse the prefix: a becomes the first POI (matters without a start point)
+    if (TryReverse(1, i))
+        return true;
+
+    const uint32_t* candidates = &s_neighbours[(size_t)a * kNeighbours];
+    for (uint32_t k = 0; k < s_neighbourCount[a]; ++k)
+    {
+        uint32_t c = candidates[k];
+        double d = Cost(a, c);
+        if (d >= costOut && d >= costIn)
+            break; // candidates are sorted, no later one can gain either
+
+        uint32_t j = s_pos[c];
+        uint32_t lo = i < j ? i : j;
+        uint32_t hi = i < j ? j : i;
+        if (d < costOut && TryReverse(lo + 1, hi))
+            return true;
+        if (d < costIn && TryReverse(lo, hi - 1))
+            return true;
+    }
+    return false;
+}
+
+// Moves the segment at positions [s, e] into the gap after position g,
+// reversed if asked
+static void MoveSegment(uint32_t s, uint32_t e, uint32_t g, bool reversed)
+{
+    uint32_t length = e - s + 1;
+    uint32_t from, to, first;
+    if (g > e)
+    {
+        std::rotate(s_tour.begin() + s, s_tour.begin() + e + 1, s_tour.begin() + g + 1);
+        from = s;
+        to = g;
+        first = g - length + 1;
+    }
+    else
+    {
+        std::rotate(s_tour.begin() + g + 1, s_tour.begin() + s, s_tour.begin() + e + 1);
+        from = g + 1;
+        to = e;
+        first = g + 1;
+    }
+    if (reversed)
+        std::reverse(s_tour.begin() + first, s_tour.begin() + first + length);
+    for (uint32_t p = from; p <= to; ++p)
+        s_pos[s_tour[p]] = p;
+}
+
+// Or-opt for the segment of 'length' POIs starting at position s: reinserts
+// it next to a candidate neighbour of one of its ends
+static bool OrOptAt(uint32_t s, uint32_t length)
+{
+    uint32_t e = s + length - 1;
+    if (e > s_depot)
+        return false;
+
+    uint32_t head = s_tour[s];
+    uint32_t tail = s_tour[e];
+    uint32_t prev = s_tour[s - 1];
+    double removeGain = Cost(prev, head);
+    if (e < s_depot)
+        removeGain += Cost(tail, s_tour[e + 1]) - Cost(prev, s_tour[e + 1]);
+    if (removeGain <= kEpsilon)
+        return false;
+
+    double bestDelta = -kEpsilon;
+    uint32_t bestGap = 0;
+    bool bestReversed = false;
+    bool found = false;
+
+    for (int end = 0; end < 2; ++end)
+    {
+        uint32_t x = end == 0 ? head : tail;
+        const uint32_t* candidates = &s_neighbours[(size_t)x * kNeighbours];
+        for (uint32_t k = 0; k < s_neighbourCount[x]; ++k)
+        {
+            uint32_t c = candidates[k];
+            if (Cost(x, c) >= removeGain)
+                break;
+
+            uint32_t pc = s_pos[c];
+            for (int side = 0; side < 2; ++side)
+            {
+                // Gap after position g: c on its left (g = pc) or right (g = pc - 1)
+                if (side == 1 && pc == 0)
+                    continue;
+                uint32_t g = side == 0 ? pc : pc - 1;
+                if (g + 1 >= s && g <= e)
+                    continue; // touches the segment itself
+
+                uint32_t u = s_tour[g];
+                bool hasV = g < s_depot;
+                uint32_t v = hasV ? s_tour[g + 1] : 0;
+                double gapCost = hasV ? Cost(u, v) : 0.0;
+
+                for (int dir = 0; dir < (length > 1 ? 2 : 1); ++dir)
+                {
+                    uint32_t left = dir == 0 ? head : tail;
+                    uint32_t right = dir == 0 ? tail : head;
+                    double insert = Cost(u, left) + (hasV ? Cost(right, v) - gapCost : 0.0);
+                    double delta = insert - removeGain;
+                    if (delta < bestDelta)
+                    {
+                        bestDelta = delta;
+                        bestGap = g;
+                        bestReversed = dir == 1;
+                        found = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!found)
+        return false;
+    MoveSegment(s, e, bestGap, bestReversed);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Solver
+// -----------------------------------------------------------------------------
+
+void TourOptimizer_Solve(const PoiColumns& pois, size_t first, bool hasStart, double startLat, double startLon,
+    uint32_t budgetMs, std::vector<uint32_t>& order, TourStats& stats)
+{
+    Clock::time_point started = Clock::now();
+    uint32_t n = first < pois.size() ? (uint32_t)(pois.size() - first) : 0;
+
+    stats = TourStats();
+    order.resize(n);
+    for (uint32_t i = 0; i < n; ++i)
+        order[i] = i;
+
+    s_depot = n;
+    s_hasStart = hasStart;
+    s_nodes.resize(n + 1);
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        s_nodes[i].v[0] = pois.x[first + i];
+        s_nodes[i].v[1] = pois.y[first + i];
+        s_nodes[i].v[2] = pois.z[first + i];
+    }
+    s_nodes[n] = ToNode(startLat, startLon);
+
+    // Input order
+    s_tour.resize(n + 1);
+    s_tour[0] = s_depot;
+    for (uint32_t i = 0; i < n; ++i)
+        s_tour[i + 1] = i;
+    double inputCost = TourCost();
+    stats.inputMeters = stats.seedMeters = stats.meters = inputCost * GEO_MEAN_RADIUS_METERS;
+
+    if (n < 2 || (n < 3 && !hasStart))
+    {
+        stats.elapsedMs = ElapsedMs(started);
+        return;
+    }
+
+    // The budget covers the whole run; out of time before the seed is complete,
+    // the input order is kept (neighbours) or finishes the seed
+    double budget = (double)budgetMs;
+    if (!BuildNeighbours(n, started, budget))
+    {
+        stats.budgetExhausted = true;
+        stats.elapsedMs = ElapsedMs(started);
+        return;
+    }
+    stats.budgetExhausted = !BuildSeed(n, started, budget);
+    stats.seedMeters = TourCost() * GEO_MEAN_RADIUS_METERS;
+
+    uint32_t steps = 0;
+    bool improved = true;
+    while (improved && !stats.budgetExhausted)
+    {
+        improved = false;
+        for (uint32_t i = 1; i <= n && !stats.budgetExhausted; ++i)
+        {
+            if (TwoOptAt(i))
+            {
+                stats.twoOptMoves++;
+                improved = true;
+            }
+            if ((++steps & 255) == 0 && ElapsedMs(started) >= budget)
+                stats.budgetExhausted = true;
+        }
+        for (uint32_t length = 1; length <= kMaxOrOptSegment; ++length)
+        {
+            for (uint32_t s = 1; s + length - 1 <= n && !stats.budgetExhausted; ++s)
+            {
+                if (OrOptAt(s, length))
+                {
+                    stats.orOptMoves++;
+                    improved = true;
+                }
+                if ((++steps & 255) == 0 && ElapsedMs(started) >= budget)
+                    stats.budgetExhausted = true;
+            }
+        }
+    }
+
+    double cost = TourCost();
+    if (cost < inputCost)
+    {
+        for (uint32_t p = 1; p <= n; ++p)
+            order[p - 1] = s_tour[p];
+        stats.meters = cost * GEO_MEAN_RADIUS_METERS;
+    }
+    stats.elapsedMs = ElapsedMs(started);
+}
+
+// -----------------------------------------------------------------------------
+// Tour of the POI store
+// -----------------------------------------------------------------------------
+
+static std::vector<uint32_t> s_order;
+
+void TourOptimizer_OptimizeTour(uint32_t requestId)
+{
+    // Mid-flight only the POIs after the active one move, starting from it
+    size_t from = g_flightActive && g_activePoiIndex >= 0 ? (size_t)g_activePoiIndex + 1 : 0;
+    if (from > g_poi_coords.size())
+        from = g_poi_coords.size();
+
+    AircraftState aircraft;
+    bool hasStart = false;
+    double startLat = 0.0;
+    double startLon = 0.0;
+    if (from > 0)
+    {
+        hasStart = true;
+        startLat = g_poi_coords.lat[from - 1];
+        startLon = g_poi_coords.lon[from - 1];
+    }
+    else if (s_fromAircraft && Telemetry_Get(&aircraft))
+    {
+        hasStart = true;
+        startLat = aircraft.latDeg;
+        startLon = aircraft.lonDeg;
+    }
+
+    TourStats stats;
+    TourOptimizer_Solve(g_poi_coords, from, hasStart, startLat, startLon, s_budgetMs, s_order, stats);
+    PoiStore_Reorder(from, s_order);
+
+    LOG_INFO("Tour optimized: %zu POIs from index %zu, %.0f m -> %.0f m (seed %.0f m, %u 2-opt, %u or-opt, %.1f ms%s)",
+        g_poi_coords.size() - from, from, stats.inputMeters, stats.meters, stats.seedMeters,
+        (unsigned)stats.twoOptMoves, (unsigned)stats.orOptMoves, stats.elapsedMs,
+        stats.budgetExhausted ? ", budget exhausted" : "");
+
+    // Also runs from the START FLIGHT L:Var, outside a message's arena scope
+    ArenaScope arena;
+    ReplyBuilder reply;
+    Reply_Begin(reply, 192 + g_poi_ids.size() * 12);
+
+    Reply_Appendf(reply, "{\"type\":\"TOUR_ORDER\",\"requestId\":%u,\"from\":%u,\"ids\":[",
+        (unsigned)requestId, (unsigned)from);
+    for (size_t i = 0; i < g_poi_ids.size(); ++i)
+        Reply_Appendf(reply, i ? ",%u" : "%u", (unsigned)g_poi_ids[i]);
+    Reply_Appendf(reply, "],\"meters\":%.0f,\"inputMeters\":%.0f,\"ms\":%.1f}",
+        stats.meters, stats.inputMeters, stats.elapsedMs);
+
+    Reply_Send(reply);
+}
+
+void TourOptimizer_SetConfig(const TourOptimizerConfig& config)
+{
+    s_autoOptimize = config.enabled;
+    s_fromAircraft = config.fromAircraft;
+    s_budgetMs = config.budgetMs ? config.budgetMs : 1;
+    LOG_INFO("Tour optimizer: auto=%s, fromAircraft=%s, budget=%u ms",
+        s_autoOptimize ? "on" : "off", s_fromAircraft ? "on" : "off", (unsigned)s_budgetMs);
+}
+
+TourOptimizerConfig TourOptimizer_GetConfig()
+{
+    TourOptimizerConfig config;
+    config.enabled = s_autoOptimize;
+    config.fromAircraft = s_fromAircraft;
+    config.budgetMs = s_budgetMs;
+    return config;
+}
+
+bool TourOptimizer_OnConfigMessage(PoiParseResult& msg)
+{
+    TourOptimizerConfig config = TourOptimizer_GetConfig();
+    Param_Bool(msg, "enabled", &config.enabled);
+    Param_Bool(msg, "fromAircraft", &config.fromAircraft);
+    Param_Count(msg, "budgetMs", 1, &config.budgetMs);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    TourOptimizer_SetConfig(config);
+    OutboundQueue_Sendf("ack: TOUR_OPTIMIZER enabled=%d fromAircraft=%d budgetMs=%u",
+        s_autoOptimize ? 1 : 0, s_fromAircraft ? 1 : 0, (unsigned)s_budgetMs);
+    return true;
+}
+
+bool TourOptimizer_OnOptimizeMessage(PoiParseResult& msg)
+{
+    uint32_t requestId = 0;
+    Param_Id(msg, "requestId", &requestId);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    TourOptimizer_OptimizeTour(requestId);
+    return true;
+}
@@ -0,0 +1,262 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "flight/TourSnapshot.h"
+#include "flight/FlightController.h"
+#include "comm/OutboundQueue.h"
+#include "core/ModuleContext.h"
+#include "core/PoiStore.h"
+#include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// Tour snapshot
+// - The file is built in one buffer (kept between saves) and written with one
+//   fwrite; loading is one fread into the same buffer
+// - Columns are stored whole (all ids, then all lat, then all lon) so saving
+//   and loading are straight copies per column
+// - The checksum runs over the payload first and the header fields last, so
+//   a change of active POI or flight state rewrites the 28-byte header in
+//   place with the payload's hash kept from the last full write
+// -----------------------------------------------------------------------------
+
+static const char kSnapshotMagic[8] = { 'W', 'F', 'P', 'T', 'O', 'U', 'R', '\0' };
+static const uint32_t kSnapshotVersion = 2;
+static const size_t kHeaderBytes = 28;
+static const size_t kChecksumOffset = 24;
+static const size_t kCheckedHeaderOffset = 8; // version, count, active, flags
+static const size_t kBytesPerPoi = sizeof(uint32_t) + 2 * sizeof(double);
+static const uint32_t kFlagFlightActive = 0x1;
+
+static std::vector<char> s_buffer;
+static PoiColumns s_loadedCoords;
+static std::vector<uint32_t> s_loadedIds;
+static std::vector<uint32_t> s_changed;
+
+// State last written (or loaded)
+static bool s_saved = false; // the file holds s_savedRevision's payload
+static uint32_t s_savedRevision = 0;
+static uint32_t s_payloadHash = 0;
+static int s_savedActiveIndex = -1;
+static bool s_savedFlightActive = false;
+
+static TimerHandle s_saveTimer = 0;
+
+static const uint32_t kFnvOffsetBasis = 2166136261u;
+
+static uint32_t Fnv1a(const char* data, size_t size, uint32_t hash = kFnvOffsetBasis)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool IsDirty()
+{
+    return PoiStore_Revision() != s_savedRevision
+        || g_activePoiIndex != s_savedActiveIndex
+        || g_flightActive != s_savedFlightActive;
+}
+
+static void RememberSaved(uint32_t payloadHash)
+{
+    s_saved = true;
+    s_savedRevision = PoiStore_Revision();
+    s_payloadHash = payloadHash;
+    s_savedActiveIndex = g_activePoiIndex;
+    s_savedFlightActive = g_flightActive;
+}
+
+// -----------------------------------------------------------------------------
+// Save
+// -----------------------------------------------------------------------------
+
+// Fills the header for the current active POI and flight state
+static void BuildHeader(char* p, uint32_t count, uint32_t payloadHash)
+{
+    int32_t active = g_activePoiIndex;
+    uint32_t flags = g_flightActive ? kFlagFlightActive : 0;
+    std::memcpy(p, kSnapshotMagic, sizeof(kSnapshotMagic));
+    std::memcpy(p + 8, &kSnapshotVersion, 4);
+    std::memcpy(p + 12, &count, 4);
+    std::memcpy(p + 16, &active, 4);
+    std::memcpy(p + 20, &flags, 4);
+
+    uint32_t checksum = Fnv1a(p + kCheckedHeaderOffset, kChecksumOffset - kCheckedHeaderOffset, payloadHash);
+    std::memcpy(p + kChecksumOffset, &checksum, 4);
+}
+
+// Rewrites the header of the last written file in place (same POIs)
+static bool SaveHeader()
+{
+    uint32_t count = (uint32_t)g_poi_ids.size();
+    char header[kHeaderBytes];
+    BuildHeader(header, count, s_payloadHash);
+
+    FILE* file = std::fopen(TOUR_SNAPSHOT_PATH, "r+b");
+    if (!file)
+        return false;
+    bool written = std::fwrite(header, 1, kHeaderBytes, file) == kHeaderBytes;
+    written = std::fclose(file) == 0 && written;
+    if (!written)
+        return false;
+
+    RememberSaved(s_payloadHash);
+    LOG_DEBUG("TourSnapshot: saved header (active=%d, flight=%d)",
+        g_activePoiIndex, g_flightActive ? 1 : 0);
+    return true;
+}
+
+static bool SaveFile()
+{
+    uint32_t count = (uint32_t)g_poi_ids.size();
+    s_buffer.resize(kHeaderBytes + count * kBytesPerPoi);
+    char* p = s_buffer.data();
+    char* payload = p + kHeaderBytes;
+    if (count)
+    {
+        std::memcpy(payload, g_poi_ids.data(), count * sizeof(uint32_t));
+        std::memcpy(payload + count * sizeof(uint32_t), g_poi_coords.lat.data(), count * sizeof(double));
+        std::memcpy(payload + count * (sizeof(uint32_t) + sizeof(double)), g_poi_coords.lon.data(), count * sizeof(double));
+    }
+
+    uint32_t payloadHash = Fnv1a(payload, count * kBytesPerPoi);
+    BuildHeader(p, count, payloadHash);
+
+    FILE* file = std::fopen(TOUR_SNAPSHOT_TEMP_PATH, "wb");
+    if (!file)
+    {
+        LOG_ERROR("TourSnapshot: cannot create %s", TOUR_SNAPSHOT_TEMP_PATH);
+        return false;
+    }
+    bool written = std::fwrite(s_buffer.data(), 1, s_buffer.size(), file) == s_buffer.size();
+    written = std::fclose(file) == 0 && written;
+
+    // rename does not replace an existing file everywhere
+    std::remove(TOUR_SNAPSHOT_PATH);
+    if (!written || std::rename(TOUR_SNAPSHOT_TEMP_PATH, TOUR_SNAPSHOT_PATH) != 0)
+    {
+        LOG_ERROR("TourSnapshot: cannot write %s", TOUR_SNAPSHOT_PATH);
+        return false;
+    }
+
+    RememberSaved(payloadHash);
+    LOG_DEBUG("TourSnapshot: saved %u POIs (active=%d, flight=%d, %zu bytes)",
+        (unsigned)count, g_activePoiIndex, g_flightActive ? 1 : 0, s_buffer.size());
+    return true;
+}
+
+static bool Save()
+{
+    // A failed in-place write (file gone, ...) falls back to a full one
+    if (s_saved && PoiStore_Revision() == s_savedRevision && SaveHeader())
+        return true;
+    return SaveFile();
+}
+
+static void OnSaveTimer(void*)
+{
+    s_saveTimer = 0;
+    if (IsDirty())
+        Save();
+}
+
+void TourSnapshot_OnFrame()
+{
+    if (IsDirty() && !Scheduler_IsPending(s_saveTimer))
+        s_saveTimer = Scheduler_Schedule(TOUR_SNAPSHOT_SAVE_DELAY_MS, OnSaveTimer, nullptr);
+}
+
+void TourSnapshot_Flush()
+{
+    Scheduler_Cancel(s_saveTimer);
+    s_saveTimer = 0;
+    if (IsDirty())
+        Save();
+}
+
+// -----------------------------------------------------------------------------
+// Load
+// -----------------------------------------------------------------------------
+
+// Reads the whole file into s_buffer
+static bool ReadFile()
+{
+    FILE* file = std::fopen(TOUR_SNAPSHOT_PATH, "rb");
+    if (!file)
+        return false;
+
+    long size = -1;
+    if (std::fseek(file, 0, SEEK_END) == 0)
+        size = std::ftell(file);
+    bool ok = size >= (long)kHeaderBytes && std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok)
+    {
+        s_buffer.resize((size_t)size);
+        ok = std::fread(s_buffer.data(), 1, s_buffer.size(), file) == s_buffer.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+bool TourSnapshot_Load()
+{
+    if (!ReadFile())
+    {
+        LOG_INFO("TourSnapshot: no snapshot to restore.");
+        return false;
+    }
+
+    const char* p = s_buffer.data();
+    uint32_t version, count, flags, checksum;
+    int32_t active;
+    std::memcpy(&version, p + 8, 4);
+    std::memcpy(&count, p + 12, 4);
+    std::memcpy(&active, p + 16, 4);
+    std::memcpy(&flags, p + 20, 4);
+    std::memcpy(&checksum, p + kChecksumOffset, 4);
+
+    const char* payload = p + kHeaderBytes;
+    bool valid = std::memcmp(p, kSnapshotMagic, sizeof(kSnapshotMagic)) == 0 && version == kSnapshotVersion
+        && (uint64_t)count * kBytesPerPoi == s_buffer.size() - kHeaderBytes;
+    uint32_t payloadHash = valid ? Fnv1a(payload, count * kBytesPerPoi) : 0;
+    if (!valid || Fnv1a(p + kCheckedHeaderOffset, kChecksumOffset - kCheckedHeaderOffset, payloadHash) != checksum)
+    {
+        LOG_WARN("TourSnapshot: %s is not a valid version %u snapshot, ignored.",
+            TOUR_SNAPSHOT_PATH, (unsigned)kSnapshotVersion);
+        return false;
+    }
+
+    const char* lat = payload + count * sizeof(uint32_t);
+    const char* lon = lat + count * sizeof(double);
+    s_loadedIds.resize(count);
+    if (count)
+        std::memcpy(s_loadedIds.data(), payload, count * sizeof(uint32_t));
+    PoiColumns_Clear(s_loadedCoords);
+    PoiColumns_Reserve(s_loadedCoords, count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double la, lo;
+        std::memcpy(&la, lat + i * sizeof(double), sizeof(double));
+        std::memcpy(&lo, lon + i * sizeof(double), sizeof(double));
+        PoiColumns_Append(s_loadedCoords, la, lo);
+    }
+
+    s_changed.clear();
+    PoiStore_Replace(s_loadedCoords, s_loadedIds, s_changed);
+    g_activePoiIndex = active >= -1 && active <= (int32_t)count ? active : -1;
+    g_flightActive = (flags & kFlagFlightActive) && g_activePoiIndex >= 0 && g_activePoiIndex < (int)count;
+    RememberSaved(payloadHash);
+
+    LOG_INFO("TourSnapshot: restored %u POIs (active=%d, flight %s)",
+        (unsigned)count, g_activePoiIndex, g_flightActive ? "active" : "stopped");
+    FlightController_Resume();
+
+    OutboundQueue_Sendf("{\"type\":\"TOUR_RESTORED\",\"count\":%u,\"active\":%d,\"flightActive\":%s}",
+        (unsigned)count, g_activePoiIndex, g_flightActive ? "true" : "false");
+    return true;
+}
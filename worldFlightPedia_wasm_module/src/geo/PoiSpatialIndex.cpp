@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "geo/PoiSpatialIndex.h"
+#include "geo/Geodesy.h"
+#include "core/IdMap.h"
+#include "core/ModuleContext.h"
+#include "core/PoiStore.h"
+
+// -----------------------------------------------------------------------------
+// PoiSpatialIndex
+// - Sparse grid: cell key -> bucket of entries, plus POI id -> cell key
+// - Buckets stay allocated when they empty, so POIs moving between known cells
+//   never allocate
+// - Radius queries visit only the cells overlapping the query's lat/lon
+//   bounding box (or every bucket when the box has more cells than exist)
+// - Nearest queries run radius queries with a doubling radius until at least
+//   k POIs are inside; every POI within the radius is seen, so the k smallest
+//   candidates are exact
+// - Candidates are compared by squared chord length between unit vectors
+// - Callers are not trusted: coordinates are clamped before every cell cast,
+//   and queries from a NaN / out-of-range point or radius find nothing
+// -----------------------------------------------------------------------------
+
+static const double kCellDeg = 0.1;
+static const int kRows = 1800; // 180 / kCellDeg
+static const int kCols = 3600; // 360 / kCellDeg
+
+struct IndexEntry
+{
+    uint32_t id;
+    double x, y, z; // unit vector
+};
+
+static std::vector<std::vector<IndexEntry>> s_buckets; // one per cell ever used
+static IdMap s_bucketByCell;                            // cell key -> index in s_buckets
+static IdMap s_cellById;                                // POI id -> cell key
+static std::vector<char> s_duplicateFlags; // scratch for FindDuplicates
+
+// NaN fails every comparison, so it lands in row / column 0
+static int RowOf(double lat)
+{
+    if (!(lat > -90.0))
+        return 0;
+    if (!(lat < 90.0))
+        return kRows - 1;
+    int row = (int)std::floor((lat + 90.0) / kCellDeg);
+    return row >= kRows ? kRows - 1 : row;
+}
+
+// Query windows reach up to a turn past the range (lon - dLon)
+static int ColOf(double lon)
+{
+    if (!(lon >= -540.0 && lon <= 540.0))
+        return 0;
+    int col = (int)std::floor((lon + 180.0) / kCellDeg) % kCols;
+    return col < 0 ? col + kCols : col;
+}
+
+static uint32_t CellKey(int row, int col)
+{
+    return (uint32_t)row * kCols + (uint32_t)col;
+}
+
+static void ToUnit(double lat, double lon, double* v)
+{
+    double la = lat * GEO_DEG_TO_RAD;
+    double lo = lon * GEO_DEG_TO_RAD;
+    double cl = std::cos(la);
+    v[0] = cl * std::cos(lo);
+    v[1] = cl * std::sin(lo);
+    v[2] = std::sin(la);
+}
+
+static double ChordSqForMeters(double meters)
+{
+    double angle = meters / GEO_MEAN_RADIUS_METERS;
+    if (angle >= GEO_PI)
+        return 4.0;
+    double chord = 2.0 * std::sin(angle * 0.5);
+    return chord * chord;
+}
+
+static double MetersForChordSq(double chordSq)
+{
+    double half = std::sqrt(chordSq) * 0.5;
+    return 2.0 * GEO_MEAN_RADIUS_METERS * std::asin(half > 1.0 ? 1.0 : half);
+}
+
+// Calls visit(entry, chordSq) for every entry within radiusMeters.
+// visit returns false to stop early; the function then returns false as well.
+template <typename Visit>
+static bool ForEachInRadius(double lat, double lon, double radiusMeters, Visit visit)
+{
+    if (!(lat >= -90.0 && lat <= 90.0 && lon >= -180.0 && lon <= 180.0 && radiusMeters >= 0.0))
+        return true;
+
+    double q[3];
+    ToUnit(lat, lon, q);
+    const double limit = ChordSqForMeters(radiusMeters);
+
+    auto scan = [&](const std::vector<IndexEntry>& bucket) {
+        for (size_t i = 0; i < bucket.size(); ++i)
+        {
+            const IndexEntry& e = bucket[i];
+            double dx = e.x - q[0], dy = e.y - q[1], dz = e.z - q[2];
+            double d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= limit && !visit(e, d2))
+                return false;
+        }
+        return true;
+    };
+
+    // Bounding box of the spherical cap in lat/lon
+    double theta = radiusMeters / GEO_MEAN_RADIUS_METERS;
+    double thetaDeg = theta / GEO_DEG_TO_RAD;
+    double latMin = lat - thetaDeg;
+    double latMax = lat + thetaDeg;
+
+    bool allCols = thetaDeg >= 180.0 || latMin <= -90.0 || latMax >= 90.0;
+    double dLonDeg = 180.0;
+    if (!allCols)
+    {
+        double s = std::sin(theta) / std::cos(lat * GEO_DEG_TO_RAD);
+        if (s >= 1.0)
+            allCols = true;
+        else
+            dLonDeg = std::asin(s) / GEO_DEG_TO_RAD;
+    }
+
+    int rowMin = RowOf(latMin < -90.0 ? -90.0 : latMin);
+    int rowMax = RowOf(latMax > 90.0 ? 90.0 : latMax);
+    int cols = allCols ? kCols : (int)std::floor(2.0 * dLonDeg / kCellDeg) + 2;
+    if (cols > kCols)
+        cols = kCols;
+    int colStart = cols == kCols ? 0 : ColOf(lon - dLonDeg);
+
+    // Large windows over a sparse grid: walking the buckets is cheaper
+    size_t windowCells = (size_t)(rowMax - rowMin + 1) * (size_t)cols;
+    if (windowCells >= s_buckets.size())
+    {
+        for (size_t b = 0; b < s_buckets.size(); ++b)
+            if (!scan(s_buckets[b]))
+                return false;
+        return true;
+    }
+
+    for (int row = rowMin; row <= rowMax; ++row)
+    {
+        for (int i = 0; i < cols; ++i)
+        {
+            uint32_t bucket;
+            if (IdMap_Find(s_bucketByCell, CellKey(row, (colStart + i) % kCols), &bucket) && !scan(s_buckets[bucket]))
+                return false;
+        }
+    }
+    return true;
+}
+
+static bool CloserFirst(const PoiHit& a, const PoiHit& b)
+{
+    return a.meters < b.meters;
+}
+
+// Candidates are collected with chord^2 in 'meters'; convert once sorted
+static void FinishHits(std::vector<PoiHit>& hits)
+{
+    for (size_t i = 0; i < hits.size(); ++i)
+        hits[i].meters = MetersForChordSq(hits[i].meters);
+}
+
+void PoiIndex_Clear()
+{
+    s_buckets.clear();
+    IdMap_Clear(s_bucketByCell);
+    IdMap_Clear(s_cellById);
+}
+
+void PoiIndex_Upsert(uint32_t id, double lat, double lon)
+{
+    PoiIndex_Remove(id);
+
+    IndexEntry e;
+    e.id = id;
+    double v[3];
+    ToUnit(lat, lon, v);
+    e.x = v[0];
+    e.y = v[1];
+    e.z = v[2];
+
+    uint32_t key = CellKey(RowOf(lat), ColOf(lon));
+    uint32_t bucket;
+    if (!IdMap_Find(s_bucketByCell, key, &bucket))
+    {
+        bucket = (uint32_t)s_buckets.size();
+        s_buckets.emplace_back();
+        IdMap_Insert(s_bucketByCell, key, bucket);
+    }
+    s_buckets[bucket].push_back(e);
+    IdMap_Set(s_cellById, id, key);
+}
+
+void PoiIndex_Remove(uint32_t id)
+{
+    uint32_t key, bucketIndex;
+    if (!IdMap_Find(s_cellById, id, &key))
+        return;
+
+    if (IdMap_Find(s_bucketByCell, key, &bucketIndex))
+    {
+        std::vector<IndexEntry>& bucket = s_buckets[bucketIndex];
+        for (size_t i = 0; i < bucket.size(); ++i)
+        {
+            if (bucket[i].id == id)
+            {
+                bucket[i] = bucket.back();
+                bucket.pop_back();
+                break;
+            }
+        }
+    }
+    IdMap_Erase(s_cellById, id);
+}
+
+size_t PoiIndex_Size()
+{
+    return s_cellById.size();
+}
+
+void PoiIndex_Nearest(double lat, double lon, size_t k, std::vector<PoiHit>& out)
+{
+    out.clear();
+    if (k == 0 || s_cellById.empty())
+        return;
+
+    auto collect = [&out](const IndexEntry& e, double d2) {
+        PoiHit hit;
+        hit.id = e.id;
+        hit.meters = d2;
+        out.push_back(hit);
+        return true;
+    };
+
+    const double maxRadius = GEO_PI * GEO_MEAN_RADIUS_METERS;
+    double radius = kCellDeg * GEO_DEG_TO_RAD * GEO_MEAN_RADIUS_METERS;
+    for (;;)
+    {
+        out.clear();
+        ForEachInRadius(lat, lon, radius, collect);
+        if (out.size() >= k || radius >= maxRadius)
+            break;
+        radius *= 2.0;
+    }
+
+    if (out.size() > k)
+    {
+        std::partial_sort(out.begin(), out.begin() + k, out.end(), CloserFirst);
+        out.resize(k);
+    }
+    else
+    {
+        std::sort(out.begin(), out.end(), CloserFirst);
+    }
+    FinishHits(out);
+}
+
+void PoiIndex_Radius(double lat, double lon, double radiusMeters, std::vector<PoiHit>& out)
+{
+    out.clear();
+    ForEachInRadius(lat, lon, radiusMeters, [&out](const IndexEntry& e, double d2) {
+        PoiHit hit;
+        hit.id = e.id;
+        hit.meters = d2;
+        out.push_back(hit);
+        return true;
+    });
+    std::sort(out.begin(), out.end(), CloserFirst);
+    FinishHits(out);
+}
+
+bool PoiIndex_AnyWithin(double lat, double lon, double radiusMeters, uint32_t excludeId)
+{
+    // The visitor stops at the first hit, which makes ForEachInRadius return false
+    return !ForEachInRadius(lat, lon, radiusMeters, [excludeId](const IndexEntry& e, double) {
+        return e.id == excludeId;
+    });
+}
+
+void PoiIndex_FindDuplicates(double radiusMeters, std::vector<uint32_t>& duplicates)
+{
+    duplicates.clear();
+    s_duplicateFlags.assign(g_poi_ids.size(), 0);
+
+    for (size_t i = 0; i < g_poi_ids.size(); ++i)
+    {
+        uint32_t id = g_poi_ids[i];
+        ForEachInRadius(g_poi_coords.lat[i], g_poi_coords.lon[i], radiusMeters,
+            [id, i](const IndexEntry& e, double) {
+                if (e.id == id)
+                    return true;
+                int j = PoiStore_IndexOf(e.id);
+                if (j >= 0 && (size_t)j < i && !s_duplicateFlags[j])
+                {
+                    s_duplicateFlags[i] = 1; // close to an earlier kept POI
+                    return false;
+                }
+                return true;
+            });
+
+        if (s_duplicateFlags[i])
+            duplicates.push_back(id);
+    }
+}
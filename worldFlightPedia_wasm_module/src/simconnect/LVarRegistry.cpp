@@ -0,0 +1,117 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "simconnect/LVarRegistry.h"
+#include "MSFS/MSFS_WindowsTypes.h"
+#include <SimConnect.h>
+#include "core/ModuleContext.h"
+#include "core/Constants.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// LVarRegistry
+// - One data definition (DEFINITION_LVAR_WATCH) holds every watched L:Var
+// - SIMCONNECT_PERIOD_SIM_FRAME + FLAG_CHANGED: a button press is seen on the
+//   next frame, and nothing is sent while no value changes
+// - Last values start at -1 so the first sample reports the initial state
+//   (CHANGE fires for every entry, RISING for entries that start on)
+// -----------------------------------------------------------------------------
+
+static const LVarWatch* s_table = nullptr;
+static size_t s_count = 0;
+static std::vector<double> s_lastValues;
+
+static bool IsOn(double value)
+{
+    return value >= 0.5;
+}
+
+static bool EdgeFired(eLVarEdge edge, double previous, double value)
+{
+    switch (edge)
+    {
+    case LVAR_EDGE_CHANGE:  return value != previous;
+    case LVAR_EDGE_RISING:  return !IsOn(previous) && IsOn(value);
+    case LVAR_EDGE_FALLING: return IsOn(previous) && !IsOn(value);
+    }
+    return false;
+}
+
+bool LVarRegistry_Initialize(const LVarWatch* table, size_t count)
+{
+    s_table = table;
+    s_count = count;
+    s_lastValues.assign(count, -1.0);
+
+    if (!g_hSimConnect)
+        return false;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        HRESULT hr = SimConnect_AddToDataDefinition(
+            g_hSimConnect,
+            DEFINITION_LVAR_WATCH,
+            table[i].name,
+            table[i].units,
+            SIMCONNECT_DATATYPE_FLOAT64,
+            0.0f,
+            SIMCONNECT_UNUSED);
+
+        if (hr == S_OK)
+            LOG_INFO("Added %s to the L:Var watch list.", table[i].name);
+        else
+            LOG_ERROR("FAILED to add %s (0x%08X)", table[i].name, (unsigned)hr);
+    }
+
+    HRESULT hrReq = SimConnect_RequestDataOnSimObject(
+        g_hSimConnect,
+        REQUEST_LVAR_WATCH,
+        DEFINITION_LVAR_WATCH,
+        SIMCONNECT_OBJECT_ID_USER,
+        SIMCONNECT_PERIOD_SIM_FRAME,
+        SIMCONNECT_DATA_REQUEST_FLAG_CHANGED,
+        0, 0, 0);
+
+    if (hrReq != S_OK)
+    {
+        LOG_ERROR("FAILED to request the L:Var watch list (0x%08X)", (unsigned)hrReq);
+        return false;
+    }
+
+    LOG_INFO("Watching %zu L:Vars every sim frame (on change).", count);
+    return true;
+}
+
+void LVarRegistry_OnData(const void* data, size_t size)
+{
+    size_t available = size / sizeof(double);
+    size_t count = available < s_count ? available : s_count;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        double value;
+        std::memcpy(&value, (const char*)data + i * sizeof(double), sizeof(double));
+
+        double previous = s_lastValues[i];
+        if (value == previous)
+            continue;
+        s_lastValues[i] = value;
+
+        LOG_INFO("%s changed -> %.0f", s_table[i].name, value);
+        if (EdgeFired(s_table[i].edge, previous, value) && s_table[i].onEdge)
+            s_table[i].onEdge(value);
+    }
+}
+
+bool LVarRegistry_SetLastValue(const char* name, double value)
+{
+    for (size_t i = 0; i < s_count; ++i)
+    {
+        if (std::strcmp(s_table[i].name, name) == 0)
+        {
+            s_lastValues[i] = value;
+            return true;
+        }
+    }
+    return false;
+}
@@ -1,23 +1,58 @@
 #include "simconnect/SimConnectManager.h"
 #include "MSFS/MSFS_WindowsTypes.h"
-#include <simconnect.h>
+#include <SimConnect.h>
 #include "core/ModuleContext.h"
 #include "core/Constants.h"
 #include "dispatch/DispatchHandler.h"
+#include "simconnect/LVarRegistry.h"
+#include "simconnect/Telemetry.h"
+#include "simobjects/SimObjectManager.h"
+#include "flight/FlightController.h"
+#include "core/Log.h"
 
 // -----------------------------------------------------------------------------
 // SimConnect Manager
 // Responsibilities:
 // - Open and close the SimConnect connection
 // - Register system events and input mappings
-// - Define and request SIM/Local variable data definitions (L:VARs)
-// - Install the global dispatch callback (MyDispatchProc)
+// - Define and request SIM/Local variable data definitions (L:VARs, through
+//   the LVarRegistry watch table below)
+// - Register the dispatch routes and install the global dispatch callback
+//   (MyDispatchProc)
 // Notes:
 // - This initialization is intended to run once during module_init.
 // - Many SimConnect APIs are tolerant of repeated AddToDataDefinition calls,
 //   but prefer adding definitions once to avoid ambiguity.
 // -----------------------------------------------------------------------------
 
+// -----------------------------------------------------------------------------
+// L:Var watch table
+// - One row per L:Var: name, units, edge that triggers the callback, callback
+// - Adding an L:Var only needs a row here (and its handler)
+// -----------------------------------------------------------------------------
+
+// L:spawnAllLasersRed -- 1 spawns all markers, 0 removes them
+static void OnSpawnAllLasersChanged(double value)
+{
+    if (value == 1.0) { LOG_INFO("-> Spawning all lasers"); SpawnSimObject(); }
+    else if (value == 0.0) { LOG_INFO("-> Removing all lasers"); RemoveSimObject(); }
+}
+
+// L:WFP_SPAWN_CUBE -- spawn the cube next to the aircraft (cached position)
+static void OnSpawnCubeRaised(double value)
+{
+    LOG_INFO("L:WFP_SPAWN_CUBE triggered -> spawning cube.");
+    SpawnCubeNearAircraft();
+}
+
+static const LVarWatch s_lvarWatches[] =
+{
+    { "L:spawnAllLasersRed", "Bool", LVAR_EDGE_CHANGE, OnSpawnAllLasersChanged },
+    { "L:WFP_StartFlight",   "Bool", LVAR_EDGE_CHANGE, FlightController_OnStartFlight },
+    { "L:WFP_NextPoi",       "Bool", LVAR_EDGE_RISING, FlightController_OnNextPoi },
+    { "L:WFP_SPAWN_CUBE",    "Bool", LVAR_EDGE_RISING, OnSpawnCubeRaised },
+};
+
 bool SimConnectManager_Initialize()
 {
     const char* clientName = "FlightpediaConnect";
@@ -25,12 +60,12 @@ bool SimConnectManager_Initialize()
     if (hr != S_OK)
     {
         // On failure, log the HRESULT and mark handle invalid
-        fprintf(stderr, "[MSFS] SimConnect_Open('%s') failed (HRESULT=0x%08X)\n", clientName, static_cast<unsigned int>(hr));
+        LOG_ERROR("SimConnect_Open('%s') failed (HRESULT=0x%08X)", clientName, static_cast<unsigned int>(hr));
         g_hSimConnect = 0;
         return false;
     }
 
-    fprintf(stderr, "[MSFS] v101 SimConnect connected as '%s'.\n", clientName);
+    LOG_INFO("v101 SimConnect connected as '%s'.", clientName);
 
     // -------------------------------------------------------------------------
     // Subscribe to system-level events (flight lifecycle notifications)
@@ -39,17 +74,22 @@ bool SimConnectManager_Initialize()
     HRESULT hr2;
 
     hr2 = SimConnect_SubscribeToSystemEvent(g_hSimConnect, EVENT_FLIGHT_LOADED, "FlightLoaded");
-    fprintf(stderr, "[MSFS] Subscribed FlightLoaded -> %s (id=%d)\n",
+    LOG_INFO("Subscribed FlightLoaded -> %s (id=%d)",
         hr2 == S_OK ? "OK" : "FAIL", EVENT_FLIGHT_LOADED);
 
     hr2 = SimConnect_SubscribeToSystemEvent(g_hSimConnect, EVENT_SIM_START, "SimStart");
-    fprintf(stderr, "[MSFS] Subscribed SimStart -> %s (id=%d)\n",
+    LOG_INFO("Subscribed SimStart -> %s (id=%d)",
         hr2 == S_OK ? "OK" : "FAIL", EVENT_SIM_START);
 
     hr2 = SimConnect_SubscribeToSystemEvent(g_hSimConnect, EVENT_FLIGHTPLAN_LOADED, "FlightPlanLoaded");
-    fprintf(stderr, "[MSFS] Subscribed FlightPlanLoaded -> %s (id=%d)\n",
+    LOG_INFO("Subscribed FlightPlanLoaded -> %s (id=%d)",
         hr2 == S_OK ? "OK" : "FAIL", EVENT_FLIGHTPLAN_LOADED);
 
+    // Per-frame tick (scheduler timers, marker spawn queue)
+    hr2 = SimConnect_SubscribeToSystemEvent(g_hSimConnect, EVENT_FRAME, "Frame");
+    LOG_INFO("Subscribed Frame -> %s (id=%d)",
+        hr2 == S_OK ? "OK" : "FAIL", EVENT_FRAME);
+
     // -------------------------------------------------------------------------
     // Input mappings and notification groups
     // - Map client event IDs to simulator events
@@ -60,178 +100,86 @@ bool SimConnectManager_Initialize()
 
     // Map and bind 'M' key
     hr3 = SimConnect_MapClientEventToSimEvent(g_hSimConnect, EVENT_TRIGGER_M, "Flightpedia.M");
-    fprintf(stderr, "[MSFS] MapClientEventToSimEvent EVENT_TRIGGER_M -> %s\n",
+    LOG_INFO("MapClientEventToSimEvent EVENT_TRIGGER_M -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     hr3 = SimConnect_MapInputEventToClientEvent(g_hSimConnect, INPUT_GROUP, "M", EVENT_TRIGGER_M);
-    fprintf(stderr, "[MSFS] MapInputEventToClientEvent 'M' -> %s\n",
+    LOG_INFO("MapInputEventToClientEvent 'M' -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     // Map and bind 'N' key
     hr3 = SimConnect_MapClientEventToSimEvent(g_hSimConnect, EVENT_TRIGGER_N, "Flightpedia.N");
-    fprintf(stderr, "[MSFS] MapClientEventToSimEvent EVENT_TRIGGER_N -> %s\n",
+    LOG_INFO("MapClientEventToSimEvent EVENT_TRIGGER_N -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     hr3 = SimConnect_MapInputEventToClientEvent(g_hSimConnect, INPUT_GROUP, "N", EVENT_TRIGGER_N);
-    fprintf(stderr, "[MSFS] MapInputEventToClientEvent 'N' -> %s\n",
+    LOG_INFO("MapInputEventToClientEvent 'N' -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     // Add both events to the input notification group and enable it
     hr3 = SimConnect_AddClientEventToNotificationGroup(g_hSimConnect, GROUP_INPUT, EVENT_TRIGGER_M);
-    fprintf(stderr, "[MSFS] AddClientEventToNotificationGroup EVENT_TRIGGER_M -> %s\n",
+    LOG_INFO("AddClientEventToNotificationGroup EVENT_TRIGGER_M -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     hr3 = SimConnect_AddClientEventToNotificationGroup(g_hSimConnect, GROUP_INPUT, EVENT_TRIGGER_N);
-    fprintf(stderr, "[MSFS] AddClientEventToNotificationGroup EVENT_TRIGGER_N -> %s\n",
+    LOG_INFO("AddClientEventToNotificationGroup EVENT_TRIGGER_N -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     hr3 = SimConnect_SetNotificationGroupPriority(g_hSimConnect, GROUP_INPUT, SIMCONNECT_GROUP_PRIORITY_HIGHEST);
-    fprintf(stderr, "[MSFS] SetNotificationGroupPriority GROUP_INPUT -> %s\n",
+    LOG_INFO("SetNotificationGroupPriority GROUP_INPUT -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     hr3 = SimConnect_SetInputGroupState(g_hSimConnect, INPUT_GROUP, SIMCONNECT_STATE_ON);
-    fprintf(stderr, "[MSFS] SetInputGroupState INPUT_GROUP ON -> %s\n",
+    LOG_INFO("SetInputGroupState INPUT_GROUP ON -> %s",
         hr3 == S_OK ? "OK" : "FAIL");
 
     // -------------------------------------------------------------------------
-    // Local variables (L:Var) data definitions and requests
-    // - AddToDataDefinition binds a definition id to a simulator variable name
-    // - RequestDataOnSimObject requests periodic or on-change updates for that definition
+    // Local variables (L:Var) watch list (see s_lvarWatches above)
+    // -------------------------------------------------------------------------
+    LVarRegistry_Initialize(s_lvarWatches, sizeof(s_lvarWatches) / sizeof(s_lvarWatches[0]));
+
+    // -------------------------------------------------------------------------
+    // Marker position (set-only): used to move pooled laser_red objects
     // -------------------------------------------------------------------------
     HRESULT hrDef;
-    HRESULT hrReq;
-
-    // L:spawnAllLasersRed -- toggles spawning of laser objects
-    hrDef = SimConnect_AddToDataDefinition(
-        g_hSimConnect,
-        DEFINITION_LVAR_SPAWN,
-        "L:spawnAllLasersRed",
-        "Bool",
-        SIMCONNECT_DATATYPE_FLOAT64,
-        0.0f,
-        SIMCONNECT_UNUSED);
-
-    if (hrDef == S_OK)
-        fprintf(stderr, "[MSFS] Added L:spawnAllLasersRed to data definition.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to add L:spawnAllLasersRed (0x%08X)\n", (unsigned)hrDef);
-
-    // Request this L:Var every second
-    hrReq = SimConnect_RequestDataOnSimObject(
-        g_hSimConnect,
-        REQUEST_LVAR_SPAWN,
-        DEFINITION_LVAR_SPAWN,
-        SIMCONNECT_OBJECT_ID_USER,
-        SIMCONNECT_PERIOD_SECOND,
-        SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT,
-        0, 0, 0);
-
-    if (hrReq == S_OK)
-        fprintf(stderr, "[MSFS] Started monitoring L:spawnAllLasersRed every second.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to request L:spawnAllLasersRed (0x%08X)\n", (unsigned)hrReq);
-
-    // L:WFP_StartFlight -- start/stop automated POI flight
-    hrDef = SimConnect_AddToDataDefinition(
-        g_hSimConnect,
-        DEFINITION_LVAR_STARTFLIGHT,
-        "L:WFP_StartFlight",
-        "Bool",
-        SIMCONNECT_DATATYPE_FLOAT64,
-        0.0f,
-        SIMCONNECT_UNUSED);
-
-    if (hrDef == S_OK)
-        fprintf(stderr, "[MSFS] Added L:WFP_StartFlight to data definition.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to add L:WFP_StartFlight (0x%08X)\n", (unsigned)hrDef);
-
-    hrReq = SimConnect_RequestDataOnSimObject(
-        g_hSimConnect,
-        REQUEST_LVAR_STARTFLIGHT,
-        DEFINITION_LVAR_STARTFLIGHT,
-        SIMCONNECT_OBJECT_ID_USER,
-        SIMCONNECT_PERIOD_SECOND,
-        SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT,
-        0, 0, 0);
-
-    if (hrReq == S_OK)
-        fprintf(stderr, "[MSFS] Started monitoring L:WFP_StartFlight every second.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to request L:WFP_StartFlight (0x%08X)\n", (unsigned)hrReq);
-
-    // L:WFP_NextPoi -- advance to next POI in sequence
-    hrDef = SimConnect_AddToDataDefinition(
-        g_hSimConnect,
-        DEFINITION_LVAR_NEXTPOI,
-        "L:WFP_NextPoi",
-        "Bool",
-        SIMCONNECT_DATATYPE_FLOAT64,
-        0.0f,
-        SIMCONNECT_UNUSED);
-
-    if (hrDef == S_OK)
-        fprintf(stderr, "[MSFS] Added L:WFP_NextPoi to data definition.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to add L:WFP_NextPoi (0x%08X)\n", (unsigned)hrDef);
-
-    hrReq = SimConnect_RequestDataOnSimObject(
-        g_hSimConnect,
-        REQUEST_LVAR_NEXTPOI,
-        DEFINITION_LVAR_NEXTPOI,
-        SIMCONNECT_OBJECT_ID_USER,
-        SIMCONNECT_PERIOD_SECOND,
-        SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT,
-        0, 0, 0);
-
-    if (hrReq == S_OK)
-        fprintf(stderr, "[MSFS] Started monitoring L:WFP_NextPoi every second.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to request L:WFP_NextPoi (0x%08X)\n", (unsigned)hrReq);
-
-    // ---- L:WFP_SPAWN_CUBE ----
-    hrDef = SimConnect_AddToDataDefinition(
-        g_hSimConnect,
-        DEFINITION_LVAR_SPAWN_CUBE,
-        "L:WFP_SPAWN_CUBE",
-        "Bool",
-        SIMCONNECT_DATATYPE_FLOAT64,
-        0.0f,
-        SIMCONNECT_UNUSED);
-
-    if (hrDef == S_OK)
-        fprintf(stderr, "[MSFS] Added L:WFP_SPAWN_CUBE to data definition.\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to add L:WFP_SPAWN_CUBE (0x%08X)\n", (unsigned)hrDef);
-
-    hrReq = SimConnect_RequestDataOnSimObject(
-        g_hSimConnect,
-        REQUEST_LVAR_SPAWN_CUBE,
-        DEFINITION_LVAR_SPAWN_CUBE,
-        SIMCONNECT_OBJECT_ID_USER,
-        SIMCONNECT_PERIOD_SECOND,
-        SIMCONNECT_DATA_REQUEST_FLAG_CHANGED,
-        0, 0, 0);
-
-    if (hrReq == S_OK)
-        fprintf(stderr, "[MSFS] Started monitoring L:WFP_SPAWN_CUBE (on change).\n");
-    else
-        fprintf(stderr, "[MSFS] FAILED to request L:WFP_SPAWN_CUBE (0x%08X)\n", (unsigned)hrReq);
+
+    SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_MARKER_POSITION, "PLANE LATITUDE", "degrees");
+    SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_MARKER_POSITION, "PLANE LONGITUDE", "degrees");
+    hrDef = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_MARKER_POSITION, "PLANE ALT ABOVE GROUND", "meters");
+    if (hrDef != S_OK)
+        LOG_ERROR("FAILED to add marker position definition (0x%08X)", (unsigned)hrDef);
+
+    // Emitter cube position (see simobjects/EmitterFollow.h), set only
+    SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_EMITTER_POSITION, "PLANE LATITUDE", "degrees");
+    SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_EMITTER_POSITION, "PLANE LONGITUDE", "degrees");
+    hrDef = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_EMITTER_POSITION, "PLANE ALTITUDE", "meters");
+    if (hrDef != S_OK)
+        LOG_ERROR("FAILED to add emitter position definition (0x%08X)", (unsigned)hrDef);
+
+    // -------------------------------------------------------------------------
+    // User aircraft state (see simconnect/Telemetry.h)
+    // - Sampled every sim frame it changes, so arrivals are detected without
+    //   delay; geofences, marker streaming, the tour optimizer and cube spawns
+    //   all read the same cache
+    // -------------------------------------------------------------------------
+    Telemetry_Initialize();
 
 
     // -------------------------------------------------------------------------
     // Initial dispatch
+    // - Handlers are registered first (see DispatchHandler_Initialize)
     // - CallDispatch will cause the provided callback to be invoked for pending messages
     // -------------------------------------------------------------------------
+    DispatchHandler_Initialize();
     HRESULT hrDispatch = SimConnect_CallDispatch(g_hSimConnect, MyDispatchProc, nullptr);
     if (hrDispatch != S_OK)
     {
-        fprintf(stderr, "[MSFS] SimConnect_CallDispatch on INIT returned 0x%08X\n",
+        LOG_WARN("SimConnect_CallDispatch on INIT returned 0x%08X",
             (unsigned)hrDispatch);
     }
     else
     {
-        fprintf(stderr, "[MSFS] SimConnect_CallDispatch on INIT\n");
+        LOG_INFO("SimConnect_CallDispatch on INIT");
     }
 
     return true;
@@ -248,6 +196,6 @@ void SimConnectManager_Shutdown()
         SimConnect_Close(g_hSimConnect);
         g_hSimConnect = 0;
 
-        fprintf(stderr, "[MSFS] SimConnect shutdown completed (via SimConnectManager).\n");
+        LOG_INFO("SimConnect shutdown completed (via SimConnectManager).");
     }
 }
@@ -0,0 +1,101 @@
+#include <cstring>
+#include "simconnect/Telemetry.h"
+#include "MSFS/MSFS_WindowsTypes.h"
+#include <SimConnect.h>
+#include "core/ModuleContext.h"
+#include "core/Constants.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+
+// -----------------------------------------------------------------------------
+// Telemetry
+// - DEFINITION_USER_STATE is built from s_simVars, one FLOAT64 per entry in
+//   table order, and is never extended again
+// - SIMCONNECT_PERIOD_SIM_FRAME + FLAG_CHANGED: every frame in which the
+//   aircraft moves delivers one sample, a parked aircraft delivers none
+// -----------------------------------------------------------------------------
+
+struct TelemetryVar
+{
+    const char* name;
+    const char* units;
+};
+
+// Order matches the double fields of AircraftState
+static const TelemetryVar s_simVars[] =
+{
+    { "PLANE LATITUDE",             "degrees" },
+    { "PLANE LONGITUDE",            "degrees" },
+    { "PLANE ALTITUDE",             "meters" },
+    { "PLANE ALT ABOVE GROUND",     "meters" },
+    { "PLANE HEADING DEGREES TRUE", "degrees" },
+    { "GROUND VELOCITY",            "meters per second" },
+    { "GPS GROUND TRUE TRACK",      "degrees" },
+    { "VERTICAL SPEED",             "meters per second" },
+};
+
+static const size_t kVarCount = sizeof(s_simVars) / sizeof(s_simVars[0]);
+static_assert(kVarCount * sizeof(double) == offsetof(AircraftState, sampleMs),
+    "s_simVars must list one sim var per double of AircraftState");
+
+static AircraftState s_state = {};
+static bool s_valid = false;
+
+bool Telemetry_Initialize()
+{
+    s_valid = false;
+    if (!g_hSimConnect)
+        return false;
+
+    bool ok = true;
+    for (size_t i = 0; i < kVarCount; ++i)
+    {
+        HRESULT hr = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_USER_STATE,
+            s_simVars[i].name, s_simVars[i].units, SIMCONNECT_DATATYPE_FLOAT64, 0.0f, SIMCONNECT_UNUSED);
+        if (hr != S_OK)
+        {
+            LOG_ERROR("FAILED to add %s to the user state (0x%08X)", s_simVars[i].name, (unsigned)hr);
+            ok = false;
+        }
+    }
+
+    HRESULT hrReq = SimConnect_RequestDataOnSimObject(
+        g_hSimConnect,
+        REQUEST_USER_STATE,
+        DEFINITION_USER_STATE,
+        SIMCONNECT_OBJECT_ID_USER,
+        SIMCONNECT_PERIOD_SIM_FRAME,
+        SIMCONNECT_DATA_REQUEST_FLAG_CHANGED,
+        0, 0, 0);
+
+    if (hrReq != S_OK)
+    {
+        LOG_ERROR("FAILED to request the user state (0x%08X)", (unsigned)hrReq);
+        return false;
+    }
+
+    LOG_INFO("Watching the user state (%zu sim vars) every sim frame (on change).", kVarCount);
+    return ok;
+}
+
+bool Telemetry_OnData(const void* data, size_t size)
+{
+    if (size < kVarCount * sizeof(double))
+    {
+        LOG_WARN("Ignored user state sample of %zu bytes", size);
+        return false;
+    }
+
+    std::memcpy(&s_state, data, kVarCount * sizeof(double));
+    s_state.sampleMs = Scheduler_NowMs();
+    s_valid = true;
+    return true;
+}
+
+bool Telemetry_Get(AircraftState* state)
+{
+    if (!s_valid)
+        return false;
+    *state = s_state;
+    return true;
+}
@@ -0,0 +1,185 @@
+#include <cmath>
+#include "simobjects/EmitterFollow.h"
+#include <SimConnect.h>
+#include "core/ModuleContext.h"
+#include "core/Constants.h"
+#include "core/Metrics.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+#include "simconnect/Telemetry.h"
+#include "geo/Geodesy.h"
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+
+// -----------------------------------------------------------------------------
+// Emitter follow
+// - The cube does not move on its own: between updates it stays where it was
+//   last put, so its drift is the distance from there to the target
+// - Target: the aircraft position extrapolated from the last sample to this
+//   frame, plus the offset to the right of the nose
+// - An update puts the cube EMITTER_FOLLOW_LEAD * tolerance ahead of the
+//   target along the velocity: the drift first shrinks as the aircraft
+//   catches up, then grows to the tolerance behind it, so a straight path
+//   needs about half the updates of placing it on the target
+// - Offsets and drift go through the local east / north / up frame of
+//   geo/Geodesy.h (GEO_FAST: the sphere is plenty for meters)
+// -----------------------------------------------------------------------------
+
+// Layout of DEFINITION_EMITTER_POSITION
+struct EmitterPosition
+{
+    double latitude;
+    double longitude;
+    double altitude; // meters above mean sea level
+};
+
+static bool s_enabled = EMITTER_FOLLOW_ENABLED;
+static double s_tolerance = EMITTER_FOLLOW_TOLERANCE_METERS;
+
+static double s_rightMeters = 0.0;
+static DWORD s_objectId = SIMCONNECT_OBJECT_ID_USER; // no cube to follow
+static bool s_placed = false;                        // s_position holds the last position sent
+static EmitterPosition s_position;
+
+static uint64_t s_frames = 0;
+static uint64_t s_updates = 0;
+static uint64_t s_statsStartMs = 0;
+
+// Target 'aheadSec' after the current frame
+static void Predict(const AircraftState& aircraft, double aheadSec, EmitterPosition* out)
+{
+    uint64_t nowMs = Scheduler_NowMs();
+    uint64_t ageMs = nowMs > aircraft.sampleMs ? nowMs - aircraft.sampleMs : 0;
+    if (ageMs > EMITTER_EXTRAPOLATE_MAX_MS)
+        ageMs = EMITTER_EXTRAPOLATE_MAX_MS;
+    double t = ageMs / 1000.0 + aheadSec;
+
+    double track = aircraft.trackTrueDeg * GEO_DEG_TO_RAD;
+    double heading = aircraft.headingTrueDeg * GEO_DEG_TO_RAD;
+    GeoEnu offset;
+    offset.east = std::sin(track) * aircraft.groundSpeedMps * t + std::cos(heading) * s_rightMeters;
+    offset.north = std::cos(track) * aircraft.groundSpeedMps * t - std::sin(heading) * s_rightMeters;
+    offset.up = aircraft.verticalSpeedMps * t;
+
+    GeoPosition origin = { aircraft.latDeg, aircraft.lonDeg, aircraft.altMeters };
+    GeoPosition p = Geo_EnuToGeodetic(origin, offset, GEO_FAST);
+    out->latitude = p.latDeg;
+    out->longitude = p.lonDeg;
+    out->altitude = p.altMeters;
+}
+
+static double Distance(const EmitterPosition& a, const EmitterPosition& b)
+{
+    GeoPosition from = { a.latitude, a.longitude, a.altitude };
+    GeoPosition to = { b.latitude, b.longitude, b.altitude };
+    GeoEnu d = Geo_GeodeticToEnu(from, to, GEO_FAST);
+    return std::sqrt(d.east * d.east + d.north * d.north + d.up * d.up);
+}
+
+void EmitterFollow_OnCubeSpawned(double rightMeters)
+{
+    s_rightMeters = rightMeters;
+    s_objectId = SIMCONNECT_OBJECT_ID_USER;
+    s_placed = false;
+}
+
+void EmitterFollow_OnCubeAssigned(DWORD objectId)
+{
+    s_objectId = objectId;
+    s_placed = false; // moved on the next frame, the spawn position is already stale
+    EmitterFollow_ResetStats();
+    LOG_INFO("Emitter cube id=%u follows the aircraft (%s, tolerance=%.1fm)",
+        (unsigned)objectId, s_enabled ? "on" : "off", s_tolerance);
+}
+
+void EmitterFollow_OnFrame()
+{
+    AircraftState aircraft;
+    if (!s_enabled || !g_hSimConnect || s_objectId == SIMCONNECT_OBJECT_ID_USER || !Telemetry_Get(&aircraft))
+        return;
+
+    s_frames++;
+    Metrics_Count(METRIC_EMITTER_FRAMES);
+
+    EmitterPosition target;
+    Predict(aircraft, 0.0, &target);
+    if (s_placed && Distance(s_position, target) <= s_tolerance)
+        return;
+
+    double speed = std::sqrt(aircraft.groundSpeedMps * aircraft.groundSpeedMps +
+        aircraft.verticalSpeedMps * aircraft.verticalSpeedMps);
+    if (speed > 0.0)
+        Predict(aircraft, EMITTER_FOLLOW_LEAD * s_tolerance / speed, &target);
+
+    HRESULT hr = SimConnect_SetDataOnSimObject(g_hSimConnect, DEFINITION_EMITTER_POSITION, s_objectId,
+        SIMCONNECT_DATA_SET_FLAG_DEFAULT, 0, sizeof(target), &target);
+    if (hr != S_OK)
+    {
+        // Tried again next frame
+        Metrics_Count(METRIC_FAILURES);
+        return;
+    }
+
+    s_position = target;
+    s_placed = true;
+    s_updates++;
+    Metrics_Count(METRIC_EMITTER_UPDATES);
+}
+
+void EmitterFollow_SetConfig(const EmitterFollowConfig& config)
+{
+    s_enabled = config.enabled;
+    s_tolerance = config.toleranceMeters > 0.0 ? config.toleranceMeters : EMITTER_FOLLOW_TOLERANCE_METERS;
+    s_placed = false;
+    LOG_INFO("Emitter follow %s (tolerance=%.2fm)", s_enabled ? "enabled" : "disabled", s_tolerance);
+}
+
+EmitterFollowConfig EmitterFollow_GetConfig()
+{
+    EmitterFollowConfig config;
+    config.enabled = s_enabled;
+    config.toleranceMeters = s_tolerance;
+    return config;
+}
+
+void EmitterFollow_GetStats(EmitterFollowStats* stats)
+{
+    stats->frames = s_frames;
+    stats->updates = s_updates;
+    stats->windowMs = Scheduler_NowMs() - s_statsStartMs;
+}
+
+void EmitterFollow_ResetStats()
+{
+    s_frames = 0;
+    s_updates = 0;
+    s_statsStartMs = Scheduler_NowMs();
+}
+
+bool EmitterFollow_OnMessage(PoiParseResult& msg)
+{
+    EmitterFollowConfig config = EmitterFollow_GetConfig();
+    bool hasEnabled = Param_Bool(msg, "enabled", &config.enabled);
+    bool hasTolerance = Param_Double(msg, "tolerance", &config.toleranceMeters);
+    bool reset = false;
+    Param_Bool(msg, "reset", &reset);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    // A report-only message must not re-place the cube
+    if (hasEnabled || hasTolerance)
+        EmitterFollow_SetConfig(config);
+
+    // Updates per second against the frames per second a per-frame follow would send
+    EmitterFollowStats stats;
+    EmitterFollow_GetStats(&stats);
+    double seconds = stats.windowMs > 0 ? stats.windowMs / 1000.0 : 1.0;
+    OutboundQueue_Sendf(
+        "ack: EMITTER_FOLLOW enabled=%d tolerance=%.2f updates=%llu frames=%llu updatesPerSec=%.1f framesPerSec=%.1f windowMs=%llu",
+        s_enabled ? 1 : 0, s_tolerance, (unsigned long long)stats.updates, (unsigned long long)stats.frames,
+        stats.updates / seconds, stats.frames / seconds, (unsigned long long)stats.windowMs);
+
+    if (reset)
+        EmitterFollow_ResetStats();
+    return true;
+}
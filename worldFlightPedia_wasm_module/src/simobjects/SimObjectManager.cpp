@@ -1,39 +1,898 @@
 ﻿#include "simobjects/SimObjectManager.h"
 #include "core/ModuleContext.h"
 #include "core/Constants.h"
+#include "core/PoiStore.h"
+#include "geo/PoiSpatialIndex.h"
+#include "geo/Geodesy.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
+#include "simconnect/Telemetry.h"
+#include "simobjects/EmitterFollow.h"
+#include "comm/MessageParser.h"
+#include "comm/OutboundQueue.h"
+#include "core/IdMap.h"
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdint>
+#include <iterator>
 #include <vector>
 #include <MSFS/MSFS.h>
 #include <SimConnect.h>
-#include <cmath>
+
+// -----------------------------------------------------------------------------
+// Per-POI marker bookkeeping
+// - Every laser_red marker belongs to one POI id and is created with its own
+//   request id (g_spawnReqBase + n) so the assigned object id can be tied back.
+// - Reconciliation compares a POI's wanted state with its marker and only
+//   touches SimConnect when they differ.
+// - Creates are not issued directly: markers are queued and the frame tick
+//   submits at most s_spawnPerFrame of them, with at most s_spawnMaxInFlight
+//   creates awaiting their object id at any time.
+// - Failed creates (rejected, exception, or no answer within
+//   MARKER_SPAWN_TIMEOUT_MS) are retried on a scheduler timer with a growing
+//   delay, up to MARKER_SPAWN_MAX_ATTEMPTS submissions.
+// - Released live objects go to a small pool and are moved to the next marker
+//   with SetDataOnSimObject instead of remove + create. A pooled object still
+//   shows at its old spot, so whatever the queue has not claimed by the end of
+//   the frame tick is removed.
+// - Lookahead markers (the next POIs of a flight) are parked below the terrain
+//   until their POI becomes active; then the object is raised in place. Their
+//   creates wait in a separate queue that is only served on frames without
+//   other creates.
+// - Markers, pending creates, the queues and the resident set live in vectors
+//   indexed through IdMaps and keep their capacity, so once they have grown to
+//   the working set, reconciling and streaming no longer allocate.
+// -----------------------------------------------------------------------------
+struct PoiMarker
+{
+    uint32_t poiId;
+    eMarkerState state; // MARKER_NONE marks a free slot
+    bool parked;     // object is (or, once created, will be) parked below the terrain
+    DWORD requestId; // spawn request that created (or is creating) the object
+    DWORD objectId;  // SIMCONNECT_OBJECT_ID_USER until the sim assigns one
+    double lat;      // position the marker was spawned at
+    double lon;
+    uint32_t attempts;  // creates submitted for this position
+    TimerHandle retry;  // pending retry after a failure, 0 if none
+};
+
+// A create submitted to SimConnect and not yet answered
+struct PendingCreate
+{
+    DWORD requestId;
+    uint32_t poiId;
+    DWORD sendId;        // packet id, matches SIMCONNECT_RECV_EXCEPTION::dwSendID
+    TimerHandle timeout; // gives up on the create after MARKER_SPAWN_TIMEOUT_MS
+};
+
+// FIFO of POI ids; the vector is compacted in place instead of shrinking
+struct PoiIdQueue
+{
+    std::vector<uint32_t> ids;
+    size_t head; // next id to pop
+};
+
+static std::vector<PoiMarker> s_markers;            // slots, MARKER_NONE when free
+static std::vector<uint32_t> s_freeMarkerSlots;     // indices of free slots in s_markers
+static IdMap s_markerSlotById;                      // POI id -> slot in s_markers
+static std::vector<PendingCreate> s_markerRequests; // in-flight spawn requests
+static IdMap s_requestSlotById;                     // spawn request -> index in s_markerRequests
+static PoiIdQueue s_spawnQueue = {};                // POI ids waiting for a create slot
+static PoiIdQueue s_lookaheadQueue = {};            // parked markers waiting for an idle frame
+static std::vector<uint32_t> s_lookahead;           // POI ids that keep a parked marker
+static std::vector<uint32_t> s_lookaheadBefore;     // scratch for SetLookahead
+static DWORD s_nextMarkerRequest = 0;
+static bool s_showAllMarkers = false;               // set by SpawnSimObject, cleared by RemoveSimObject
+
+static uint32_t s_spawnPerFrame = MARKER_SPAWN_PER_FRAME;
+static uint32_t s_spawnMaxInFlight = MARKER_SPAWN_MAX_IN_FLIGHT;
+
+static std::vector<DWORD> s_freeMarkers; // live laser_red objects not bound to a POI
+
+static PoiMarker* FindMarker(uint32_t poiId)
+{
+    uint32_t slot;
+    return IdMap_Find(s_markerSlotById, poiId, &slot) ? &s_markers[slot] : nullptr;
+}
+
+// Returns the POI's marker, adding a blank one (state MARKER_QUEUED) in a free slot if needed
+static PoiMarker& AddMarker(uint32_t poiId)
+{
+    PoiMarker* found = FindMarker(poiId);
+    if (found)
+        return *found;
+
+    uint32_t slot;
+    if (!s_freeMarkerSlots.empty())
+    {
+        slot = s_freeMarkerSlots.back();
+        s_freeMarkerSlots.pop_back();
+    }
+    else
+    {
+        slot = (uint32_t)s_markers.size();
+        s_markers.push_back(PoiMarker());
+    }
+    IdMap_Insert(s_markerSlotById, poiId, slot);
+
+    PoiMarker& marker = s_markers[slot];
+    marker = PoiMarker();
+    marker.poiId = poiId;
+    marker.state = MARKER_QUEUED;
+    return marker;
+}
+
+static void EraseMarker(uint32_t poiId)
+{
+    uint32_t slot;
+    if (!IdMap_Find(s_markerSlotById, poiId, &slot))
+        return;
+    IdMap_Erase(s_markerSlotById, poiId);
+    s_markers[slot].state = MARKER_NONE;
+    s_freeMarkerSlots.push_back(slot);
+}
+
+static void ClearMarkers()
+{
+    s_markers.clear();
+    s_freeMarkerSlots.clear();
+    IdMap_Clear(s_markerSlotById);
+}
+
+static PendingCreate* FindRequest(DWORD requestId)
+{
+    uint32_t index;
+    return IdMap_Find(s_requestSlotById, requestId, &index) ? &s_markerRequests[index] : nullptr;
+}
+
+static void AddRequest(const PendingCreate& pending)
+{
+    IdMap_Set(s_requestSlotById, pending.requestId, (uint32_t)s_markerRequests.size());
+    s_markerRequests.push_back(pending);
+}
+
+// Swap-removes the request; pointers into s_markerRequests are stale afterwards
+static void EraseRequest(DWORD requestId)
+{
+    uint32_t index;
+    if (!IdMap_Find(s_requestSlotById, requestId, &index))
+        return;
+    IdMap_Erase(s_requestSlotById, requestId);
+    if (index + 1 != s_markerRequests.size())
+    {
+        s_markerRequests[index] = s_markerRequests.back();
+        IdMap_Set(s_requestSlotById, s_markerRequests[index].requestId, index);
+    }
+    s_markerRequests.pop_back();
+}
+
+static bool Queue_Empty(const PoiIdQueue& queue)
+{
+    return queue.head == queue.ids.size();
+}
+
+static void Queue_Push(PoiIdQueue& queue, uint32_t poiId)
+{
+    if (Queue_Empty(queue))
+    {
+        queue.ids.clear();
+        queue.head = 0;
+    }
+    else if (queue.head != 0 && queue.ids.size() == queue.ids.capacity())
+    {
+        // Full: drop the popped front rather than let the vector grow
+        queue.ids.erase(queue.ids.begin(), queue.ids.begin() + queue.head);
+        queue.head = 0;
+    }
+    queue.ids.push_back(poiId);
+}
+
+static uint32_t Queue_Pop(PoiIdQueue& queue)
+{
+    return queue.ids[queue.head++];
+}
+
+static void Queue_Clear(PoiIdQueue& queue)
+{
+    queue.ids.clear();
+    queue.head = 0;
+}
+
+// Layout of DEFINITION_MARKER_POSITION
+struct MarkerPosition
+{
+    double latitude;
+    double longitude;
+    double altAboveGround; // meters
+};
+
+// -----------------------------------------------------------------------------
+// Marker latency probe
+// - Armed by the flight controller for the POI it just made active
+// - Reports the time until that POI's marker is visible: object id assigned
+//   (create) or SetDataOnSimObject issued (pool reuse)
+// -----------------------------------------------------------------------------
+enum eMarkerPath { MARKER_PATH_CREATE = 0, MARKER_PATH_REUSE = 1, MARKER_PATH_LOOKAHEAD = 2 };
+
+struct LatencyStats
+{
+    unsigned count;
+    double totalMs;
+    double maxMs;
+};
+
+static bool s_latencyArmed = false;
+static uint32_t s_latencyPoi = 0;
+static std::chrono::steady_clock::time_point s_latencyStart;
+static LatencyStats s_latencyStats[3] = {};
+static const char* const kMarkerPathNames[3] = { "created", "reused", "lookahead" };
+
+static void OnMarkerVisible(uint32_t poiId, eMarkerPath path)
+{
+    if (!s_latencyArmed || poiId != s_latencyPoi)
+        return;
+    s_latencyArmed = false;
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_latencyStart).count();
+    LatencyStats& stats = s_latencyStats[path];
+    stats.count++;
+    stats.totalMs += ms;
+    if (ms > stats.maxMs)
+        stats.maxMs = ms;
+
+    LOG_DEBUG("Marker visible for POI id=%u after %.2f ms (%s; n=%u avg=%.2f max=%.2f)",
+        (unsigned)poiId, ms, kMarkerPathNames[path],
+        stats.count, stats.totalMs / stats.count, stats.maxMs);
+}
+
+// -----------------------------------------------------------------------------
+// Visibility-radius streaming (show-all mode)
+// - Only POIs near the aircraft are resident instead of one marker per POI
+// - A POI joins the resident set inside the radius and leaves it beyond
+//   radius * MARKER_STREAM_HYSTERESIS, so markers near the edge do not flicker
+// - The budget caps the resident set; the closest qualifying POIs win
+// - Recomputed on every user position sample; only POIs entering or leaving
+//   the set are reconciled
+// -----------------------------------------------------------------------------
+static bool s_streamEnabled = true;
+static double s_streamRadius = MARKER_STREAM_RADIUS_METERS;
+static uint32_t s_streamBudget = MARKER_STREAM_BUDGET;
+static uint64_t s_lastStreamUpdateMs = 0;
+static std::vector<uint32_t> s_resident;     // POI ids inside the streaming window, sorted
+static std::vector<uint32_t> s_nextResident; // scratch, keeps its capacity
+static std::vector<PoiHit> s_streamHits;
+static std::vector<uint32_t> s_streamEntered;
+static std::vector<uint32_t> s_streamLeft;
+
+enum eMarkerPlacement
+{
+    PLACEMENT_NONE = 0, // no marker
+    PLACEMENT_SHOWN,    // on the terrain at the POI
+    PLACEMENT_PARKED    // at the POI, below the terrain (lookahead)
+};
+
+static bool IsResident(uint32_t poiId)
+{
+    return std::binary_search(s_resident.begin(), s_resident.end(), poiId);
+}
+
+static bool IsLookahead(uint32_t poiId)
+{
+    return std::find(s_lookahead.begin(), s_lookahead.end(), poiId) != s_lookahead.end();
+}
+
+static eMarkerPlacement WantedPlacement(uint32_t poiId, int poiIndex)
+{
+    if (poiIndex < 0)
+        return PLACEMENT_NONE;
+    if (g_flightActive && poiIndex == g_activePoiIndex)
+        return PLACEMENT_SHOWN;
+    if (s_showAllMarkers && (!s_streamEnabled || IsResident(poiId)))
+        return PLACEMENT_SHOWN;
+    return IsLookahead(poiId) ? PLACEMENT_PARKED : PLACEMENT_NONE;
+}
+
+static bool MoveObject(DWORD objectId, double lat, double lon, bool parked)
+{
+    MarkerPosition pos;
+    pos.latitude = lat;
+    pos.longitude = lon;
+    // On the terrain, as when spawned with OnGround=1, or out of sight below it
+    pos.altAboveGround = parked ? MARKER_PARK_ALT_AGL_METERS : 0.0;
+
+    HRESULT hr = SimConnect_SetDataOnSimObject(g_hSimConnect, DEFINITION_MARKER_POSITION, objectId,
+        SIMCONNECT_DATA_SET_FLAG_DEFAULT, 0, sizeof(pos), &pos);
+    return hr == S_OK;
+}
+
+static void RemoveObjectId(DWORD objectId);
+
+// Bind a pooled object to the marker. Returns false when the pool is empty.
+static bool TakeFromPool(uint32_t poiId, PoiMarker& marker)
+{
+    while (!s_freeMarkers.empty())
+    {
+        DWORD objectId = s_freeMarkers.back();
+        s_freeMarkers.pop_back();
+
+        if (!MoveObject(objectId, marker.lat, marker.lon, marker.parked))
+        {
+            LOG_ERROR("Reposition FAILED for object id=%u, removing it.", (unsigned)objectId);
+            Metrics_Count(METRIC_FAILURES);
+            RemoveObjectId(objectId);
+            continue;
+        }
+
+        marker.state = MARKER_LIVE;
+        marker.requestId = 0;
+        marker.objectId = objectId;
+        LOG_DEBUG("Reused object id=%u for POI id=%u at %.5f, %.5f%s",
+            (unsigned)objectId, (unsigned)poiId, marker.lat, marker.lon, marker.parked ? " (parked)" : "");
+        if (!marker.parked)
+            OnMarkerVisible(poiId, MARKER_PATH_REUSE);
+        return true;
+    }
+    return false;
+}
+
+// Parked markers wait for idle frames, others for the next free create slot
+static void QueueCreate(uint32_t poiId, const PoiMarker& marker)
+{
+    Queue_Push(marker.parked ? s_lookaheadQueue : s_spawnQueue, poiId);
+}
+
+// Reuse a pooled object for the POI, or queue a create the frame tick submits
+static void EnqueueMarker(uint32_t poiId, double lat, double lon, bool parked)
+{
+    PoiMarker& marker = AddMarker(poiId);
+    marker.state = MARKER_QUEUED;
+    marker.parked = parked;
+    marker.requestId = 0;
+    marker.objectId = SIMCONNECT_OBJECT_ID_USER;
+    marker.lat = lat;
+    marker.lon = lon;
+    marker.attempts = 0;
+    marker.retry = 0;
+
+    if (!TakeFromPool(poiId, marker))
+        QueueCreate(poiId, marker);
+}
+
+static void OnRetryTimer(void* ctx);
+static void OnCreateTimeout(void* ctx);
+
+// Put the marker in the failed state and schedule a retry while attempts remain
+static void MarkFailed(uint32_t poiId, PoiMarker& marker)
+{
+    marker.state = MARKER_FAILED;
+    marker.retry = 0;
+    if (marker.attempts >= MARKER_SPAWN_MAX_ATTEMPTS)
+    {
+        LOG_WARN("Giving up on marker for POI id=%u after %u attempts",
+            (unsigned)poiId, (unsigned)marker.attempts);
+        return;
+    }
+
+    uint32_t delayMs = MARKER_SPAWN_RETRY_MS * marker.attempts;
+    marker.retry = Scheduler_Schedule(delayMs, OnRetryTimer, (void*)(uintptr_t)poiId);
+    LOG_INFO("Retrying marker for POI id=%u in %u ms", (unsigned)poiId, (unsigned)delayMs);
+}
+
+static bool SubmitMarker(uint32_t poiId, PoiMarker& marker)
+{
+    SIMCONNECT_DATA_INITPOSITION pos = {};
+    pos.Latitude = marker.lat;
+    pos.Longitude = marker.lon;
+    pos.Altitude = 0; // Altitude 0 → use terrain elevation
+    pos.Pitch = 0;
+    pos.Bank = 0;
+    pos.Heading = 0;
+    pos.OnGround = 1; // SimObject spawns on ground level at the specified lat/lon. The "0" altitude value is ignored when OnGround=1, we need to set and altitude.
+
+    // Unique request id per marker so ASSIGNED_OBJECT_ID can be matched to the POI
+    DWORD requestId = g_spawnReqBase + s_nextMarkerRequest++;
+
+    // Attempt to spawn the SimObject named "laser_red" (must exist as a defined SimObject)
+    uint64_t startNs = Metrics_NowNs();
+    HRESULT hr = SimConnect_AICreateSimulatedObject(g_hSimConnect, "laser_red", pos, requestId);
+    Metrics_Record(METRIC_ROUTE_SPAWN, startNs);
+    if (hr != S_OK)
+    {
+        LOG_ERROR("Spawn FAILED for POI id=%u (HRESULT=0x%08X)", (unsigned)poiId, static_cast<unsigned int>(hr));
+        Metrics_Count(METRIC_FAILURES);
+        marker.attempts++;
+        MarkFailed(poiId, marker);
+        return false;
+    }
+
+    PendingCreate pending;
+    pending.requestId = requestId;
+    pending.poiId = poiId;
+    pending.sendId = 0;
+    pending.timeout = Scheduler_Schedule(MARKER_SPAWN_TIMEOUT_MS, OnCreateTimeout, (void*)(uintptr_t)requestId);
+    SimConnect_GetLastSentPacketID(g_hSimConnect, &pending.sendId);
+
+    marker.state = MARKER_CREATING;
+    marker.requestId = requestId;
+    marker.attempts++;
+    AddRequest(pending);
+    Metrics_Count(METRIC_CREATES_ISSUED);
+
+    LOG_DEBUG("Spawn request submitted for 'laser_red' (request=%u, poi=%u) at %.5f, %.5f (terrain)",
+        (unsigned)requestId, (unsigned)poiId, marker.lat, marker.lon);
+    return true;
+}
+
+static void RemoveObjectId(DWORD objectId)
+{
+    uint64_t startNs = Metrics_NowNs();
+    HRESULT hr = SimConnect_AIRemoveObject(g_hSimConnect, objectId, REQUEST_REMOVE_LASERS);
+    Metrics_Record(METRIC_ROUTE_REMOVE, startNs);
+    if (hr != S_OK)
+    {
+        LOG_ERROR(" -> Remove FAILED for id=%u (HRESULT=0x%08X)",
+            (unsigned)objectId, static_cast<unsigned int>(hr));
+        Metrics_Count(METRIC_FAILURES);
+    }
+    else
+        Metrics_Count(METRIC_REMOVES);
+
+    for (size_t i = 0; i < g_lasersIDs.size(); ++i)
+    {
+        if (g_lasersIDs[i] == objectId)
+        {
+            g_lasersIDs[i] = g_lasersIDs.back();
+            g_lasersIDs.pop_back();
+            break;
+        }
+    }
+}
+
+static void RemoveMarker(uint32_t poiId)
+{
+    PoiMarker* marker = FindMarker(poiId);
+    if (!marker)
+        return;
+
+    if (marker->retry)
+        Scheduler_Cancel(marker->retry);
+
+    // A marker still waiting for its object id is removed when the id arrives;
+    // queued or failed markers never reached the sim
+    if (marker->state == MARKER_LIVE)
+    {
+        if (s_freeMarkers.size() < MARKER_POOL_MAX)
+            s_freeMarkers.push_back(marker->objectId); // stays in g_lasersIDs
+        else
+            RemoveObjectId(marker->objectId);
+    }
+
+    EraseMarker(poiId);
+}
+
+// Raises a parked marker into view or parks a shown one, in place
+static void SetParked(uint32_t poiId, PoiMarker& marker, bool parked)
+{
+    marker.parked = parked;
+    if (marker.state == MARKER_QUEUED && !parked)
+    {
+        Queue_Push(s_spawnQueue, poiId); // no longer waits for an idle frame
+        return;
+    }
+    if (marker.state != MARKER_LIVE)
+        return; // applied on assignment (creating) or by the retry (failed)
+
+    if (!MoveObject(marker.objectId, marker.lat, marker.lon, parked))
+    {
+        LOG_ERROR("%s FAILED for object id=%u, recreating it.", parked ? "Parking" : "Unparking", (unsigned)marker.objectId);
+        Metrics_Count(METRIC_FAILURES);
+        double lat = marker.lat;
+        double lon = marker.lon;
+        RemoveMarker(poiId);
+        EnqueueMarker(poiId, lat, lon, parked);
+        return;
+    }
+
+    LOG_DEBUG("%s marker of POI id=%u", parked ? "Parked" : "Raised", (unsigned)poiId);
+    if (!parked)
+        OnMarkerVisible(poiId, MARKER_PATH_LOOKAHEAD);
+}
+
+void SimObjectManager_ReconcilePoi(uint32_t poiId)
+{
+    if (!g_hSimConnect)
+        return;
+
+    int index = PoiStore_IndexOf(poiId);
+    PoiMarker* marker = FindMarker(poiId);
+
+    eMarkerPlacement placement = WantedPlacement(poiId, index);
+    if (placement == PLACEMENT_NONE)
+    {
+        if (marker)
+        {
+            LOG_DEBUG("Reconcile: removing marker for POI id=%u", (unsigned)poiId);
+            RemoveMarker(poiId);
+        }
+        return;
+    }
+
+    double lat = g_poi_coords.lat[index];
+    double lon = g_poi_coords.lon[index];
+    bool parked = placement == PLACEMENT_PARKED;
+
+    if (marker)
+    {
+        // Already in place (or failed there; retries run on their own timer
+        // and start over once the POI moves or markers are re-spawned)
+        if (marker->lat == lat && marker->lon == lon)
+        {
+            if (marker->parked != parked)
+                SetParked(poiId, *marker, parked);
+            return;
+        }
+
+        LOG_DEBUG("Reconcile: moving marker for POI id=%u", (unsigned)poiId);
+        RemoveMarker(poiId);
+    }
+
+    EnqueueMarker(poiId, lat, lon, parked);
+}
+
+void SimObjectManager_SetLookahead(const uint32_t* poiIds, size_t count)
+{
+    if (count == s_lookahead.size() && std::equal(poiIds, poiIds + count, s_lookahead.begin()))
+        return;
+
+    s_lookaheadBefore.swap(s_lookahead);
+    s_lookahead.assign(poiIds, poiIds + count);
+
+    // Departures first: a POI that became active is raised in place, and the
+    // objects of the others can be reused by the arrivals
+    for (size_t i = 0; i < s_lookaheadBefore.size(); ++i)
+        if (!IsLookahead(s_lookaheadBefore[i]))
+            SimObjectManager_ReconcilePoi(s_lookaheadBefore[i]);
+    for (size_t i = 0; i < count; ++i)
+        if (std::find(s_lookaheadBefore.begin(), s_lookaheadBefore.end(), poiIds[i]) == s_lookaheadBefore.end())
+            SimObjectManager_ReconcilePoi(poiIds[i]);
+}
+
+// Recompute the resident set around the aircraft (telemetry cache) and
+// reconcile the POIs that entered or left it. Departures go first so the
+// budget holds.
+static void UpdateResidentSet()
+{
+    AircraftState aircraft;
+    if (!s_showAllMarkers || !s_streamEnabled || !Telemetry_Get(&aircraft))
+        return;
+
+    PoiIndex_Radius(aircraft.latDeg, aircraft.lonDeg, s_streamRadius * MARKER_STREAM_HYSTERESIS, s_streamHits);
+
+    s_nextResident.clear();
+    for (size_t i = 0; i < s_streamHits.size() && s_nextResident.size() < s_streamBudget; ++i)
+    {
+        const PoiHit& hit = s_streamHits[i];
+        if (hit.meters <= s_streamRadius || IsResident(hit.id))
+            s_nextResident.push_back(hit.id);
+    }
+    std::sort(s_nextResident.begin(), s_nextResident.end());
+
+    s_streamEntered.clear();
+    s_streamLeft.clear();
+    std::set_difference(s_resident.begin(), s_resident.end(), s_nextResident.begin(), s_nextResident.end(),
+        std::back_inserter(s_streamLeft));
+    std::set_difference(s_nextResident.begin(), s_nextResident.end(), s_resident.begin(), s_resident.end(),
+        std::back_inserter(s_streamEntered));
+
+    s_resident.swap(s_nextResident);
+    if (s_streamEntered.empty() && s_streamLeft.empty())
+        return;
+
+    for (size_t i = 0; i < s_streamLeft.size(); ++i)
+        SimObjectManager_ReconcilePoi(s_streamLeft[i]);
+    for (size_t i = 0; i < s_streamEntered.size(); ++i)
+        SimObjectManager_ReconcilePoi(s_streamEntered[i]);
+
+    LOG_INFO("Marker streaming: +%zu -%zu (resident=%zu, budget=%u)",
+        s_streamEntered.size(), s_streamLeft.size(), s_resident.size(), (unsigned)s_streamBudget);
+}
+
+void SimObjectManager_OnUserPosition()
+{
+    // Position arrives every frame; the radius query only needs a fresh one now and then
+    uint64_t now = Scheduler_NowMs();
+    if (s_lastStreamUpdateMs != 0 && now - s_lastStreamUpdateMs < MARKER_STREAM_INTERVAL_MS)
+        return;
+    s_lastStreamUpdateMs = now;
+    UpdateResidentSet();
+}
+
+void SimObjectManager_SetStreaming(const MarkerStreamingConfig& config)
+{
+    s_streamEnabled = config.enabled;
+    s_streamRadius = config.radiusMeters > 0.0 ? config.radiusMeters : MARKER_STREAM_RADIUS_METERS;
+    s_streamBudget = config.budget;
+    LOG_INFO("Marker streaming %s (radius=%.0fm, budget=%u)",
+        s_streamEnabled ? "enabled" : "disabled", s_streamRadius, (unsigned)s_streamBudget);
+
+    if (!s_showAllMarkers)
+        return;
+
+    // Switching modes while markers are shown: rebuild the window, then bring
+    // every POI in line (markers outside the new window are removed)
+    s_resident.clear();
+    UpdateResidentSet();
+    for (size_t i = 0; i < g_poi_ids.size(); i++)
+        SimObjectManager_ReconcilePoi(g_poi_ids[i]);
+}
+
+MarkerStreamingConfig SimObjectManager_GetStreaming()
+{
+    MarkerStreamingConfig config;
+    config.enabled = s_streamEnabled;
+    config.radiusMeters = s_streamRadius;
+    config.budget = s_streamBudget;
+    return config;
+}
+
+bool SimObjectManager_OnStreamingMessage(PoiParseResult& msg)
+{
+    MarkerStreamingConfig config = SimObjectManager_GetStreaming();
+    Param_Bool(msg, "enabled", &config.enabled);
+    Param_Double(msg, "radius", &config.radiusMeters);
+    Param_Count(msg, "budget", 0, &config.budget);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    SimObjectManager_SetStreaming(config);
+    OutboundQueue_Sendf("ack: MARKER_STREAMING enabled=%d radius=%.0f budget=%u",
+        s_streamEnabled ? 1 : 0, s_streamRadius, (unsigned)s_streamBudget);
+    return true;
+}
+
+bool SimObjectManager_OnMarkerAssigned(DWORD requestId, DWORD objectId)
+{
+    PendingCreate* req = FindRequest(requestId);
+    if (!req)
+        return false;
+
+    uint32_t poiId = req->poiId;
+    Scheduler_Cancel(req->timeout);
+    EraseRequest(requestId);
+
+    PoiMarker* found = FindMarker(poiId);
+    if (!found || found->requestId != requestId)
+    {
+        // Marker was removed or replaced while the create was in flight
+        LOG_WARN("Marker object id=%u (req=%u) no longer wanted, removing.", (unsigned)objectId, (unsigned)requestId);
+        RemoveObjectId(objectId);
+        return true;
+    }
+
+    PoiMarker& marker = *found;
+    marker.state = MARKER_LIVE;
+    marker.objectId = objectId;
+    g_lasersID = objectId;
+    g_lasersIDs.push_back(objectId);
+    LOG_DEBUG("Marker assigned object id: %u (req=%u, poi=%u) (total=%zu)",
+        (unsigned)objectId, (unsigned)requestId, (unsigned)poiId, g_lasersIDs.size());
+
+    // Lookahead markers are created on the terrain like the others, then parked
+    if (!marker.parked)
+        OnMarkerVisible(poiId, MARKER_PATH_CREATE);
+    else if (!MoveObject(objectId, marker.lat, marker.lon, true))
+    {
+        LOG_ERROR("Parking FAILED for object id=%u, leaving it shown.", (unsigned)objectId);
+        Metrics_Count(METRIC_FAILURES);
+    }
+    return true;
+}
+
+bool SimObjectManager_OnException(DWORD sendId, DWORD exception)
+{
+    if (sendId == 0)
+        return false;
+
+    for (size_t i = 0; i < s_markerRequests.size(); ++i)
+    {
+        const PendingCreate& req = s_markerRequests[i];
+        if (req.sendId != sendId)
+            continue;
+
+        uint32_t poiId = req.poiId;
+        DWORD requestId = req.requestId;
+        Scheduler_Cancel(req.timeout);
+        EraseRequest(requestId);
+
+        LOG_WARN("Spawn request %u for POI id=%u failed (exception %u)",
+            (unsigned)requestId, (unsigned)poiId, (unsigned)exception);
+        Metrics_Count(METRIC_FAILURES);
+
+        PoiMarker* marker = FindMarker(poiId);
+        if (marker && marker->requestId == requestId)
+            MarkFailed(poiId, *marker);
+        return true;
+    }
+    return false;
+}
+
+// Creates that never got an answer stop counting against the in-flight limit
+static void OnCreateTimeout(void* ctx)
+{
+    DWORD requestId = (DWORD)(uintptr_t)ctx;
+    PendingCreate* req = FindRequest(requestId);
+    if (!req)
+        return;
+
+    uint32_t poiId = req->poiId;
+    EraseRequest(requestId);
+    LOG_WARN("Spawn request %u for POI id=%u timed out", (unsigned)requestId, (unsigned)poiId);
+    Metrics_Count(METRIC_FAILURES);
+
+    // A late ASSIGNED_OBJECT_ID for this request is removed by the dispatcher
+    PoiMarker* marker = FindMarker(poiId);
+    if (marker && marker->requestId == requestId)
+        MarkFailed(poiId, *marker);
+}
+
+static void OnRetryTimer(void* ctx)
+{
+    uint32_t poiId = (uint32_t)(uintptr_t)ctx;
+    PoiMarker* marker = FindMarker(poiId);
+    if (!marker || marker->state != MARKER_FAILED)
+        return;
+
+    marker->retry = 0;
+    marker->state = MARKER_QUEUED;
+    if (!TakeFromPool(poiId, *marker))
+        QueueCreate(poiId, *marker);
+}
+
+// Pooled objects go to queued markers first, so they need no create
+static void ClaimPooled(PoiIdQueue& queue)
+{
+    while (!s_freeMarkers.empty() && !Queue_Empty(queue))
+    {
+        uint32_t poiId = Queue_Pop(queue);
+        PoiMarker* marker = FindMarker(poiId);
+        // A failed claim empties the pool; the marker then waits for a create
+        if (marker && marker->state == MARKER_QUEUED && !TakeFromPool(poiId, *marker))
+            QueueCreate(poiId, *marker);
+    }
+}
+
+// Submits up to 'limit' creates from the queue; returns the number submitted
+static uint32_t SubmitQueued(PoiIdQueue& queue, uint32_t limit)
+{
+    uint32_t submitted = 0;
+    while (!Queue_Empty(queue) && submitted < limit && s_markerRequests.size() < s_spawnMaxInFlight)
+    {
+        uint32_t poiId = Queue_Pop(queue);
+
+        // Entries whose marker was removed or already submitted are stale
+        PoiMarker* marker = FindMarker(poiId);
+        if (!marker || marker->state != MARKER_QUEUED)
+            continue;
+
+        SubmitMarker(poiId, *marker);
+        ++submitted;
+    }
+    return submitted;
+}
+
+void SimObjectManager_OnFrame()
+{
+    if (!g_hSimConnect)
+        return;
+
+    // Pooled objects first: queued markers take them without a create
+    ClaimPooled(s_spawnQueue);
+    ClaimPooled(s_lookaheadQueue);
+
+    // Unclaimed pooled objects would stay visible at their old POI
+    for (size_t i = 0; i < s_freeMarkers.size(); ++i)
+        RemoveObjectId(s_freeMarkers[i]);
+    s_freeMarkers.clear();
+
+    uint32_t submitted = SubmitQueued(s_spawnQueue, s_spawnPerFrame);
+
+    // Lookahead creates only use frames the spawn queue leaves idle
+    if (submitted == 0 && Queue_Empty(s_spawnQueue))
+        SubmitQueued(s_lookaheadQueue, MARKER_LOOKAHEAD_PER_FRAME);
+
+    if (submitted && Queue_Empty(s_spawnQueue))
+        LOG_INFO("Spawn queue drained (in flight=%zu, markers=%zu)",
+            s_markerRequests.size(), s_markerSlotById.size());
+}
+
+void SimObjectManager_SetSpawnRate(const SpawnRateConfig& config)
+{
+    s_spawnPerFrame = config.perFrame ? config.perFrame : 1;
+    s_spawnMaxInFlight = config.maxInFlight ? config.maxInFlight : 1;
+    LOG_INFO("Spawn queue: %u creates per frame, %u in flight",
+        (unsigned)s_spawnPerFrame, (unsigned)s_spawnMaxInFlight);
+}
+
+SpawnRateConfig SimObjectManager_GetSpawnRate()
+{
+    SpawnRateConfig config;
+    config.perFrame = s_spawnPerFrame;
+    config.maxInFlight = s_spawnMaxInFlight;
+    return config;
+}
+
+bool SimObjectManager_OnSpawnQueueMessage(PoiParseResult& msg)
+{
+    SpawnRateConfig config = SimObjectManager_GetSpawnRate();
+    Param_Count(msg, "perFrame", 1, &config.perFrame);
+    Param_Count(msg, "maxInFlight", 1, &config.maxInFlight);
+    if (msg.error != POI_PARSE_OK)
+        return false;
+
+    SimObjectManager_SetSpawnRate(config);
+    OutboundQueue_Sendf("ack: SPAWN_QUEUE perFrame=%u maxInFlight=%u",
+        (unsigned)s_spawnPerFrame, (unsigned)s_spawnMaxInFlight);
+    return true;
+}
+
+void SimObjectManager_TrackMarkerLatency(uint32_t poiId)
+{
+    s_latencyArmed = true;
+    s_latencyPoi = poiId;
+    s_latencyStart = std::chrono::steady_clock::now();
+}
+
+eMarkerState SimObjectManager_GetMarkerState(uint32_t poiId)
+{
+    PoiMarker* marker = FindMarker(poiId);
+    return marker ? marker->state : MARKER_NONE;
+}
 
 void RemoveSimObject()
 {
     if (!g_hSimConnect)
         return;
 
+    s_showAllMarkers = false;
+    s_resident.clear();
+    for (size_t i = 0; i < s_markers.size(); ++i)
+        if (s_markers[i].state != MARKER_NONE && s_markers[i].retry)
+            Scheduler_Cancel(s_markers[i].retry);
+    ClearMarkers(); // in-flight creates become orphans and are removed on assignment
+    Queue_Clear(s_spawnQueue);
+    Queue_Clear(s_lookaheadQueue);
+    s_lookahead.clear(); // the flight controller sets it again while a flight runs
+    s_freeMarkers.clear(); // pooled objects are still listed in g_lasersIDs
+    s_latencyArmed = false;
+
     if (g_lasersIDs.empty())
     {
-        fprintf(stderr, "[MSFS] RemoveSimObject: No active 'laser_red' objects to remove.\n");
+        LOG_INFO("RemoveSimObject: No active 'laser_red' objects to remove.");
         return;
     }
 
-    fprintf(stderr, "[MSFS] Removing %zu 'laser_red' objects...\n", g_lasersIDs.size());
+    LOG_INFO("Removing %zu 'laser_red' objects...", g_lasersIDs.size());
 
     // Loop through all stored object IDs
     for (size_t i = 0; i < g_lasersIDs.size(); ++i)
     {
         DWORD objId = g_lasersIDs[i];
+        uint64_t startNs = Metrics_NowNs();
         HRESULT hr = SimConnect_AIRemoveObject(g_hSimConnect, objId, REQUEST_REMOVE_LASERS);
+        Metrics_Record(METRIC_ROUTE_REMOVE, startNs);
 
         if (hr == S_OK)
         {
-            fprintf(stderr, "[MSFS]  -> Remove submitted for id=%u (index=%zu)\n", (unsigned)objId, i);
+            LOG_DEBUG(" -> Remove submitted for id=%u (index=%zu)", (unsigned)objId, i);
+            Metrics_Count(METRIC_REMOVES);
         }
         else
         {
-            fprintf(stderr, "[MSFS]  -> Remove FAILED for id=%u (HRESULT=0x%08X)\n",
+            LOG_ERROR(" -> Remove FAILED for id=%u (HRESULT=0x%08X)",
                 (unsigned)objId, static_cast<unsigned int>(hr));
+            Metrics_Count(METRIC_FAILURES);
         }
     }
 
@@ -41,7 +900,7 @@ void RemoveSimObject()
     g_lasersIDs.clear();
     g_lasersID = SIMCONNECT_OBJECT_ID_USER;
 
-    fprintf(stderr, "[MSFS] All laser_red objects removal requested.\n");
+    LOG_INFO("All laser_red objects removal requested.");
 }
 
 void SpawnSimObject()
@@ -51,121 +910,76 @@ void SpawnSimObject()
 
     if (g_poi_coords.empty())
     {
-        fprintf(stderr, "[MSFS] SpawnSimObject: No POI coordinates loaded in vector.\n");
+        LOG_INFO("SpawnSimObject: No POI coordinates loaded in vector.");
         return;
     }
-    fprintf(stderr, "[MSFS] Spawning 'laser_red' SimObjects for %zu POIs...\n", g_poi_coords.size());
+    s_showAllMarkers = true;
 
-    for (size_t i = 0; i < g_poi_coords.size(); i++) {
-        double lat = g_poi_coords[i].first;
-        double lon = g_poi_coords[i].second;
-
-        SIMCONNECT_DATA_INITPOSITION pos = {};
-        pos.Latitude = lat;
-        pos.Longitude = lon;
-        pos.Altitude = 0; // Altitude 0 → use terrain elevation
-        pos.Pitch = 0;
-        pos.Bank = 0;
-        pos.Heading = 0;
-        pos.OnGround = 1; // SimObject spawns on ground level at the specified lat/lon. The "0" altitude value is ignored when OnGround=1, we need to set and altitude.
-
-
-        // You can assign a dynamic request ID based on the index to differentiate spawns
-        DWORD requestId = REQUEST_ADD_LASERS + static_cast<DWORD>(i);
+    // Streaming: only the POIs around the aircraft get a marker
+    if (s_streamEnabled)
+    {
+        LOG_INFO("Streaming 'laser_red' SimObjects within %.0fm (budget=%u, %zu POIs)...",
+            s_streamRadius, (unsigned)s_streamBudget, g_poi_coords.size());
+        AircraftState aircraft;
+        if (!Telemetry_Get(&aircraft))
+            LOG_INFO("Waiting for the first user position sample.");
+        UpdateResidentSet();
+        return;
+    }
 
+    LOG_INFO("Spawning 'laser_red' SimObjects for %zu POIs...", g_poi_coords.size());
 
-        // Attempt to spawn the SimObject named "laser_red" (must exist as a defined SimObject)
-        HRESULT hr = SimConnect_AICreateSimulatedObject(g_hSimConnect, "laser_red", pos, REQUEST_ADD_LASERS);
-        if (hr == S_OK)
-        {
-            fprintf(stderr, "[MSFS] Spawn request submitted for 'laser_red' (request=%d) at %.5f, %.5f (terrain)\n", REQUEST_ADD_LASERS, lat, lon);
-        }
-        else
-        {
-            fprintf(stderr, "[MSFS] Spawn FAILED (HRESULT=0x%08X)\n", static_cast<unsigned int>(hr));
-        }
-    }
+    // Show-all mode: every POI wants a marker; POIs that already have one are left alone
+    for (size_t i = 0; i < g_poi_ids.size(); i++)
+        SimObjectManager_ReconcilePoi(g_poi_ids[i]);
 }
 
-// A simple POD to request user position via SimConnect data definition
-struct UserPositionData {
-    double latitude;
-    double longitude;
-    double altitude;
-    double plane_heading_degrees_true;
-};
-
 void SpawnCubeNearAircraft()
 {
     if (!g_hSimConnect)
         return;
 
-    // Request a single sample of the user aircraft position heading via SimConnect_RequestDataOnSimObject
-    // First, define the data definition if not already defined elsewhere.
-    // To keep this self-contained, we add the definition here each time (harmless, idempotent in practice for same def id/fields).
-
-    HRESULT hr = S_OK;
-
-    hr = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_USER_POSITION, "PLANE LATITUDE", "degrees");
-    hr = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_USER_POSITION, "PLANE LONGITUDE", "degrees");
-    hr = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_USER_POSITION, "PLANE ALTITUDE", "meters");
-    hr = SimConnect_AddToDataDefinition(g_hSimConnect, DEFINITION_USER_POSITION, "PLANE HEADING DEGREES TRUE", "degrees");
-
-    // Request one-time data sample; the result will come in the dispatch callback as SIMCONNECT_RECV_SIMOBJECT_DATA
-    hr = SimConnect_RequestDataOnSimObject(g_hSimConnect,
-        REQUEST_USER_POS_FOR_CUBE,
-        DEFINITION_USER_POSITION,
-        SIMCONNECT_OBJECT_ID_USER,
-        SIMCONNECT_PERIOD_ONCE,
-        SIMCONNECT_DATA_REQUEST_FLAG_DEFAULT,
-        0, 0, 0);
-
-    if (hr != S_OK)
-    {
-        fprintf(stderr, "[MSFS] SpawnCubeNearAircraft: failed to request user position (0x%08X)\n", (unsigned)hr);
-    }
-    else
+    // The aircraft state is already cached (simconnect/Telemetry.h): the cube
+    // spawns right away instead of after a one-shot position request
+    AircraftState aircraft;
+    if (!Telemetry_Get(&aircraft))
     {
-        fprintf(stderr, "[MSFS] SpawnCubeNearAircraft: requested user position to compute spawn offset.\n");
+        LOG_WARN("SpawnCubeNearAircraft: no user position sample yet.");
+        return;
     }
+
+    SpawnCubeAtOffsetFromUser(aircraft.latDeg, aircraft.lonDeg, aircraft.altMeters, aircraft.headingTrueDeg, 1.0);
 }
 
 void SpawnCubeAtOffsetFromUser(double latDeg, double lonDeg, double altMeters, double headingTrueDeg, double rightMeters)
 {
     if (!g_hSimConnect) return;
 
-    // Heading math
-    const double DegToRad = 3.14159265358979323846 / 180.0;
-    const double earthRadiusMeters = 6378137.0;
-    double hdgRad = headingTrueDeg * DegToRad;
-    double rightRad = hdgRad - (3.14159265358979323846 / 2.0);
-
-    double dNorth = std::sin(rightRad) * rightMeters;
-    double dEast  = std::cos(rightRad) * rightMeters;
-
-    double dLat = (dNorth / earthRadiusMeters) * (180.0 / 3.14159265358979323846);
-    double dLon = (dEast / (earthRadiusMeters * std::cos(latDeg * DegToRad))) * (180.0 / 3.14159265358979323846);
-
-    double spawnLat = latDeg + dLat;
-    double spawnLon = lonDeg + dLon;
+    // Right of the nose: heading + 90 degrees, on the WGS-84 ellipsoid
+    GeoPoint spawn = Geo_Direct(latDeg, lonDeg, headingTrueDeg + 90.0, rightMeters, GEO_EXACT);
 
     SIMCONNECT_DATA_INITPOSITION pos = {};
-    pos.Latitude = spawnLat;
-    pos.Longitude = spawnLon;
+    pos.Latitude = spawn.latDeg;
+    pos.Longitude = spawn.lonDeg;
     pos.Altitude = altMeters;
     pos.Pitch = 0;
     pos.Bank = 0;
     pos.Heading = 0;
     pos.OnGround = 0;
 
+    uint64_t startNs = Metrics_NowNs();
     HRESULT hr = SimConnect_AICreateSimulatedObject(g_hSimConnect, "cube", pos, REQUEST_ADD_CUBE);
+    Metrics_Record(METRIC_ROUTE_SPAWN, startNs);
     if (hr == S_OK)
     {
-        fprintf(stderr, "[MSFS] Spawned 'cube' at %.2fm right of aircraft: lat=%.7f lon=%.7f alt=%.2f\n",
-            rightMeters, spawnLat, spawnLon, altMeters);
+        LOG_INFO("Spawned 'cube' at %.2fm right of aircraft: lat=%.7f lon=%.7f alt=%.2f",
+            rightMeters, spawn.latDeg, spawn.lonDeg, altMeters);
+        Metrics_Count(METRIC_CREATES_ISSUED);
+        EmitterFollow_OnCubeSpawned(rightMeters);
     }
     else
     {
-        fprintf(stderr, "[MSFS] Failed to spawn 'cube' (0x%08X)\n", (unsigned)hr);
+        LOG_ERROR("Failed to spawn 'cube' (0x%08X)", (unsigned)hr);
+        Metrics_Count(METRIC_FAILURES);
     }
 }
\ No newline at end of file
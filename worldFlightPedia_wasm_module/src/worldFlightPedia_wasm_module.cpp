@@ -15,11 +15,17 @@
 #include <SimConnect.h>
 #include "worldFlightPedia_wasm_module.h"
 #include "comm/CommunicationBus.h"
+#include "comm/OutboundQueue.h"
 #include "core/Constants.h"
 #include "simobjects/SimObjectManager.h"
 #include "dispatch/DispatchHandler.h"
+#include "dispatch/DispatchTrace.h"
 #include "simconnect/SimConnectManager.h"
 #include "flight/FlightController.h"
+#include "flight/TourSnapshot.h"
+#include "core/Scheduler.h"
+#include "core/Log.h"
+#include "core/Metrics.h"
 
 // -----------------------------------------------------------------------------
 // MODULE INITIALIZATION
@@ -27,13 +33,17 @@
 // -----------------------------------------------------------------------------
 extern "C" MODULE_EXPORT MSFS_CALLBACK void module_init(void)
 {
+    // Opt-in: record the session from the first SimConnect message on
+    if (TRACE_CAPTURE_AT_INIT)
+        DispatchTrace_StartCapture(TRACE_FILE_PATH);
 
     // ----------------------------------------------------
     // 1) Initialize SimConnect via the Manager
     // ----------------------------------------------------
     if (!SimConnectManager_Initialize())
     {
-        fprintf(stderr, "[MSFS] ERROR: SimConnectManager_Initialize() failed!\n");
+        LOG_ERROR("SimConnectManager_Initialize() failed!");
+        Log_FlushAll();
         return;
     }
 
@@ -46,12 +56,23 @@ extern "C" MODULE_EXPORT MSFS_CALLBACK void module_init(void)
     // 3) Notify JS panel that WASM is ready
     // ----------------------------------------------------
     const char* startup = "WASM ready";
-    fsCommBusCall("OnMessageFromWasm",
-        startup,
-        (unsigned int)std::strlen(startup),
-        FsCommBusBroadcast_JS);
+    OutboundQueue_Send(startup, std::strlen(startup));
 
-    fprintf(stderr, "[MSFS] module_init completed.\n");
+    // ----------------------------------------------------
+    // 4) Restore the tour of the previous session (JS gets TOUR_RESTORED)
+    // ----------------------------------------------------
+    TourSnapshot_Load();
+
+    // ----------------------------------------------------
+    // 5) Start the metrics window (periodic snapshots when configured)
+    // ----------------------------------------------------
+    Metrics_Reset();
+    if (METRICS_PUSH_INTERVAL_MS)
+        Metrics_SetPushInterval(METRICS_PUSH_INTERVAL_MS);
+
+    LOG_INFO("module_init completed.");
+    OutboundQueue_Flush();
+    Log_FlushAll();
 }
 
 // -----------------------------------------------------------------------------
@@ -60,11 +81,21 @@ extern "C" MODULE_EXPORT MSFS_CALLBACK void module_init(void)
 // -----------------------------------------------------------------------------
 extern "C" MODULE_EXPORT MSFS_CALLBACK void module_deinit(void)
 {
+    // Close the trace file (a replay still queues its summary for JS)
+    DispatchTrace_Shutdown();
+
     // Shut down Communication Bus
     CommBus_Shutdown();
 
+    // Write a tour change that is still waiting for its timer
+    TourSnapshot_Flush();
+
+    // Drop pending timers (nothing drives them after SimConnect closes)
+    Scheduler_Clear();
+
     // Shut down SimConnect
     SimConnectManager_Shutdown();
 
-    fprintf(stderr, "[MSFS] module_deinit completed.\n");
+    LOG_INFO("module_deinit completed.");
+    Log_FlushAll();
 }
@@ -1,5 +1,13 @@
 import { useEffect, useRef, useState, useCallback } from "react";
-import { toPayloadString, safeCleanup } from "../../utils/comm/commbusUtils";
+import {
+  toPayloadString,
+  safeCleanup,
+  parseWasmPayload,
+  parseReply,
+} from "../../utils/comm/commbusUtils";
+
+// Longest message text kept in a log line (TOUR_ORDER / METRICS can be long)
+const LOG_MESSAGE_MAX_CHARS = 200;
 
 /**
  * useCommBus - React hook for MSFS CommBus communication with a WASM module
@@ -7,29 +15,39 @@ import { toPayloadString, safeCleanup } from "../../utils/comm/commbusUtils";
  * Responsibilities:
  * - Lazily registers a CommBus listener when the Coherent environment is ready
  * - Sends messages JS → WASM using listener.callWasm(eventName, payload)
- * - Listens for messages WASM → JS via the "OnMessageFromWasm" event
+ * - Listens for messages WASM → JS via the "OnMessageFromWasm" event. One
+ *   call carries every message of a frame, one "#<seq> <message>" record per
+ *   line; records are delivered one by one and their seq is checked for gaps
+ * - Parses the module's compact replies ("ack: TYPE k=v", "nack: TYPE ...");
+ *   the module no longer echoes the received payload back
  * - Keeps a rolling log (max 300 entries) and exposes the last received message
  *
  * Parameters:
  * - autoRegister: whether to auto-attempt registration with retries (default: true)
- * - onMessage: optional callback invoked when a message arrives from WASM
+ * - onMessage: optional callback invoked per message from WASM (message, seq)
+ * - onReply: optional callback invoked per ack/nack ({ok, type, fields, words, seq})
  *
  * Returns:
  * - isReady: boolean — true when CommBus listener is registered
  * - send(eventName, payload): function — sends message to WASM, returns boolean
  * - lastMessage: string|null — last message received from WASM
+ * - lastReply: object|null — last ack/nack, parsed as for onReply
+ * - missed: number — messages lost between records (seq gaps)
  * - logs: string[] — recent log lines (timestamps included)
  *
  * Notes:
  * - This hook is safe to use outside MSFS; it simply won't register until
  *   window.RegisterCommBusListener becomes available.
  */
-export function useCommBus({ autoRegister = true, onMessage } = {}) {
+export function useCommBus({ autoRegister = true, onMessage, onReply } = {}) {
   const listenerRef = useRef(null);
   const startedRef = useRef(false);
+  const lastSeqRef = useRef(null);
 
   const [isReady, setIsReady] = useState(false);
   const [lastMessage, setLastMessage] = useState(null);
+  const [lastReply, setLastReply] = useState(null);
+  const [missed, setMissed] = useState(0);
   const [logs, setLogs] = useState([]);
 
   // Append a timestamped log line (maintain last 300 entries)
@@ -38,6 +56,50 @@ export function useCommBus({ autoRegister = true, onMessage } = {}) {
     setLogs((prev) => [...prev.slice(-299), `[${time}] ${msg}`]);
   }, []);
 
+  /** Checks a record's seq against the previous one (gap = lost messages) */
+  const checkSeq = useCallback(
+    (seq) => {
+      if (seq === null) return;
+      const last = lastSeqRef.current;
+      if (last !== null && seq > last + 1) {
+        const lost = seq - last - 1;
+        setMissed((prev) => prev + lost);
+        addLog(`⚠️ Missed ${lost} WASM message(s) (#${last + 1}..#${seq - 1})`);
+      } else if (last !== null && seq <= last) {
+        addLog(`WASM sequence restarted at #${seq} (module reloaded)`);
+      }
+      lastSeqRef.current = seq;
+    },
+    [addLog]
+  );
+
+  /** Handles one "OnMessageFromWasm" call: every record, in order */
+  const handlePayload = useCallback(
+    (payload) => {
+      const records = parseWasmPayload(payload);
+      for (const { seq, message } of records) {
+        checkSeq(seq);
+
+        const text =
+          message.length > LOG_MESSAGE_MAX_CHARS
+            ? message.slice(0, LOG_MESSAGE_MAX_CHARS) + "…"
+            : message;
+        addLog(`WASM → JS${seq === null ? "" : " #" + seq}: ${text}`);
+
+        const reply = parseReply(message);
+        if (reply) {
+          const parsed = { ...reply, seq };
+          if (!reply.ok) console.warn("[useCommBus] WASM rejected a message:", message);
+          setLastReply(parsed);
+          onReply?.(parsed);
+        }
+        onMessage?.(message, seq);
+      }
+      if (records.length > 0) setLastMessage(records[records.length - 1].message);
+    },
+    [addLog, checkSeq, onMessage, onReply]
+  );
+
   /** Registers the CommBus listener in Coherent environment (idempotent) */
   const registerCommBus = useCallback(() => {
     if (startedRef.current || typeof window === "undefined") return;
@@ -54,11 +116,7 @@ export function useCommBus({ autoRegister = true, onMessage } = {}) {
       });
 
       if (listenerRef.current?.on) {
-        listenerRef.current.on("OnMessageFromWasm", (dataStr) => {
-          addLog("WASM → JS: " + dataStr);
-          setLastMessage(dataStr);
-          onMessage?.(dataStr);
-        });
+        listenerRef.current.on("OnMessageFromWasm", handlePayload);
       } else {
         addLog(
           "CommBusListener.on not found (no incoming messages will be received)."
@@ -70,7 +128,7 @@ export function useCommBus({ autoRegister = true, onMessage } = {}) {
     } catch (err) {
       addLog("❌ Error initializing CommBus: " + err);
     }
-  }, [addLog, onMessage]);
+  }, [addLog, handlePayload]);
 
   /** Effect: auto-register with small retries until Coherent exposes RegisterCommBusListener */
   useEffect(() => {
@@ -118,10 +176,11 @@ export function useCommBus({ autoRegister = true, onMessage } = {}) {
       safeCleanup("CommBus", () => {
         listenerRef.current = null;
         startedRef.current = false;
+        lastSeqRef.current = null;
         setIsReady(false);
       });
     };
   }, []);
 
-  return { isReady, send, lastMessage, logs };
+  return { isReady, send, lastMessage, lastReply, missed, logs };
 }
@@ -16,7 +16,8 @@
  * @param {{lat?:number, lon?:number}} params.userCoords - Fallback user coordinates if plane marker not placed yet
  * @param {Array<any>} params.pois - Raw POIs
  * @param {Object} params.palette - Theme palette (optional accent color)
- * @param {number} [params.arrivalThresholdKm=0.2] - Distance threshold to consider POI reached
+ * @param {number} [params.arrivalThresholdKm=0.2] - Distance threshold to consider POI reached (UI only; the
+ *   WASM module advances the flight at its GEOFENCE arrivalRadius, also 200 m)
  * @param {function} [params.onArrive] - Optional callback when a POI is reached (receives POI)
  * @param {import('react').MutableRefObject<boolean>} [params.pauseRef] - Ref to track pause state (syncs with UI button)
  * @param {import('react').MutableRefObject<function>} [params.updatePauseButtonRef] - Ref to function that updates pause button UI
@@ -334,17 +335,9 @@ export function useRoutePlanning({
         const planePos = marker.getLatLng();
         const targetPos = [target.lat, target.lon];
 
-        // Pulse custom L:Var for arrival (wrapped in try for robustness)
-        try {
-          SimVar.SetSimVarValue("L:WFP_NextPoi", "Bool", 1);
-          setTimeout(() => {
-            try {
-              SimVar.SetSimVarValue("L:WFP_NextPoi", "Bool", 0);
-            } catch (_) {}
-          }, 1000);
-        } catch (e) {
-          console.warn("[useRoutePlanning] Error setting L:WFP_NextPoi", e);
-        }
+        // No L:WFP_NextPoi pulse here: the WASM module's geofence advances the
+        // flight itself at the same 200 m (POI_ARRIVED), and a second advance
+        // would skip the next POI
 
         // Auto-pause MSFS only if Start Flight is active; sync UI button
         try {
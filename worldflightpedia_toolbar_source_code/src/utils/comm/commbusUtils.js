@@ -42,3 +42,53 @@ export function safeCleanup(name, callback) {
     console.warn(`[${name}] Error during cleanup:`, err);
   }
 }
+
+/**
+ * parseWasmPayload - Splits an "OnMessageFromWasm" payload into its records
+ *
+ * The module coalesces the messages of a frame into one call, one record per
+ * line: "#<seq> <message>". seq counts every message since the module was
+ * loaded. A line without the "#<seq> " prefix is returned with seq null.
+ *
+ * @param {string} payload - Raw payload from the CommBus event
+ * @returns {Array<{seq:number|null, message:string}>} Records in send order
+ */
+export function parseWasmPayload(payload) {
+  if (typeof payload !== "string" || payload === "") return [];
+
+  const records = [];
+  for (const line of payload.split("\n")) {
+    if (line === "") continue;
+    const space = line.indexOf(" ");
+    const seq = line[0] === "#" && space > 1 ? Number(line.slice(1, space)) : NaN;
+    if (Number.isInteger(seq)) {
+      records.push({ seq, message: line.slice(space + 1) });
+    } else {
+      records.push({ seq: null, message: line });
+    }
+  }
+  return records;
+}
+
+/**
+ * parseReply - Parses a compact reply record ("ack: TYPE k=v ..." / "nack: ...")
+ *
+ * @param {string} message - One record's message
+ * @returns {{ok:boolean, type:string, fields:Object<string,string>, words:string[]}|null}
+ *   null when the message is not a reply. fields holds the k=v pairs, words
+ *   the remaining tokens (e.g. a nack's reason).
+ */
+export function parseReply(message) {
+  const ok = message.startsWith("ack: ");
+  if (!ok && !message.startsWith("nack: ")) return null;
+
+  const [type = "", ...rest] = message.slice(ok ? 5 : 6).split(" ");
+  const fields = {};
+  const words = [];
+  for (const token of rest) {
+    const eq = token.indexOf("=");
+    if (eq > 0) fields[token.slice(0, eq)] = token.slice(eq + 1);
+    else if (token !== "") words.push(token);
+  }
+  return { ok, type, fields, words };
+}
@@ -1,3 +1,6 @@
+/** Earth's mean radius in kilometers (GEO_MEAN_RADIUS_METERS in the WASM module) */
+export const EARTH_MEAN_RADIUS_KM = 6371.0088;
+
 /**
  * haversine - Calculate great-circle distance between two geographic points
  *
@@ -5,7 +8,13 @@
  * surface between two points, accounting for spherical geometry.
  *
  * Formula: d = 2R × arcsin(√[sin²(Δφ/2) + cos(φ1) × cos(φ2) × sin²(Δλ/2)])
- * where R = Earth's radius, φ = latitude, λ = longitude
+ * where R = Earth's mean radius, φ = latitude, λ = longitude
+ *
+ * The sphere is the one the WASM module's GEO_FAST mode uses (geo/Geodesy.h),
+ * so panel distances match the module's POI and arrival distances. It stays
+ * spherical on purpose: its up to ~0.5% error does not matter for distance
+ * labels, ordering, dedup or the arrival radius; the module's GEO_EXACT
+ * (WGS-84) mode is used where a result must be exact.
  *
  * @param {number} lat1 - Starting latitude in decimal degrees
  * @param {number} lon1 - Starting longitude in decimal degrees
@@ -19,8 +28,7 @@
  * // Returns: ~5570 km
  */
 export function haversine(lat1, lon1, lat2, lon2) {
-  // Earth's radius in kilometers
-  const R = 6371;
+  const R = EARTH_MEAN_RADIUS_KM;
 
   // Convert latitude difference to radians
   const dLat = ((lat2 - lat1) * Math.PI) / 180;
@@ -36,6 +44,7 @@ export function haversine(lat1, lon1, lat2, lon2) {
       Math.cos((lat2 * Math.PI) / 180) *
       Math.sin(dLon / 2) ** 2;
 
-  // Final calculation: d = 2R × arcsin(√a)
-  return 2 * R * Math.asin(Math.sqrt(a));
+  // Final calculation: d = 2R × arcsin(√a); rounding can push a past 1 for
+  // nearly antipodal points
+  return 2 * R * Math.asin(Math.sqrt(Math.min(1, a)));
 }